@@ -202,6 +202,24 @@ static const wxChar V3DRT_BevelHeight_um[] = wxT( "V3DRT_BevelHeight_um" );
 static const wxChar V3DRT_BevelExtentFactor[] = wxT( "V3DRT_BevelExtentFactor" );
 
 static const wxChar UseClipper2[] = wxT( "UseClipper2" );
+
+/**
+ * Render cached layers of the Cairo canvas in parallel tiles.
+ */
+static const wxChar CairoTiledRendering[] = wxT( "CairoTiledRendering" );
+
+/**
+ * Level of detail thresholds, in pixels.  Smaller pads and vias are drawn as boxes and smaller
+ * text as bars.  Set to 0 to always draw full detail.
+ */
+static const wxChar LODItemMinPixels[] = wxT( "LODItemMinPixels" );
+static const wxChar LODTextMinPixels[] = wxT( "LODTextMinPixels" );
+
+/**
+ * File to write a Chrome trace-event JSON profile of application startup to.  Empty disables
+ * the startup tracer.  The KICAD_STARTUP_TRACE environment variable takes precedence.
+ */
+static const wxChar StartupTracePath[] = wxT( "StartupTracePath" );
 } // namespace KEYS
 
 
@@ -331,6 +349,12 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_UseClipper2               = true;
 
+    m_CairoTiledRendering       = true;
+
+    // Disabled until measured
+    m_LODItemMinPixels          = 0.0;
+    m_LODTextMinPixels          = 0.0;
+
 #ifdef _WIN32
     // spacemouse is largely stable on Windows
     m_Use3DConnexionDriver = true;
@@ -340,6 +364,8 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_IncrementalConnectivity   = false;
 
+    m_StartupTracePath          = wxEmptyString;
+
     loadFromConfigFile();
 }
 
@@ -482,12 +508,24 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::UseClipper2,
                                                 &m_UseClipper2, m_UseClipper2 ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CairoTiledRendering,
+                                                &m_CairoTiledRendering, m_CairoTiledRendering ) );
+
+    configParams.push_back( new PARAM_CFG_DOUBLE( true, AC_KEYS::LODItemMinPixels,
+                                                  &m_LODItemMinPixels, m_LODItemMinPixels, 0.0, 100.0 ) );
+
+    configParams.push_back( new PARAM_CFG_DOUBLE( true, AC_KEYS::LODTextMinPixels,
+                                                  &m_LODTextMinPixels, m_LODTextMinPixels, 0.0, 100.0 ) );
+
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::Use3DConnexionDriver,
                                                 &m_Use3DConnexionDriver, m_Use3DConnexionDriver ) );
 
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalConnectivity,
                                                 &m_IncrementalConnectivity, m_IncrementalConnectivity ) );
 
+    configParams.push_back( new PARAM_CFG_WXSTRING( true, AC_KEYS::StartupTracePath,
+                                                    &m_StartupTracePath, wxS( "" ) ) );
+
 
 
     // Special case for trace mask setting...we just grab them and set them immediately
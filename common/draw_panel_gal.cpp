@@ -337,6 +337,10 @@ void EDA_DRAW_PANEL_GAL::DoRePaint()
     }
 
     m_lastRefresh = wxGetLocalTimeMillis();
+
+    // Items drawn at a stale level of detail were queued for recaching during the redraw
+    if( isDirty && m_view->IsTargetDirty( KIGFX::TARGET_CACHED ) )
+        Refresh();
 }
 
 
@@ -31,6 +31,7 @@
 #include <font/outline_font.h>
 #include <trigo.h>
 #include <markup_parser.h>
+#include <startup_trace.h>
 
 // The "official" name of the building Kicad stroke font (always existing)
 #include <font/kicad_font_name.h>
@@ -57,7 +58,10 @@ FONT::FONT()
 FONT* FONT::getDefaultFont()
 {
     if( !s_defaultFont )
+    {
+        SCOPED_STARTUP_TRACE( "STROKE_FONT::LoadFont", "fonts" );
         s_defaultFont = STROKE_FONT::LoadFont( wxEmptyString );
+    }
 
     return s_defaultFont;
 }
@@ -73,7 +77,10 @@ FONT* FONT::GetFont( const wxString& aFontName, bool aBold, bool aItalic )
     FONT* font = s_fontMap[key];
 
     if( !font )
+    {
+        SCOPED_STARTUP_TRACE( "OUTLINE_FONT::LoadFont " + aFontName.ToStdString(), "fonts" );
         font = OUTLINE_FONT::LoadFont( aFontName, aBold, aItalic );
+    }
 
     if( !font )
         font = getDefaultFont();
@@ -170,22 +177,39 @@ void FONT::Draw( KIGFX::GAL* aGal, const wxString& aText, const VECTOR2I& aPosit
     if( !aGal || aText.empty() )
         return;
 
-    VECTOR2I  position( aPosition - aCursor );
+    VECTOR2I position( aPosition - aCursor );
+
+    // Lay out all the lines first so that the GAL receives the whole string as a single batch
+    std::vector<std::unique_ptr<GLYPH>> glyphs;
+
+    getLinesAsGlyphs( &glyphs, aText, position, aPosition, aAttrs );
+
+    aGal->SetLineWidth( aAttrs.m_StrokeWidth );
+    aGal->DrawGlyphs( glyphs );
+}
+
 
-    // Split multiline strings into separate ones and draw them line by line
+void FONT::getLinesAsGlyphs( std::vector<std::unique_ptr<GLYPH>>* aGlyphs, const wxString& aText,
+                             const VECTOR2I& aPosition, const VECTOR2I& aOrigin,
+                             const TEXT_ATTRIBUTES& aAttrs ) const
+{
     wxArrayString         strings_list;
     std::vector<VECTOR2I> positions;
     std::vector<VECTOR2I> extents;
+    TEXT_STYLE_FLAGS      textStyle = 0;
 
-    getLinePositions( aText, position, strings_list, positions, extents, aAttrs );
+    if( aAttrs.m_Italic )
+        textStyle |= TEXT_STYLE::ITALIC;
 
-    aGal->SetLineWidth( aAttrs.m_StrokeWidth );
+    if( aAttrs.m_Underlined )
+        textStyle |= TEXT_STYLE::UNDERLINE;
+
+    getLinePositions( aText, aPosition, strings_list, positions, extents, aAttrs );
 
     for( size_t i = 0; i < strings_list.GetCount(); i++ )
     {
-        drawSingleLineText( aGal, nullptr, strings_list[i], positions[i], aAttrs.m_Size,
-                            aAttrs.m_Angle, aAttrs.m_Mirrored, aPosition, aAttrs.m_Italic,
-                            aAttrs.m_Underlined );
+        (void) drawMarkup( nullptr, aGlyphs, strings_list[i], positions[i], aAttrs.m_Size,
+                           aAttrs.m_Angle, aAttrs.m_Mirrored, aOrigin, textStyle );
     }
 }
 
@@ -302,32 +326,6 @@ VECTOR2I FONT::drawMarkup( BOX2I* aBoundingBox, std::vector<std::unique_ptr<GLYP
 }
 
 
-void FONT::drawSingleLineText( KIGFX::GAL* aGal, BOX2I* aBoundingBox, const wxString& aText,
-                               const VECTOR2I& aPosition, const VECTOR2I& aSize,
-                               const EDA_ANGLE& aAngle, bool aMirror, const VECTOR2I& aOrigin,
-                               bool aItalic, bool aUnderline ) const
-{
-    if( !aGal )
-        return;
-
-    TEXT_STYLE_FLAGS textStyle = 0;
-
-
-    if( aItalic )
-        textStyle |= TEXT_STYLE::ITALIC;
-
-    if( aUnderline )
-        textStyle |= TEXT_STYLE::UNDERLINE;
-
-    std::vector<std::unique_ptr<GLYPH>> glyphs;
-
-    (void) drawMarkup( aBoundingBox, &glyphs, aText, aPosition, aSize, aAngle, aMirror, aOrigin,
-                       textStyle );
-
-    aGal->DrawGlyphs( glyphs );
-}
-
-
 VECTOR2I FONT::StringBoundaryLimits( const wxString& aText, const VECTOR2I& aSize, int aThickness,
                                      bool aBold, bool aItalic ) const
 {
@@ -24,6 +24,7 @@
 #include <trace_helpers.h>
 #include <string_utils.h>
 #include <macros.h>
+#include <startup_trace.h>
 #include <font/fontconfig.h>
 
 using namespace fontconfig;
@@ -54,6 +55,7 @@ FONTCONFIG* Fontconfig()
 {
     if( !g_config )
     {
+        SCOPED_STARTUP_TRACE( "FcInit", "fonts" );
         FcInit();
         g_config = new FONTCONFIG();
     }
@@ -45,6 +45,7 @@ using namespace KIFONT;
 
 FT_Library OUTLINE_FONT::m_freeType = nullptr;
 std::mutex OUTLINE_FONT::m_freeTypeMutex;
+std::map<OUTLINE_FONT::GLYPH_CACHE_KEY, std::unique_ptr<OUTLINE_GLYPH>> OUTLINE_FONT::s_glyphCache;
 
 OUTLINE_FONT::OUTLINE_FONT() :
         m_face(NULL),
@@ -325,6 +326,88 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphs( BOX2I* aBBox, std::vector<std::unique_pt
                                     aOrigin, aTextStyle );
 }
 
+
+const OUTLINE_GLYPH& OUTLINE_FONT::getNormalizedGlyph( unsigned int aGlyphIndex,
+                                                      bool aScript ) const
+{
+    std::unique_ptr<OUTLINE_GLYPH>& entry = s_glyphCache[ { this, aGlyphIndex, aScript } ];
+
+    if( entry )
+        return *entry;
+
+    FT_Face face = m_face;
+
+    if( m_fakeItal )
+    {
+        FT_Matrix matrix;
+        // Create a 12 degree slant
+        const float angle = (float)( -M_PI * 12.0f ) / 180.0f;
+        matrix.xx = (FT_Fixed) ( cos( angle ) * 0x10000L );
+        matrix.xy = (FT_Fixed) ( -sin( angle ) * 0x10000L );
+        matrix.yx = (FT_Fixed) ( 0 * 0x10000L );  // Don't rotate in the y direction
+        matrix.yy = (FT_Fixed) ( 1 * 0x10000L );
+
+        FT_Set_Transform( face, &matrix, 0 );
+    }
+
+    FT_Load_Glyph( face, aGlyphIndex, FT_LOAD_NO_BITMAP );
+
+    if( m_fakeBold )
+        FT_Outline_Embolden( &face->glyph->outline, 1 << 6 );
+
+    // contours is a collection of all outlines in the glyph; for example the 'o' glyph
+    // generally contains 2 contours, one for the glyph outline and one for the hole
+    CONTOURS contours;
+
+    OUTLINE_DECOMPOSER decomposer( face->glyph->outline );
+    decomposer.OutlineToSegments( &contours );
+
+    std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>();
+    std::vector<SHAPE_LINE_CHAIN>  holes;
+
+    for( CONTOUR& c : contours )
+    {
+        SHAPE_LINE_CHAIN shape;
+
+        shape.ReservePoints( c.m_Points.size() );
+
+        for( const VECTOR2D& v : c.m_Points )
+        {
+            shape.Append( KiROUND( v.x * m_glyphCacheScaler ),
+                          KiROUND( v.y * m_glyphCacheScaler ) );
+        }
+
+        shape.SetClosed( true );
+
+        if( contourIsHole( c ) )
+            holes.push_back( std::move( shape ) );
+        else
+            glyph->AddOutline( std::move( shape ) );
+    }
+
+    for( SHAPE_LINE_CHAIN& hole : holes )
+    {
+        if( hole.PointCount() )
+        {
+            for( int ii = 0; ii < glyph->OutlineCount(); ++ii )
+            {
+                if( glyph->Outline( ii ).PointInside( hole.GetPoint( 0 ) ) )
+                {
+                    glyph->AddHole( std::move( hole ), ii );
+                    break;
+                }
+            }
+        }
+    }
+
+    // Glyphs that fail to triangulate here are left for the GAL to handle as before
+    glyph->CacheTriangulation( false );
+
+    entry = std::move( glyph );
+    return *entry;
+}
+
+
 VECTOR2I OUTLINE_FONT::getTextAsGlyphsUnlocked( BOX2I* aBBox,
                                                 std::vector<std::unique_ptr<GLYPH>>* aGlyphs,
                                                 const wxString& aText, const VECTOR2I& aSize,
@@ -361,6 +444,13 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphsUnlocked( BOX2I* aBBox,
     scaleFactor = scaleFactor * m_outlineFontSizeCompensation;
 
     VECTOR2I cursor( 0, 0 );
+    bool     isScript = IsSubscript( aTextStyle ) || IsSuperscript( aTextStyle );
+    double   verticalOffset = 0.0;
+
+    if( IsSubscript( aTextStyle ) )
+        verticalOffset = m_subscriptVerticalOffset * scaler;
+    else if( IsSuperscript( aTextStyle ) )
+        verticalOffset = m_superscriptVerticalOffset * scaler;
 
     if( aGlyphs )
         aGlyphs->reserve( glyphCount );
@@ -373,84 +463,29 @@ VECTOR2I OUTLINE_FONT::getTextAsGlyphsUnlocked( BOX2I* aBBox,
 
         if( aGlyphs )
         {
-            if( m_fakeItal )
-            {
-                FT_Matrix matrix;
-                // Create a 12 degree slant
-                const float angle = (float)( -M_PI * 12.0f ) / 180.0f;
-                matrix.xx = (FT_Fixed) ( cos( angle ) * 0x10000L );
-                matrix.xy = (FT_Fixed) ( -sin( angle ) * 0x10000L );
-                matrix.yx = (FT_Fixed) ( 0 * 0x10000L );  // Don't rotate in the y direction
-                matrix.yy = (FT_Fixed) ( 1 * 0x10000L );
-
-                FT_Set_Transform( face, &matrix, 0 );
-            }
-
-            FT_Load_Glyph( face, glyphInfo[i].codepoint, FT_LOAD_NO_BITMAP );
-
-            if( m_fakeBold )
-                FT_Outline_Embolden( &face->glyph->outline, 1 << 6 );
-
-            // contours is a collection of all outlines in the glyph; for example the 'o' glyph
-            // generally contains 2 contours, one for the glyph outline and one for the hole
-            CONTOURS contours;
+            const OUTLINE_GLYPH& cached = getNormalizedGlyph( glyphInfo[i].codepoint, isScript );
 
-            OUTLINE_DECOMPOSER decomposer( face->glyph->outline );
-            decomposer.OutlineToSegments( &contours );
-
-            std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>();
-            std::vector<SHAPE_LINE_CHAIN>  holes;
-
-            for( CONTOUR& c : contours )
-            {
-                GLYPH_POINTS     points = c.m_Points;
-                SHAPE_LINE_CHAIN shape;
+            // Instance the shared glyph: the outlines and the triangulation are mapped through
+            // the same affine transform, so neither needs recomputing
+            std::unique_ptr<OUTLINE_GLYPH> glyph = std::make_unique<OUTLINE_GLYPH>( cached );
 
-                shape.ReservePoints( points.size() );
-
-                for( const VECTOR2D& v : points )
-                {
-                    VECTOR2D pt( v + cursor );
-
-                    if( IsSubscript( aTextStyle ) )
-                        pt.y += m_subscriptVerticalOffset * scaler;
-                    else if( IsSuperscript( aTextStyle ) )
-                        pt.y += m_superscriptVerticalOffset * scaler;
-
-                    pt *= scaleFactor;
-                    pt += aPosition;
-
-                    if( aMirror )
-                        pt.x = aOrigin.x - ( pt.x - aOrigin.x );
-
-                    if( !aAngle.IsZero() )
-                        RotatePoint( pt, aOrigin, aAngle );
+            glyph->TransformPoints(
+                    [&]( const VECTOR2I& aPt ) -> VECTOR2I
+                    {
+                        VECTOR2D pt( VECTOR2D( aPt ) / m_glyphCacheScaler + cursor );
 
-                    shape.Append( pt.x, pt.y );
-                }
+                        pt.y += verticalOffset;
+                        pt *= scaleFactor;
+                        pt += aPosition;
 
-                shape.SetClosed( true );
+                        if( aMirror )
+                            pt.x = aOrigin.x - ( pt.x - aOrigin.x );
 
-                if( contourIsHole( c ) )
-                    holes.push_back( std::move( shape ) );
-                else
-                    glyph->AddOutline( std::move( shape ) );
-            }
+                        if( !aAngle.IsZero() )
+                            RotatePoint( pt, aOrigin, aAngle );
 
-            for( SHAPE_LINE_CHAIN& hole : holes )
-            {
-                if( hole.PointCount() )
-                {
-                    for( int ii = 0; ii < glyph->OutlineCount(); ++ii )
-                    {
-                        if( glyph->Outline( ii ).PointInside( hole.GetPoint( 0 ) ) )
-                        {
-                            glyph->AddHole( std::move( hole ), ii );
-                            break;
-                        }
-                    }
-                }
-            }
+                        return VECTOR2I( KiROUND( pt.x ), KiROUND( pt.y ) );
+                    } );
 
             aGlyphs->push_back( std::move( glyph ) );
         }
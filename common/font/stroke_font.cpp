@@ -38,6 +38,7 @@
 // The "official" name of the building Kicad stroke font (always existing)
 #include <font/kicad_font_name.h>
 
+#include <atomic>
 #include <mutex>
 
 using namespace KIFONT;
@@ -56,16 +57,33 @@ static constexpr double STROKE_FONT_SCALE = 1.0 / 21.0;
 static constexpr int FONT_OFFSET = -8;
 
 
-bool                                g_defaultFontInitialized = false;
-std::vector<std::shared_ptr<GLYPH>> g_defaultFontGlyphs;
-std::vector<BOX2D>*                 g_defaultFontGlyphBoundingBoxes;
-std::mutex                          g_defaultFontLoadMutex;
+/**
+ * Decoded glyphs of the built-in font, shared by every STROKE_FONT instance.
+ *
+ * The newstroke tables are compiled into the binary as read-only strings, so loading the font
+ * only allocates this (zeroed) pointer table; each glyph is decoded the first time it is drawn.
+ */
+struct STROKE_GLYPH_TABLE
+{
+    ~STROKE_GLYPH_TABLE()
+    {
+        for( int ii = 0; ii < m_count; ++ii )
+            delete m_glyphs[ii].load();
+    }
+
+    std::unique_ptr<std::atomic<STROKE_GLYPH*>[]> m_glyphs;
+    int                                            m_count = 0;
+};
+
+
+STROKE_GLYPH_TABLE g_defaultFontGlyphs;
+std::mutex         g_defaultFontLoadMutex;
 
 
 STROKE_FONT::STROKE_FONT() :
-        m_glyphs( nullptr ),
-        m_glyphBoundingBoxes( nullptr ),
-        m_maxGlyphWidth( 0.0 )
+        m_fontData( nullptr ),
+        m_fontDataSize( 0 ),
+        m_glyphs( nullptr )
 {
 }
 
@@ -86,7 +104,7 @@ STROKE_FONT* STROKE_FONT::LoadFont( const wxString& aFontName )
 }
 
 
-void buildGlyphBoundingBox( std::shared_ptr<STROKE_GLYPH>& aGlyph, double aGlyphWidth )
+static void buildGlyphBoundingBox( STROKE_GLYPH* aGlyph, double aGlyphWidth )
 {
     VECTOR2D min( 0, 0 );
     VECTOR2D max( aGlyphWidth, 0 );
@@ -104,101 +122,121 @@ void buildGlyphBoundingBox( std::shared_ptr<STROKE_GLYPH>& aGlyph, double aGlyph
 }
 
 
-void STROKE_FONT::loadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
+/**
+ * Decode a single glyph from its newstroke string.
+ */
+static STROKE_GLYPH* decodeNewStrokeGlyph( const char* aGlyphData )
 {
-    // Protect the initialization sequence against multiple entries
-    std::lock_guard<std::mutex> lock( g_defaultFontLoadMutex );
+    STROKE_GLYPH* glyph = new STROKE_GLYPH();
+
+    double glyphStartX = 0.0;
+    double glyphEndX = 0.0;
+    double glyphWidth = 0.0;
+    int    strokes = 0;
+    int    i = 0;
 
-    if( !g_defaultFontInitialized )
+    while( aGlyphData[i] )
     {
-        g_defaultFontGlyphs.reserve( aNewStrokeFontSize );
+        if( aGlyphData[i] == ' ' && aGlyphData[i+1] == 'R' )
+            strokes++;
 
-        g_defaultFontGlyphBoundingBoxes = new std::vector<BOX2D>;
-        g_defaultFontGlyphBoundingBoxes->reserve( aNewStrokeFontSize );
+        i += 2;
+    }
 
-        for( int j = 0; j < aNewStrokeFontSize; j++ )
-        {
-            std::shared_ptr<STROKE_GLYPH> glyph = std::make_shared<STROKE_GLYPH>();
+    glyph->reserve( strokes + 1 );
 
-            double glyphStartX = 0.0;
-            double glyphEndX = 0.0;
-            double glyphWidth = 0.0;
-            int    strokes = 0;
-            int    i = 0;
+    i = 0;
 
-            while( aNewStrokeFont[j][i] )
-            {
-                if( aNewStrokeFont[j][i] == ' ' && aNewStrokeFont[j][i+1] == 'R' )
-                    strokes++;
+    while( aGlyphData[i] )
+    {
+        VECTOR2D point( 0.0, 0.0 );
+        char     coordinate[2] = { 0, };
 
-                i += 2;
-            }
+        for( int k : { 0, 1 } )
+            coordinate[k] = aGlyphData[i + k];
 
-            glyph->reserve( strokes + 1 );
+        if( i < 2 )
+        {
+            // The first two values contain the width of the char
+            glyphStartX = ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE;
+            glyphEndX   = ( coordinate[1] - 'R' ) * STROKE_FONT_SCALE;
+            glyphWidth  = glyphEndX - glyphStartX;
+        }
+        else if( ( coordinate[0] == ' ' ) && ( coordinate[1] == 'R' ) )
+        {
+            glyph->RaisePen();
+        }
+        else
+        {
+            // In stroke font, coordinates values are coded as <value> + 'R', where
+            // <value> is an ASCII char.
+            // therefore every coordinate description of the Hershey format has an offset,
+            // it has to be subtracted
+            // Note:
+            //  * the stroke coordinates are stored in reduced form (-1.0 to +1.0),
+            //    and the actual size is stroke coordinate * glyph size
+            //  * a few shapes have a height slightly bigger than 1.0 ( like '{' '[' )
+            point.x = (double) ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE - glyphStartX;
+
+            // FONT_OFFSET is here for historical reasons, due to the way the stroke font
+            // was built. It allows shapes coordinates like W M ... to be >= 0
+            // Only shapes like j y have coordinates < 0
+            point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET ) * STROKE_FONT_SCALE;
+
+            glyph->AddPoint( point );
+        }
 
-            i = 0;
+        i += 2;
+    }
 
-            while( aNewStrokeFont[j][i] )
-            {
-                VECTOR2D point( 0.0, 0.0 );
-                char     coordinate[2] = { 0, };
-
-                for( int k : { 0, 1 } )
-                    coordinate[k] = aNewStrokeFont[j][i + k];
-
-                if( i < 2 )
-                {
-                    // The first two values contain the width of the char
-                    glyphStartX = ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE;
-                    glyphEndX   = ( coordinate[1] - 'R' ) * STROKE_FONT_SCALE;
-                    glyphWidth  = glyphEndX - glyphStartX;
-                }
-                else if( ( coordinate[0] == ' ' ) && ( coordinate[1] == 'R' ) )
-                {
-                    glyph->RaisePen();
-                }
-                else
-                {
-                    // In stroke font, coordinates values are coded as <value> + 'R', where
-                    // <value> is an ASCII char.
-                    // therefore every coordinate description of the Hershey format has an offset,
-                    // it has to be subtracted
-                    // Note:
-                    //  * the stroke coordinates are stored in reduced form (-1.0 to +1.0),
-                    //    and the actual size is stroke coordinate * glyph size
-                    //  * a few shapes have a height slightly bigger than 1.0 ( like '{' '[' )
-                    point.x = (double) ( coordinate[0] - 'R' ) * STROKE_FONT_SCALE - glyphStartX;
-
-                    // FONT_OFFSET is here for historical reasons, due to the way the stroke font
-                    // was built. It allows shapes coordinates like W M ... to be >= 0
-                    // Only shapes like j y have coordinates < 0
-                    point.y = (double) ( coordinate[1] - 'R' + FONT_OFFSET ) * STROKE_FONT_SCALE;
-
-                    glyph->AddPoint( point );
-                }
-
-                i += 2;
-            }
+    glyph->Finalize();
 
-            glyph->Finalize();
+    // Compute the bounding box of the glyph
+    buildGlyphBoundingBox( glyph, glyphWidth );
 
-            // Compute the bounding box of the glyph
-            buildGlyphBoundingBox( glyph, glyphWidth );
-            g_defaultFontGlyphBoundingBoxes->emplace_back( glyph->BoundingBox() );
-            g_defaultFontGlyphs.push_back( glyph );
-            m_maxGlyphWidth = std::max( m_maxGlyphWidth, glyphWidth );
-        }
+    return glyph;
+}
+
+
+void STROKE_FONT::loadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
+{
+    // Protect the initialization sequence against multiple entries
+    std::lock_guard<std::mutex> lock( g_defaultFontLoadMutex );
 
-        g_defaultFontInitialized = true;
+    if( !g_defaultFontGlyphs.m_glyphs )
+    {
+        // Value-initialized, so every glyph starts out as not yet decoded
+        g_defaultFontGlyphs.m_glyphs.reset( new std::atomic<STROKE_GLYPH*>[aNewStrokeFontSize]() );
+        g_defaultFontGlyphs.m_count = aNewStrokeFontSize;
     }
 
-    m_glyphs = &g_defaultFontGlyphs;
-    m_glyphBoundingBoxes = g_defaultFontGlyphBoundingBoxes;
+    m_fontData = aNewStrokeFont;
+    m_fontDataSize = aNewStrokeFontSize;
+    m_glyphs = g_defaultFontGlyphs.m_glyphs.get();
     m_fontName = KICAD_FONT_NAME;
     m_fontFileName = wxEmptyString;
 }
 
 
+STROKE_GLYPH* STROKE_FONT::getGlyph( int aIndex ) const
+{
+    STROKE_GLYPH* glyph = m_glyphs[aIndex].load( std::memory_order_acquire );
+
+    if( glyph )
+        return glyph;
+
+    // Text is laid out from several threads at once; if another one decoded the same glyph in
+    // the meantime keep theirs and drop ours
+    STROKE_GLYPH* decoded = decodeNewStrokeGlyph( m_fontData[aIndex] );
+
+    if( m_glyphs[aIndex].compare_exchange_strong( glyph, decoded, std::memory_order_acq_rel ) )
+        return decoded;
+
+    delete decoded;
+    return glyph;
+}
+
+
 double STROKE_FONT::GetInterline( double aGlyphHeight, double aLineSpacing ) const
 {
     // Do not add the glyph thickness to the interline.  This makes bold text line-spacing
@@ -234,7 +272,7 @@ VECTOR2I STROKE_FONT::GetTextAsGlyphs( BOX2I* aBBox, std::vector<std::unique_ptr
     VECTOR2I cursor( aPosition );
     VECTOR2D glyphSize( aSize );
     double   tilt = ( aTextStyle & TEXT_STYLE::ITALIC ) ? ITALIC_TILT : 0.0;
-    double   space_width = m_glyphBoundingBoxes->front().GetWidth(); // First char is space
+    double   space_width = getGlyph( 0 )->BoundingBox().GetWidth(); // First char is space
     int      char_count = 0;
 
     if( aTextStyle & TEXT_STYLE::SUBSCRIPT || aTextStyle & TEXT_STYLE::SUPERSCRIPT )
@@ -276,13 +314,13 @@ VECTOR2I STROKE_FONT::GetTextAsGlyphs( BOX2I* aBBox, std::vector<std::unique_ptr
             int dd = (signed) c - ' ';
 
             // Filtering non existing glyphs and non printable chars
-            if( dd < 0 || dd >= (int) m_glyphBoundingBoxes->size() )
+            if( dd < 0 || dd >= m_fontDataSize )
             {
                 c = '?';
                 dd = (signed) c - ' ';
             }
 
-            STROKE_GLYPH* source = static_cast<STROKE_GLYPH*>( m_glyphs->at( dd ).get() );
+            STROKE_GLYPH* source = getGlyph( dd );
 
             if( aGlyphs )
             {
@@ -309,3 +347,27 @@ VECTOR2I STROKE_FONT::GetTextAsGlyphs( BOX2I* aBBox, std::vector<std::unique_ptr
 
     return VECTOR2I( cursor.x, aPosition.y );
 }
+
+
+void STROKE_FONT::GetLinesAsPolylines( std::vector<std::vector<VECTOR2D>>* aPolylines,
+                                       const wxString& aText, const VECTOR2I& aPosition,
+                                       const TEXT_ATTRIBUTES& aAttrs ) const
+{
+    std::vector<std::unique_ptr<GLYPH>> glyphs;
+
+    getLinesAsGlyphs( &glyphs, aText, aPosition, aPosition, aAttrs );
+
+    size_t count = aPolylines->size();
+
+    for( const std::unique_ptr<GLYPH>& glyph : glyphs )
+        count += static_cast<const STROKE_GLYPH*>( glyph.get() )->size();
+
+    aPolylines->reserve( count );
+
+    // The glyphs are throw-away copies, so their point lists can be moved rather than copied
+    for( std::unique_ptr<GLYPH>& glyph : glyphs )
+    {
+        for( std::vector<VECTOR2D>& pointList : *static_cast<STROKE_GLYPH*>( glyph.get() ) )
+            aPolylines->push_back( std::move( pointList ) );
+    }
+}
@@ -30,6 +30,7 @@
 #include <wx/image.h>
 #include <wx/log.h>
 
+#include <advanced_config.h>
 #include <gal/cairo/cairo_gal.h>
 #include <gal/cairo/cairo_compositor.h>
 #include <gal/definitions.h>
@@ -37,6 +38,7 @@
 #include <math/util.h> // for KiROUND
 #include <trigo.h>
 #include <bitmap_base.h>
+#include <thread_pool.h>
 
 #include <algorithm>
 #include <cmath>
@@ -829,58 +831,82 @@ void CAIRO_GAL_BASE::EndGroup()
 
 
 void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    GROUP_REPLAY_STATE state = { m_isFillEnabled, m_isStrokeEnabled, m_fillColor, m_strokeColor };
+
+    replayGroup( m_currentContext, aGroupNumber, state );
+
+    m_isFillEnabled = state.m_IsFillEnabled;
+    m_isStrokeEnabled = state.m_IsStrokeEnabled;
+    m_fillColor = state.m_FillColor;
+    m_strokeColor = state.m_StrokeColor;
+}
+
+
+void CAIRO_GAL_BASE::replayGroup( cairo_t* aContext, int aGroupNumber,
+                                  GROUP_REPLAY_STATE& aState, bool aDraw ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
 
-    storePath();
+    auto group = m_groups.find( aGroupNumber );
 
-    for( auto it = m_groups[aGroupNumber].begin(); it != m_groups[aGroupNumber].end(); ++it )
+    if( group == m_groups.end() )
+        return;
+
+    for( auto it = group->second.begin(); it != group->second.end(); ++it )
     {
         switch( it->m_Command )
         {
         case CMD_SET_FILL:
-            m_isFillEnabled = it->m_Argument.BoolArg;
+            aState.m_IsFillEnabled = it->m_Argument.BoolArg;
             break;
 
         case CMD_SET_STROKE:
-            m_isStrokeEnabled = it->m_Argument.BoolArg;
+            aState.m_IsStrokeEnabled = it->m_Argument.BoolArg;
             break;
 
         case CMD_SET_FILLCOLOR:
-            m_fillColor = COLOR4D( it->m_Argument.DblArg[0], it->m_Argument.DblArg[1],
-                                   it->m_Argument.DblArg[2], it->m_Argument.DblArg[3] );
+            aState.m_FillColor = COLOR4D( it->m_Argument.DblArg[0], it->m_Argument.DblArg[1],
+                                          it->m_Argument.DblArg[2], it->m_Argument.DblArg[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            m_strokeColor = COLOR4D( it->m_Argument.DblArg[0], it->m_Argument.DblArg[1],
-                                     it->m_Argument.DblArg[2], it->m_Argument.DblArg[3] );
+            aState.m_StrokeColor = COLOR4D( it->m_Argument.DblArg[0], it->m_Argument.DblArg[1],
+                                            it->m_Argument.DblArg[2], it->m_Argument.DblArg[3] );
             break;
 
         case CMD_SET_LINE_WIDTH:
         {
             // Make lines appear at least 1 pixel wide, no matter of zoom
             double x = 1.0, y = 1.0;
-            cairo_device_to_user_distance( m_currentContext, &x, &y );
+            cairo_device_to_user_distance( aContext, &x, &y );
             double minWidth = std::min( fabs( x ), fabs( y ) );
-            cairo_set_line_width( m_currentContext,
-                                  std::max( it->m_Argument.DblArg[0], minWidth ) );
+            cairo_set_line_width( aContext, std::max( it->m_Argument.DblArg[0], minWidth ) );
             break;
         }
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgba( m_currentContext, m_strokeColor.r, m_strokeColor.g,
-                                   m_strokeColor.b, m_strokeColor.a );
-            cairo_append_path( m_currentContext, it->m_CairoPath );
-            cairo_stroke( m_currentContext );
+            if( !aDraw )
+                break;
+
+            cairo_set_source_rgba( aContext, aState.m_StrokeColor.r, aState.m_StrokeColor.g,
+                                   aState.m_StrokeColor.b, aState.m_StrokeColor.a );
+            cairo_append_path( aContext, it->m_CairoPath );
+            cairo_stroke( aContext );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgba( m_currentContext, m_fillColor.r, m_fillColor.g, m_fillColor.b,
-                                   m_strokeColor.a );
-            cairo_append_path( m_currentContext, it->m_CairoPath );
-            cairo_fill( m_currentContext );
+            if( !aDraw )
+                break;
+
+            cairo_set_source_rgba( aContext, aState.m_FillColor.r, aState.m_FillColor.g,
+                                   aState.m_FillColor.b, aState.m_StrokeColor.a );
+            cairo_append_path( aContext, it->m_CairoPath );
+            cairo_fill( aContext );
             break;
 
             /*
@@ -889,32 +915,32 @@ void CAIRO_GAL_BASE::DrawGroup( int aGroupNumber )
             cairo_matrix_init( &matrix, it->argument.DblArg[0], it->argument.DblArg[1],
                                it->argument.DblArg[2], it->argument.DblArg[3],
                                it->argument.DblArg[4], it->argument.DblArg[5] );
-            cairo_transform( m_currentContext, &matrix );
+            cairo_transform( aContext, &matrix );
             break;
             */
 
         case CMD_ROTATE:
-            cairo_rotate( m_currentContext, it->m_Argument.DblArg[0] );
+            cairo_rotate( aContext, it->m_Argument.DblArg[0] );
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( m_currentContext, it->m_Argument.DblArg[0], it->m_Argument.DblArg[1] );
+            cairo_translate( aContext, it->m_Argument.DblArg[0], it->m_Argument.DblArg[1] );
             break;
 
         case CMD_SCALE:
-            cairo_scale( m_currentContext, it->m_Argument.DblArg[0], it->m_Argument.DblArg[1] );
+            cairo_scale( aContext, it->m_Argument.DblArg[0], it->m_Argument.DblArg[1] );
             break;
 
         case CMD_SAVE:
-            cairo_save( m_currentContext );
+            cairo_save( aContext );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( m_currentContext );
+            cairo_restore( aContext );
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->m_Argument.IntArg );
+            replayGroup( aContext, it->m_Argument.IntArg, aState, aDraw );
             break;
         }
     }
@@ -1258,6 +1284,39 @@ void CAIRO_GAL_BASE::drawPoly( const std::vector<VECTOR2D>& aPointList )
 }
 
 
+void CAIRO_GAL_BASE::appendPolyline( const std::vector<VECTOR2D>& aPointList )
+{
+    if( aPointList.size() < 2 )
+        return;
+
+    const VECTOR2D p = roundp( xform( aPointList[0] ) );
+
+    cairo_move_to( m_currentContext, p.x, p.y );
+
+    for( size_t ii = 1; ii < aPointList.size(); ++ii )
+    {
+        const VECTOR2D p2 = roundp( xform( aPointList[ii] ) );
+
+        cairo_line_to( m_currentContext, p2.x, p2.y );
+    }
+}
+
+
+void CAIRO_GAL_BASE::DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists )
+{
+    if( aPointLists.empty() )
+        return;
+
+    syncLineWidth();
+
+    for( const std::vector<VECTOR2D>& points : aPointLists )
+        appendPolyline( points );
+
+    flushPath();
+    m_isElementAdded = true;
+}
+
+
 void CAIRO_GAL_BASE::drawPoly( const VECTOR2D aPointList[], int aListSize )
 {
     wxCHECK( aListSize > 1, /* void */ );
@@ -1339,6 +1398,8 @@ CAIRO_GAL::CAIRO_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, wxWindow* aParent,
     m_bitmapBuffer = nullptr;
     m_wxOutput = nullptr;
 
+    m_isBatchingGroups = false;
+
     m_parentWindow = aParent;
     m_mouseListener = aMouseListener;
     m_paintListener = aPaintListener;
@@ -1490,6 +1551,268 @@ void CAIRO_GAL::EndGroup()
 }
 
 
+void CAIRO_GAL::DrawGroup( int aGroupNumber )
+{
+    if( m_isBatchingGroups )
+        m_batchedGroups.push_back( aGroupNumber );
+    else
+        CAIRO_GAL_BASE::DrawGroup( aGroupNumber );
+}
+
+
+void CAIRO_GAL::BeginGroupBatch()
+{
+    m_batchedGroups.clear();
+    m_isBatchingGroups = ADVANCED_CFG::GetCfg().m_CairoTiledRendering && !m_isGrouping;
+}
+
+
+void CAIRO_GAL::EndGroupBatch()
+{
+    if( !m_isBatchingGroups )
+        return;
+
+    m_isBatchingGroups = false;
+
+    // A few groups are not worth clearing and compositing the tiles for
+    if( m_batchedGroups.size() < 64 || !drawGroupsTiled( m_batchedGroups ) )
+    {
+        for( int group : m_batchedGroups )
+            CAIRO_GAL_BASE::DrawGroup( group );
+    }
+
+    m_batchedGroups.clear();
+}
+
+
+bool CAIRO_GAL::drawGroupsTiled( const std::vector<int>& aGroups )
+{
+    // Compositing the tiles over the buffer gives the same result as drawing the groups directly
+    // only for the default operator (i.e. not in negative draw mode)
+    if( !m_isInitialized || cairo_get_operator( m_currentContext ) != CAIRO_OPERATOR_OVER )
+        return false;
+
+    thread_pool& tp = GetKiCadThreadPool();
+
+    // Keep the bands tall enough that paths spanning several of them are not replayed for nothing
+    const int tileCount = std::min<int>( tp.get_thread_count(), m_screenSize.y / 64 );
+
+    if( tileCount < 2 )
+        return false;
+
+    const int tileHeight = ( m_screenSize.y + tileCount - 1 ) / tileCount;
+
+    if( m_tileSurfaces.size() != (size_t) tileCount
+            || cairo_image_surface_get_width( m_tileSurfaces[0] ) != m_screenSize.x
+            || cairo_image_surface_get_height( m_tileSurfaces[0] ) != tileHeight )
+    {
+        for( cairo_surface_t* tileSurface : m_tileSurfaces )
+            cairo_surface_destroy( tileSurface );
+
+        m_tileSurfaces.resize( tileCount );
+
+        for( cairo_surface_t*& tileSurface : m_tileSurfaces )
+            tileSurface = cairo_image_surface_create( GAL_FORMAT, m_screenSize.x, tileHeight );
+    }
+
+    storePath();
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix( m_currentContext, &matrix );
+
+    const GROUP_REPLAY_STATE initialState = { m_isFillEnabled, m_isStrokeEnabled, m_fillColor,
+                                              m_strokeColor };
+    GROUP_REPLAY_STATE       finalState = initialState;
+    cairo_matrix_t           finalMatrix = matrix;
+    double                   finalLineWidth = cairo_get_line_width( m_currentContext );
+
+    // Vertical extent of the paths of each group on the screen, so that the bands can skip
+    // drawing the groups they don't intersect.  Paths are stored in the user space their group
+    // is called in, which is only known here until a group leaves a transform behind; the
+    // following groups are drawn in every band.
+    const double                           inf = std::numeric_limits<double>::infinity();
+    std::vector<std::pair<double, double>> spans( aGroups.size(), { -inf, inf } );
+    bool                                   userSpaceKnown = true;
+    double                                 maxLineWidth = finalLineWidth;
+    double                                 joinFactor = M_SQRT2;    // for square caps
+
+    if( cairo_get_line_join( m_currentContext ) == CAIRO_LINE_JOIN_MITER )
+        joinFactor = std::max( joinFactor, cairo_get_miter_limit( m_currentContext ) );
+
+    for( size_t ii = 0; ii < aGroups.size() && userSpaceKnown; ++ii )
+    {
+        auto group = m_groups.find( aGroups[ii] );
+
+        if( group == m_groups.end() )
+            continue;
+
+        VECTOR2D min( inf, inf );
+        VECTOR2D max( -inf, -inf );
+        bool     hasTransform = false;
+        bool     leavesTransform = false;
+        int      depth = 0;
+
+        for( const GROUP_ELEMENT& element : group->second )
+        {
+            switch( element.m_Command )
+            {
+            case CMD_SET_LINE_WIDTH:
+                maxLineWidth = std::max( maxLineWidth, element.m_Argument.DblArg[0] );
+                break;
+
+            case CMD_STROKE_PATH:
+            case CMD_FILL_PATH:
+            {
+                const cairo_path_t* path = element.m_CairoPath;
+
+                for( int jj = 0; jj < path->num_data; jj += path->data[jj].header.length )
+                {
+                    for( int kk = 1; kk < path->data[jj].header.length; ++kk )
+                    {
+                        const cairo_path_data_t& point = path->data[jj + kk];
+
+                        min.x = std::min( min.x, point.point.x );
+                        min.y = std::min( min.y, point.point.y );
+                        max.x = std::max( max.x, point.point.x );
+                        max.y = std::max( max.y, point.point.y );
+                    }
+                }
+
+                break;
+            }
+
+            case CMD_SAVE:
+                depth++;
+                break;
+
+            case CMD_RESTORE:
+                depth--;
+                break;
+
+            case CMD_ROTATE:
+            case CMD_TRANSLATE:
+            case CMD_SCALE:
+                hasTransform = true;
+                leavesTransform |= depth <= 0;
+                break;
+
+            case CMD_CALL_GROUP:
+                hasTransform = true;
+                leavesTransform = true;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if( leavesTransform || depth != 0 )
+            userSpaceKnown = false;
+
+        if( hasTransform || depth != 0 )
+            continue;
+
+        if( min.x > max.x )
+        {
+            spans[ii] = { inf, -inf };      // nothing to draw in any band
+            continue;
+        }
+
+        const double margin = maxLineWidth / 2.0 * joinFactor;
+        double       top = inf;
+        double       bottom = -inf;
+
+        for( const VECTOR2D& corner : { VECTOR2D( min.x - margin, min.y - margin ),
+                                        VECTOR2D( max.x + margin, min.y - margin ),
+                                        VECTOR2D( min.x - margin, max.y + margin ),
+                                        VECTOR2D( max.x + margin, max.y + margin ) } )
+        {
+            double x = corner.x;
+            double y = corner.y;
+
+            cairo_matrix_transform_point( &matrix, &x, &y );
+            top = std::min( top, y );
+            bottom = std::max( bottom, y );
+        }
+
+        // Lines are at least a pixel wide, and antialiasing bleeds into the next pixel
+        spans[ii] = { top - 2.0, bottom + 2.0 };
+    }
+
+    auto futures = tp.parallelize_loop( tileCount,
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    cairo_t* ctx = cairo_create( m_tileSurfaces[ii] );
+
+                    cairo_set_operator( ctx, CAIRO_OPERATOR_CLEAR );
+                    cairo_paint( ctx );
+                    cairo_set_operator( ctx, CAIRO_OPERATOR_OVER );
+
+                    // Same settings as the buffer context, shifted to the band origin
+                    cairo_matrix_t tileMatrix = matrix;
+                    tileMatrix.y0 -= ii * tileHeight;
+
+                    cairo_set_matrix( ctx, &tileMatrix );
+                    cairo_set_antialias( ctx, cairo_get_antialias( m_currentContext ) );
+                    cairo_set_tolerance( ctx, cairo_get_tolerance( m_currentContext ) );
+                    cairo_set_fill_rule( ctx, cairo_get_fill_rule( m_currentContext ) );
+                    cairo_set_line_cap( ctx, cairo_get_line_cap( m_currentContext ) );
+                    cairo_set_line_join( ctx, cairo_get_line_join( m_currentContext ) );
+                    cairo_set_miter_limit( ctx, cairo_get_miter_limit( m_currentContext ) );
+                    cairo_set_line_width( ctx, cairo_get_line_width( m_currentContext ) );
+
+                    GROUP_REPLAY_STATE state = initialState;
+                    const double       bandTop = ii * tileHeight;
+                    const double       bandBottom = bandTop + tileHeight;
+
+                    for( size_t jj = 0; jj < aGroups.size(); ++jj )
+                    {
+                        bool visible = spans[jj].second >= bandTop
+                                       && spans[jj].first <= bandBottom;
+
+                        replayGroup( ctx, aGroups[jj], state, visible );
+                    }
+
+                    // Every band runs the same commands, so any of them has the state the
+                    // buffer context would have been left in
+                    if( ii == 0 )
+                    {
+                        finalState = state;
+                        finalLineWidth = cairo_get_line_width( ctx );
+                        cairo_get_matrix( ctx, &finalMatrix );
+                    }
+
+                    cairo_destroy( ctx );
+                    cairo_surface_flush( m_tileSurfaces[ii] );
+                }
+            } );
+    futures.wait();
+
+    cairo_save( m_currentContext );
+    cairo_identity_matrix( m_currentContext );
+
+    for( int ii = 0; ii < tileCount; ++ii )
+    {
+        cairo_set_source_surface( m_currentContext, m_tileSurfaces[ii], 0, ii * tileHeight );
+        cairo_paint( m_currentContext );
+    }
+
+    cairo_restore( m_currentContext );
+
+    cairo_set_matrix( m_currentContext, &finalMatrix );
+    cairo_set_line_width( m_currentContext, finalLineWidth );
+
+    m_isFillEnabled = finalState.m_IsFillEnabled;
+    m_isStrokeEnabled = finalState.m_IsStrokeEnabled;
+    m_fillColor = finalState.m_FillColor;
+    m_strokeColor = finalState.m_StrokeColor;
+
+    return true;
+}
+
+
 void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
 {
     // If the compositor is not set, that means that there is a recaching process going on
@@ -1603,6 +1926,11 @@ void CAIRO_GAL::deleteBitmaps()
 
     delete[] m_wxOutput;
     m_wxOutput = nullptr;
+
+    for( cairo_surface_t* tileSurface : m_tileSurfaces )
+        cairo_surface_destroy( tileSurface );
+
+    m_tileSurfaces.clear();
 }
 
 
@@ -1805,6 +2133,45 @@ void CAIRO_GAL_BASE::DrawGrid()
 }
 
 
+void CAIRO_GAL_BASE::DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>& aGlyphs )
+{
+    if( aGlyphs.empty() )
+        return;
+
+    bool allGlyphsAreStroke = true;
+
+    for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
+    {
+        if( !glyph->IsStroke() )
+        {
+            allGlyphsAreStroke = false;
+            break;
+        }
+    }
+
+    if( allGlyphsAreStroke )
+    {
+        // Stroke the whole string as one path rather than one path per glyph stroke
+        syncLineWidth();
+
+        for( const std::unique_ptr<KIFONT::GLYPH>& glyph : aGlyphs )
+        {
+            const auto& strokeGlyph = static_cast<const KIFONT::STROKE_GLYPH&>( *glyph );
+
+            for( const std::vector<VECTOR2D>& pointList : strokeGlyph )
+                appendPolyline( pointList );
+        }
+
+        flushPath();
+        m_isElementAdded = true;
+        return;
+    }
+
+    for( size_t i = 0; i < aGlyphs.size(); i++ )
+        DrawGlyph( *aGlyphs[i], i, aGlyphs.size() );
+}
+
+
 void CAIRO_GAL_BASE::DrawGlyph( const KIFONT::GLYPH& aGlyph, int aNth, int aTotal )
 {
     if( aGlyph.IsStroke() )
@@ -0,0 +1,44 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOB_SCH_ERC_H
+#define JOB_SCH_ERC_H
+
+#include <wx/string.h>
+#include "job.h"
+
+class JOB_SCH_ERC : public JOB
+{
+public:
+    JOB_SCH_ERC( bool aIsCli ) :
+            JOB( "erc", aIsCli ),
+            m_filename(),
+            m_outputFile(),
+            m_exitCodeViolations( false )
+    {
+    }
+
+    wxString m_filename;
+    wxString m_outputFile;
+
+    /// Return a non-zero exit code if any error-level violations are found
+    bool m_exitCodeViolations;
+};
+
+#endif
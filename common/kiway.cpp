@@ -36,6 +36,7 @@
 #include <kiplatform/app.h>
 #include <kiplatform/environment.h>
 #include <settings/settings_manager.h>
+#include <startup_trace.h>
 #include <tool/action_manager.h>
 #include <logging.h>
 
@@ -221,6 +222,9 @@ KIFACE* KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
     {
         wxString dname = dso_search_path( aFaceId );
 
+        SCOPED_STARTUP_TRACE( "KIWAY::KiFACE " + wxFileName( dname ).GetName().ToStdString(),
+                              "kiface" );
+
         // Insert DLL search path for kicad_3dsg from build dir
         if( wxGetEnv( wxT( "KICAD_RUN_FROM_BUILD_DIR" ), nullptr ) )
         {
@@ -256,7 +260,12 @@ KIFACE* KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
         std::string user_locale = setlocale( lc_new_type, nullptr );
         setlocale( lc_new_type, "C" );
 
-        bool success = dso.Load( dname, wxDL_VERBATIM | wxDL_NOW | wxDL_GLOBAL );
+        bool success;
+
+        {
+            SCOPED_STARTUP_TRACE( "Load kiface library", "kiface" );
+            success = dso.Load( dname, wxDL_VERBATIM | wxDL_NOW | wxDL_GLOBAL );
+        }
 
         setlocale( lc_new_type, user_locale.c_str() );
 
@@ -307,6 +316,7 @@ KIFACE* KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
 
             try
             {
+                SCOPED_STARTUP_TRACE( "KIFACE::OnKifaceStart", "kiface" );
                 startSuccess = kiface->OnKifaceStart( m_program, m_ctl );
             }
             catch (...)
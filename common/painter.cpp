@@ -26,15 +26,83 @@
 
 #include <painter.h>
 #include <gal/graphics_abstraction_layer.h>
+#include <font/font.h>
+#include <trigo.h>
 
 using namespace KIGFX;
 
 PAINTER::PAINTER( GAL* aGal ) :
     m_gal( aGal )
 {
+    ResetDetailRange();
 }
 
 
 PAINTER::~PAINTER()
 {
 }
+
+
+bool PAINTER::isBelowDetailThreshold( double aWorldSize, double aMinPixels )
+{
+    // Printouts are always drawn in full detail
+    if( aMinPixels <= 0.0 || GetSettings()->IsPrinting() )
+        return false;
+
+    if( aWorldSize <= 0.0 )
+        return true;
+
+    // World scale at which the feature is exactly aMinPixels large
+    double threshold = aMinPixels / aWorldSize;
+
+    if( m_gal->GetWorldScale() < threshold )
+    {
+        m_detailMaxScale = std::min( m_detailMaxScale, threshold );
+        return true;
+    }
+
+    m_detailMinScale = std::max( m_detailMinScale, threshold );
+    return false;
+}
+
+
+void PAINTER::drawTextBar( const wxString& aText, const VECTOR2D& aPosition,
+                           const TEXT_ATTRIBUTES& aAttrs, const KIFONT::FONT* aFont )
+{
+    VECTOR2I extents = aFont->StringBoundaryLimits( aText, aAttrs.m_Size, aAttrs.m_StrokeWidth,
+                                                    aAttrs.m_Bold, aAttrs.m_Italic );
+    GR_TEXT_H_ALIGN_T halign = aAttrs.m_Halign;
+
+    if( aAttrs.m_Mirrored )
+        halign = static_cast<GR_TEXT_H_ALIGN_T>( -halign );
+
+    // Bar along the middle of the unrotated text
+    VECTOR2D start( aPosition );
+
+    switch( halign )
+    {
+    case GR_TEXT_H_ALIGN_LEFT:                                 break;
+    case GR_TEXT_H_ALIGN_CENTER: start.x -= extents.x / 2.0;   break;
+    case GR_TEXT_H_ALIGN_RIGHT:  start.x -= extents.x;         break;
+    }
+
+    switch( aAttrs.m_Valign )
+    {
+    case GR_TEXT_V_ALIGN_TOP:    start.y += extents.y / 2.0;   break;
+    case GR_TEXT_V_ALIGN_CENTER:                               break;
+    case GR_TEXT_V_ALIGN_BOTTOM: start.y -= extents.y / 2.0;   break;
+    }
+
+    VECTOR2D end( start.x + extents.x, start.y );
+
+    RotatePoint( start, aPosition, aAttrs.m_Angle );
+    RotatePoint( end, aPosition, aAttrs.m_Angle );
+
+    // Stroke fonts are drawn with the stroke color, outline fonts with the fill color
+    COLOR4D color = aFont->IsOutline() ? m_gal->GetFillColor() : m_gal->GetStrokeColor();
+
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( color );
+    m_gal->DrawSegment( start, end, extents.y / 2.0 );
+}
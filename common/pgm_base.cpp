@@ -62,6 +62,7 @@
 #include <python_scripting.h>
 #include <settings/common_settings.h>
 #include <settings/settings_manager.h>
+#include <startup_trace.h>
 #include <systemdirsappend.h>
 #include <thread_pool.h>
 #include <trace_helpers.h>
@@ -152,6 +153,13 @@ PGM_BASE::~PGM_BASE()
 
 void PGM_BASE::Destroy()
 {
+    // Rewrite the startup trace to pick up any KIFACEs loaded after startup completed
+    if( m_startup_tracer )
+    {
+        m_startup_tracer->Write();
+        m_startup_tracer.reset();
+    }
+
     KICAD_CURL::Cleanup();
 
 #ifdef KICAD_USE_SENTRY
@@ -412,6 +420,13 @@ bool PGM_BASE::InitPgm( bool aHeadless, bool aSkipPyInit, bool aIsUnitTest )
     // In particular, the user cache path is the most likely to be hit by startup code
     PATHS::EnsureUserPathsExist();
 
+    wxString startupTracePath = STARTUP_TRACER::GetRequestedOutputPath();
+
+    if( !startupTracePath.IsEmpty() )
+        m_startup_tracer = std::make_unique<STARTUP_TRACER>( startupTracePath );
+
+    SCOPED_STARTUP_TRACE( "PGM_BASE::InitPgm", "startup" );
+
     KICAD_CURL::Init();
 
 #ifdef KICAD_USE_SENTRY
@@ -486,7 +501,11 @@ bool PGM_BASE::InitPgm( bool aHeadless, bool aSkipPyInit, bool aIsUnitTest )
     wxSetEnv( "FONTCONFIG_PATH", PATHS::GetWindowsFontConfigDir() );
 #endif
 
-    m_settings_manager = std::make_unique<SETTINGS_MANAGER>( aHeadless );
+    {
+        // Includes the migration of settings from a previous version, if needed
+        SCOPED_STARTUP_TRACE( "SETTINGS_MANAGER", "settings" );
+        m_settings_manager = std::make_unique<SETTINGS_MANAGER>( aHeadless );
+    }
 
     // Our unit test mocks break if we continue
     // A bug caused InitPgm to terminate early in unit tests and the mocks are...simplistic
@@ -498,14 +517,19 @@ bool PGM_BASE::InitPgm( bool aHeadless, bool aSkipPyInit, bool aIsUnitTest )
     if( !m_settings_manager->IsOK() )
         return false;
 
-    // Set up built-in environment variables (and override them from the system environment if set)
-    GetCommonSettings()->InitializeEnvironment();
+    {
+        SCOPED_STARTUP_TRACE( "Load common and color settings", "settings" );
 
-    // Load color settings after env is initialized
-    m_settings_manager->ReloadColorSettings();
+        // Set up built-in environment variables (and override them from the system environment
+        // if set)
+        GetCommonSettings()->InitializeEnvironment();
 
-    // Load common settings from disk after setting up env vars
-    GetSettingsManager().Load( GetCommonSettings() );
+        // Load color settings after env is initialized
+        m_settings_manager->ReloadColorSettings();
+
+        // Load common settings from disk after setting up env vars
+        GetSettingsManager().Load( GetCommonSettings() );
+    }
 
     // Init user language *before* calling loadSettings, because
     // env vars could be incorrectly initialized on Linux
@@ -526,7 +550,10 @@ bool PGM_BASE::InitPgm( bool aHeadless, bool aSkipPyInit, bool aIsUnitTest )
     // Create the python scripting stuff
     // Skip it fot applications that do not use it
     if( !aSkipPyInit )
+    {
+        SCOPED_STARTUP_TRACE( "SCRIPTING", "python" );
         m_python_scripting = std::make_unique<SCRIPTING>();
+    }
 
     // TODO(JE): Remove this if apps are refactored to not assume Prj() always works
     // Need to create a project early for now (it can have an empty path for the moment)
@@ -547,6 +574,16 @@ bool PGM_BASE::InitPgm( bool aHeadless, bool aSkipPyInit, bool aIsUnitTest )
 }
 
 
+void PGM_BASE::FinishStartupTrace()
+{
+    if( !m_startup_tracer )
+        return;
+
+    m_startup_tracer->AddInstant( "Startup complete", "startup" );
+    m_startup_tracer->Write();
+}
+
+
 bool PGM_BASE::setExecutablePath()
 {
     m_bin_dir = wxStandardPaths::Get().GetExecutablePath();
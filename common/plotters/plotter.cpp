@@ -42,6 +42,7 @@
 #include <geometry/shape_line_chain.h>
 #include <bezier_curves.h>
 #include <callback_gal.h>
+#include <font/stroke_font.h>
 #include <math/util.h>      // for KiROUND
 
 PLOTTER::PLOTTER( )
@@ -694,6 +695,35 @@ void PLOTTER::PlotPoly( const SHAPE_LINE_CHAIN& aCornerList, FILL_T aFill, int a
 }
 
 
+/**
+ * Plot a stroke font string with one pen-down polyline per glyph stroke.
+ *
+ * The whole string is laid out in a single call and each stroke is plotted as a polyline,
+ * rather than lifting the pen after every segment as the generic GAL callback path does.
+ */
+static void plotStrokeText( PLOTTER* aPlotter, const KIFONT::STROKE_FONT* aFont,
+                            const wxString& aText, const VECTOR2I& aPos,
+                            const TEXT_ATTRIBUTES& aAttributes )
+{
+    std::vector<std::vector<VECTOR2D>> strokes;
+
+    aFont->GetLinesAsPolylines( &strokes, aText, aPos, aAttributes );
+
+    for( const std::vector<VECTOR2D>& stroke : strokes )
+    {
+        if( stroke.size() < 2 )
+            continue;
+
+        aPlotter->MoveTo( stroke[0] );
+
+        for( size_t ii = 1; ii < stroke.size(); ++ii )
+            aPlotter->LineTo( stroke[ii] );
+
+        aPlotter->PenFinish();
+    }
+}
+
+
 void PLOTTER::Text( const VECTOR2I&             aPos,
                     const COLOR4D&              aColor,
                     const wxString&             aText,
@@ -752,6 +782,13 @@ void PLOTTER::Text( const VECTOR2I&             aPos,
     if( !aFont )
         aFont = KIFONT::FONT::GetFont();
 
+    if( aFont->IsStroke() )
+    {
+        plotStrokeText( this, static_cast<KIFONT::STROKE_FONT*>( aFont ), aText, aPos,
+                        attributes );
+        return;
+    }
+
     aFont->Draw( &callback_gal, aText, aPos, attributes );
 }
 
@@ -794,5 +831,12 @@ void PLOTTER::PlotText( const VECTOR2I& aPos, const COLOR4D& aColor,
     if( !aFont )
         aFont = KIFONT::FONT::GetFont();
 
+    if( aFont->IsStroke() )
+    {
+        plotStrokeText( this, static_cast<KIFONT::STROKE_FONT*>( aFont ), aText, aPos,
+                        attributes );
+        return;
+    }
+
     aFont->Draw( &callback_gal, aText, aPos, attributes );
 }
@@ -389,5 +389,7 @@ bool PGM_SINGLE_TOP::OnPgmInit()
         frame->OpenProjectFiles( fileArgs );
     }
 
+    FinishStartupTrace();
+
     return true;
 }
@@ -0,0 +1,141 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <startup_trace.h>
+
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+#include <wx/log.h>
+#include <wx/utils.h>
+
+#include <advanced_config.h>
+#include <pgm_base.h>
+
+
+STARTUP_TRACER::STARTUP_TRACER( const wxString& aOutputPath ) :
+        m_outputPath( aOutputPath ),
+        m_epoch( CLOCK::now() )
+{
+    m_events.reserve( 64 );
+}
+
+
+wxString STARTUP_TRACER::GetRequestedOutputPath()
+{
+    wxString path;
+
+    if( wxGetEnv( wxT( "KICAD_STARTUP_TRACE" ), &path ) && !path.IsEmpty() )
+        return path;
+
+    return ADVANCED_CFG::GetCfg().m_StartupTracePath;
+}
+
+
+void STARTUP_TRACER::AddEvent( const std::string& aName, const char* aCategory,
+                               CLOCK::time_point aStart, CLOCK::time_point aEnd )
+{
+    size_t threadId = std::hash<std::thread::id>()( std::this_thread::get_id() );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_events.push_back( { aName, aCategory, 'X', toMicros( aStart ),
+                          std::chrono::duration<double, std::micro>( aEnd - aStart ).count(),
+                          threadId } );
+}
+
+
+void STARTUP_TRACER::AddInstant( const char* aName, const char* aCategory )
+{
+    size_t threadId = std::hash<std::thread::id>()( std::this_thread::get_id() );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_events.push_back( { aName, aCategory, 'i', toMicros( CLOCK::now() ), 0.0, threadId } );
+}
+
+
+bool STARTUP_TRACER::Write()
+{
+    nlohmann::json events = nlohmann::json::array();
+    unsigned long  pid = wxGetProcessId();
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        for( const EVENT& event : m_events )
+        {
+            nlohmann::json js = { { "name", event.name },
+                                  { "cat", event.category },
+                                  { "ph", std::string( 1, event.phase ) },
+                                  { "ts", event.start_us },
+                                  { "pid", pid },
+                                  { "tid", event.thread_id } };
+
+            if( event.phase == 'X' )
+                js["dur"] = event.duration_us;
+            else
+                js["s"] = "p";      // instant events span the whole process
+
+            events.push_back( std::move( js ) );
+        }
+    }
+
+    nlohmann::json trace = { { "traceEvents", std::move( events ) },
+                             { "displayTimeUnit", "ms" } };
+
+    std::ofstream out( m_outputPath.fn_str(), std::ios::out | std::ios::trunc );
+
+    if( !out )
+    {
+        wxLogError( wxT( "Unable to write startup trace to '%s'." ), m_outputPath );
+        return false;
+    }
+
+    out << trace.dump( 1 );
+    return out.good();
+}
+
+
+STARTUP_TRACE_SCOPE::STARTUP_TRACE_SCOPE( const std::string& aName, const char* aCategory ) :
+        m_tracer( nullptr ),
+        m_category( aCategory )
+{
+    if( PGM_BASE* pgm = PgmOrNull() )
+        m_tracer = pgm->GetStartupTracer();
+
+    if( m_tracer )
+    {
+        m_name = aName;
+        m_start = STARTUP_TRACER::CLOCK::now();
+    }
+}
+
+
+STARTUP_TRACE_SCOPE::~STARTUP_TRACE_SCOPE()
+{
+    if( m_tracer )
+        m_tracer->AddEvent( m_name, m_category, m_start, STARTUP_TRACER::CLOCK::now() );
+}
@@ -41,6 +41,7 @@
 #include <painter.h>
 
 #include <profile.h>
+#include <thread_pool.h>
 
 #ifdef KICAD_GAL_PROFILE
 #include <wx/log.h>
@@ -57,9 +58,12 @@ public:
         m_view( nullptr ),
         m_flags( KIGFX::VISIBLE ),
         m_requiredUpdate( KIGFX::NONE ),
+        m_queuedForUpdate( false ),
         m_drawPriority( 0 ),
         m_groups( nullptr ),
-        m_groupsSize( 0 ) {}
+        m_groupsSize( 0 ),
+        m_detailMinScale( 0.0 ),
+        m_detailMaxScale( std::numeric_limits<double>::max() ) {}
 
     ~VIEW_ITEM_DATA()
     {
@@ -228,12 +232,16 @@ private:
     VIEW*                m_view;             ///< Current dynamic view the item is assigned to.
     int                  m_flags;            ///< Visibility flags
     int                  m_requiredUpdate;   ///< Flag required for updating
+    bool                 m_queuedForUpdate;  ///< Item is in its view's update queue
     int                  m_drawPriority;     ///< Order to draw this item in a layer, lowest first
 
     std::pair<int, int>* m_groups;           ///< layer_number:group_id pairs for each layer the
                                              ///< item occupies.
     int                  m_groupsSize;
 
+    double               m_detailMinScale;   ///< World scales the level of detail of the cached
+    double               m_detailMaxScale;   ///< groups is valid for (see PAINTER).
+
     std::vector<int>     m_layers;           /// Stores layer numbers used by the item.
 };
 
@@ -276,6 +284,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_allItems.reset( new std::vector<VIEW_ITEM*> );
     m_allItems->reserve( 32768 );
 
+    m_detailUpdatesQueued = false;
+
     // Redraw everything at the beginning
     MarkDirty();
 
@@ -361,6 +371,13 @@ void VIEW::Remove( VIEW_ITEM* aItem )
             aItem->m_viewPrivData->clearUpdateFlags();
         }
 
+        if( aItem->m_viewPrivData->m_queuedForUpdate )
+        {
+            m_updateQueue.erase( std::remove( m_updateQueue.begin(), m_updateQueue.end(), aItem ),
+                                 m_updateQueue.end() );
+            aItem->m_viewPrivData->m_queuedForUpdate = false;
+        }
+
         int layers[VIEW::VIEW_MAX_LAYERS], layers_count;
         aItem->m_viewPrivData->getLayers( layers, layers_count );
 
@@ -700,7 +717,7 @@ void VIEW::ReorderLayerData( std::unordered_map<int, int> aReorderMap )
 
         viewData->reorderGroups( aReorderMap );
 
-        viewData->m_requiredUpdate |= COLOR;
+        Update( item, COLOR );
     }
 
     UpdateItems();
@@ -994,12 +1011,21 @@ void VIEW::redrawRect( const BOX2I& aRect )
             else if( l->hasNegatives )
                 m_gal->StartNegativesLayer();
 
+            // Items on cached layers are only ever drawn from their groups, so the GAL is free
+            // to defer and batch them
+            bool batchGroups = l->target == TARGET_CACHED;
+
+            if( batchGroups )
+                m_gal->BeginGroupBatch();
 
             l->items->Query( aRect, drawFunc );
 
             if( m_useDrawPriority )
                 drawFunc.deferredDraw();
 
+            if( batchGroups )
+                m_gal->EndGroupBatch();
+
             if( l->diffLayer )
                 m_gal->EndDiffLayer();
             else if( l->hasNegatives )
@@ -1022,9 +1048,24 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
         int group = viewData->getGroup( aLayer );
 
         if( group >= 0 )
+        {
             m_gal->DrawGroup( group );
+
+            // The painter simplified (or not) some of the item's features for the zoom level it
+            // was cached at; draw the stale group for now and recache it for the next frame
+            double worldScale = m_gal->GetWorldScale();
+
+            if( worldScale < viewData->m_detailMinScale
+                    || worldScale >= viewData->m_detailMaxScale )
+            {
+                Update( aItem, REPAINT );
+                m_detailUpdatesQueued = true;
+            }
+        }
         else
+        {
             Update( aItem );
+        }
     }
     else
     {
@@ -1097,7 +1138,20 @@ void VIEW::Clear()
 {
     BOX2I r;
     r.SetMaximum();
+
+    // Items left alive are no longer part of this view; detach them so that later updates
+    // don't queue them here.
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        if( item->viewPrivData() && item->viewPrivData()->m_view == this )
+        {
+            item->viewPrivData()->m_view = nullptr;
+            item->viewPrivData()->m_queuedForUpdate = false;
+        }
+    }
+
     m_allItems->clear();
+    m_updateQueue.clear();
 
     for( VIEW_LAYER& layer : m_layers )
         layer.items->RemoveAll();
@@ -1153,9 +1207,17 @@ void VIEW::Redraw()
     // All targets were redrawn, so nothing is dirty
     MarkClean();
 
+    // ...except for the items that have to be recached at a different level of detail
+    if( m_detailUpdatesQueued )
+    {
+        MarkTargetDirty( TARGET_CACHED );
+        m_detailUpdatesQueued = false;
+    }
+
 #ifdef KICAD_GAL_PROFILE
     totalRealTime.Stop();
-    wxLogTrace( traceGalProfile, wxS( "VIEW::Redraw(): %.1f ms" ), totalRealTime.msecs() );
+    wxLogTrace( traceGalProfile, wxS( "VIEW::Redraw(): %.1f ms at scale %g" ),
+                totalRealTime.msecs(), m_scale );
 #endif /* KICAD_GAL_PROFILE */
 }
 
@@ -1217,6 +1279,12 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
+    if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
+    {
+        aItem->viewPrivData()->m_detailMinScale = 0.0;
+        aItem->viewPrivData()->m_detailMaxScale = std::numeric_limits<double>::max();
+    }
+
     // Iterate through layers used by the item and recache it immediately
     for( int i = 0; i < layers_count; ++i )
     {
@@ -1295,10 +1363,17 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
     group = m_gal->BeginGroup();
     viewData->setGroup( aLayer, group );
 
+    m_painter->ResetDetailRange();
+
     if( !m_painter->Draw( static_cast<EDA_ITEM*>( aItem ), aLayer ) )
         aItem->ViewDraw( aLayer, this ); // Alternative drawing method
 
     m_gal->EndGroup();
+
+    viewData->m_detailMinScale = std::max( viewData->m_detailMinScale,
+                                           m_painter->GetDetailMinScale() );
+    viewData->m_detailMaxScale = std::min( viewData->m_detailMaxScale,
+                                           m_painter->GetDetailMaxScale() );
 }
 
 
@@ -1400,30 +1475,19 @@ void VIEW::UpdateItems()
     if( !m_gal->IsVisible() || !m_gal->IsInitialized() )
         return;
 
+    PROF_TIMER   timer;
     unsigned int cntGeomUpdate = 0;
-    bool         anyUpdated = false;
+    unsigned int cntQueued = m_updateQueue.size();
 
-    for( VIEW_ITEM* item : *m_allItems )
+    for( VIEW_ITEM* item : m_updateQueue )
     {
-        auto vpd = item->viewPrivData();
-
-        if( !vpd )
-            continue;
-
-        if( vpd->m_requiredUpdate != NONE )
-        {
-            anyUpdated = true;
-
-            if( vpd->m_requiredUpdate & ( GEOMETRY | LAYERS ) )
-            {
-                cntGeomUpdate++;
-            }
-        }
+        if( item->viewPrivData()->m_requiredUpdate & ( GEOMETRY | LAYERS ) )
+            cntGeomUpdate++;
     }
 
     unsigned int cntTotal = m_allItems->size();
 
-    double ratio = (double) cntGeomUpdate / (double) cntTotal;
+    double ratio = cntTotal ? (double) cntGeomUpdate / (double) cntTotal : 0.0;
 
     // Optimization to improve view update time. If a lot of items (say, 30%) have their
     // bboxes/geometry changed it's way faster (around 10 times) to rebuild the R-Trees
@@ -1433,16 +1497,19 @@ void VIEW::UpdateItems()
 
     if( ratio > 0.3 )
     {
-        auto allItems = *m_allItems;
-        int  layers[VIEW_MAX_LAYERS], layers_count;
+        typedef std::vector<std::pair<VIEW_RTREE::Rect, VIEW_ITEM*>> LAYER_ENTRIES;
 
-        // kill all Rtrees
-        for( VIEW_LAYER& layer : m_layers )
-            layer.items->RemoveAll();
+        std::vector<LAYER_ENTRIES> layerItems( m_layers.size() );
+        int                        layers[VIEW_MAX_LAYERS], layers_count;
 
-        // and re-insert items from scratch
-        for( VIEW_ITEM* item : allItems )
+        // Bounding boxes are gathered here rather than by the tree builders, as items cache
+        // them without any locking
+        for( VIEW_ITEM* item : *m_allItems )
         {
+            const BOX2I      bbox = item->ViewBBox();
+            VIEW_RTREE::Rect rect = { { bbox.GetX(), bbox.GetY() },
+                                      { bbox.GetRight(), bbox.GetBottom() } };
+
             item->ViewGetLayers( layers, layers_count );
             item->viewPrivData()->saveLayers( layers, layers_count );
 
@@ -1450,41 +1517,91 @@ void VIEW::UpdateItems()
             {
                 wxCHECK2_MSG( layers[i] >= 0 && static_cast<unsigned>( layers[i] ) < m_layers.size(),
                         continue, wxS( "Invalid layer" ) );
-                VIEW_LAYER& l = m_layers[layers[i]];
-                l.items->Insert( item );
-                MarkTargetDirty( l.target );
+                layerItems[layers[i]].emplace_back( rect, item );
             }
 
             item->viewPrivData()->m_requiredUpdate &= ~( LAYERS | GEOMETRY );
         }
+
+        // Rebuild the R-Trees from scratch, packing each layer in one pass.  Layers are
+        // independent so they are built in parallel.
+        thread_pool& tp = GetKiCadThreadPool();
+
+        auto futures = tp.parallelize_loop( m_layers.size(),
+                [&]( const int a, const int b )
+                {
+                    for( int ii = a; ii < b; ++ii )
+                        m_layers[ii].items->BulkLoad( layerItems[ii] );
+                } );
+
+        // Wait for this loop only; other users of the pool may have tasks queued.
+        futures.wait();
+
+        for( size_t ii = 0; ii < m_layers.size(); ++ii )
+        {
+            if( !layerItems[ii].empty() )
+                MarkTargetDirty( m_layers[ii].target );
+        }
     }
 
-    if( anyUpdated )
+    if( !m_updateQueue.empty() )
     {
+        const int               redrawFlags = INITIAL_ADD | GEOMETRY | LAYERS | REPAINT;
+        std::vector<VIEW_ITEM*> toPrepare;
+
+        for( VIEW_ITEM* item : m_updateQueue )
+        {
+            if( item->viewPrivData()->m_requiredUpdate & redrawFlags )
+                toPrepare.push_back( item );
+        }
+
+        // Let the painter tessellate the items to be redrawn on the thread pool; only uploading
+        // the result through the GAL has to happen on this thread.  Not worth it for a handful
+        // of items, such as the ones being edited.
+        if( m_painter && toPrepare.size() > 64 )
+        {
+            thread_pool& tp = GetKiCadThreadPool();
+
+            auto futures = tp.parallelize_loop( toPrepare.size(),
+                    [&]( const int a, const int b )
+                    {
+                        for( int ii = a; ii < b; ++ii )
+                            m_painter->PrepareDraw( toPrepare[ii] );
+                    } );
+
+            futures.wait();
+        }
+
         GAL_UPDATE_CONTEXT ctx( m_gal );
 
-        for( VIEW_ITEM* item : *m_allItems.get() )
+        // Indexed, as drawing an item may queue further updates
+        for( size_t i = 0; i < m_updateQueue.size(); ++i )
         {
-            if( item->viewPrivData() && item->viewPrivData()->m_requiredUpdate != NONE )
+            VIEW_ITEM*      item = m_updateQueue[i];
+            VIEW_ITEM_DATA* vpd = item->viewPrivData();
+
+            vpd->m_queuedForUpdate = false;
+
+            if( vpd->m_requiredUpdate != NONE )
             {
-                invalidateItem( item, item->viewPrivData()->m_requiredUpdate );
-                item->viewPrivData()->m_requiredUpdate = NONE;
+                invalidateItem( item, vpd->m_requiredUpdate );
+                vpd->m_requiredUpdate = NONE;
             }
         }
+
+        m_updateQueue.clear();
     }
 
-    KI_TRACE( traceGalProfile, wxS( "View update: total items %u, geom %u anyUpdated %u\n" ), cntTotal,
-              cntGeomUpdate, (unsigned) anyUpdated );
+    KI_TRACE( traceGalProfile,
+              wxS( "View update: total items %u, queued %u, geom %u, %.3f ms\n" ), cntTotal,
+              cntQueued, cntGeomUpdate, timer.msecs() );
 }
 
 
 void VIEW::UpdateAllItems( int aUpdateFlags )
 {
     for( VIEW_ITEM* item : *m_allItems )
-    {
-        if( item->viewPrivData() )
-            item->viewPrivData()->m_requiredUpdate |= aUpdateFlags;
-    }
+        Update( item, aUpdateFlags );
 }
 
 
@@ -1494,10 +1611,7 @@ void VIEW::UpdateAllItemsConditionally( int aUpdateFlags,
     for( VIEW_ITEM* item : *m_allItems )
     {
         if( aCondition( item ) )
-        {
-            if( item->viewPrivData() )
-                item->viewPrivData()->m_requiredUpdate |= aUpdateFlags;
-        }
+            Update( item, aUpdateFlags );
     }
 }
 
@@ -1506,8 +1620,8 @@ void VIEW::UpdateAllItemsConditionally( std::function<int( VIEW_ITEM* )> aItemFl
 {
     for( VIEW_ITEM* item : *m_allItems )
     {
-        if( item->viewPrivData() )
-            item->viewPrivData()->m_requiredUpdate |= aItemFlagsProvider( item );
+        if( int flags = aItemFlagsProvider( item ) )
+            Update( item, flags );
     }
 }
 
@@ -1595,6 +1709,14 @@ void VIEW::Update( const VIEW_ITEM* aItem, int aUpdateFlags ) const
     assert( aUpdateFlags != NONE );
 
     viewData->m_requiredUpdate |= aUpdateFlags;
+
+    // Only the view owning the item processes its updates; items not added to a view yet are
+    // queued by VIEW::Add()
+    if( !viewData->m_queuedForUpdate && viewData->m_view )
+    {
+        viewData->m_view->m_updateQueue.push_back( const_cast<VIEW_ITEM*>( aItem ) );
+        viewData->m_queuedForUpdate = true;
+    }
 }
 
 
@@ -20,6 +20,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
 #include <list>
 #include <future>
 #include <vector>
@@ -607,6 +608,25 @@ void CONNECTION_GRAPH::Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnco
         // (useful in complex hierarchies)
         std::vector<std::pair<SCH_SYMBOL*, int>> symbolsChanged;
 
+        // For incremental updates, sheets without any dirty item contribute nothing to the new
+        // graph and their dangling state cannot have changed, so leave them alone entirely.
+        if( !aUnconditional )
+        {
+            bool sheetDirty = false;
+
+            for( SCH_ITEM* item : sheet.LastScreen()->Items() )
+            {
+                if( item->IsConnectable() && item->IsConnectivityDirty() )
+                {
+                    sheetDirty = true;
+                    break;
+                }
+            }
+
+            if( !sheetDirty )
+                continue;
+        }
+
         for( SCH_ITEM* item : sheet.LastScreen()->Items() )
         {
             if( item->IsConnectable() && ( aUnconditional || item->IsConnectivityDirty() ) )
@@ -714,10 +734,15 @@ std::set<std::pair<SCH_SHEET_PATH, SCH_ITEM*>> CONNECTION_GRAPH::ExtractAffected
             for( CONNECTION_SUBGRAPH* bus_sg : bus_it.second )
                 traverse_subgraph( bus_sg );
         }
-
-        alg::delete_matching( m_items, item );
     }
 
+    // Drop all the affected items in a single pass rather than one search per item
+    alg::delete_if( m_items,
+                    [&aItems]( SCH_ITEM* aItem )
+                    {
+                        return aItems.count( aItem ) > 0;
+                    } );
+
     removeSubgraphs( subgraphs );
 
     return retvals;
@@ -726,130 +751,110 @@ std::set<std::pair<SCH_SHEET_PATH, SCH_ITEM*>> CONNECTION_GRAPH::ExtractAffected
 
 void CONNECTION_GRAPH::removeSubgraphs( std::set<CONNECTION_SUBGRAPH*>& aSubgraphs )
 {
-    std::sort( m_driver_subgraphs.begin(), m_driver_subgraphs.end() );
-    std::sort( m_subgraphs.begin(), m_subgraphs.end() );
+    if( aSubgraphs.empty() )
+        return;
+
     std::set<int> codes_to_remove;
 
-    for( auto el : m_sheet_to_subgraphs_map )
-    {
-        std::sort( el.second.begin(), el.second.end() );
-    }
+    auto isRemoved =
+            [&aSubgraphs]( const CONNECTION_SUBGRAPH* aSubgraph ) -> bool
+            {
+                return aSubgraphs.count( const_cast<CONNECTION_SUBGRAPH*>( aSubgraph ) ) > 0;
+            };
 
     for( CONNECTION_SUBGRAPH* sg : aSubgraphs )
     {
-        for( auto it : sg->m_bus_neighbors )
+        for( auto& [ conn, neighbors ] : sg->m_bus_neighbors )
         {
-            for( CONNECTION_SUBGRAPH* neighbor : it.second )
+            for( CONNECTION_SUBGRAPH* neighbor : neighbors )
             {
-                auto& parents = neighbor->m_bus_parents[it.first];
-
-                for( auto test = parents.begin(); test != parents.end(); )
-                {
-                    if( *test == sg )
-                        test = parents.erase( test );
-                    else
-                        ++test;
-                }
+                auto parents_it = neighbor->m_bus_parents.find( conn );
 
-                if( parents.empty() )
-                    neighbor->m_bus_parents.erase( it.first );
-            }
-        }
-
-        for( auto it : sg->m_bus_parents )
-        {
-            for( CONNECTION_SUBGRAPH* parent : it.second )
-            {
-                auto& neighbors = parent->m_bus_neighbors[it.first];
+                if( parents_it == neighbor->m_bus_parents.end() )
+                    continue;
 
-                for( auto test = neighbors.begin(); test != neighbors.end(); )
-                {
-                    if( *test == sg )
-                        test = neighbors.erase( test );
-                    else
-                        ++test;
-                }
+                parents_it->second.erase( sg );
 
-                if( neighbors.empty() )
-                    parent->m_bus_neighbors.erase( it.first );
+                if( parents_it->second.empty() )
+                    neighbor->m_bus_parents.erase( parents_it );
             }
         }
 
+        for( auto& [ conn, parents ] : sg->m_bus_parents )
         {
-            auto it = std::lower_bound( m_driver_subgraphs.begin(), m_driver_subgraphs.end(), sg );
+            for( CONNECTION_SUBGRAPH* parent : parents )
+            {
+                auto neighbors_it = parent->m_bus_neighbors.find( conn );
 
-            while( it != m_driver_subgraphs.end() && *it == sg )
-                it = m_driver_subgraphs.erase( it );
-        }
+                if( neighbors_it == parent->m_bus_neighbors.end() )
+                    continue;
 
-        {
-            auto it = std::lower_bound( m_subgraphs.begin(), m_subgraphs.end(), sg );
+                neighbors_it->second.erase( sg );
 
-            while( it != m_subgraphs.end() && *it == sg )
-                it = m_subgraphs.erase( it );
+                if( neighbors_it->second.empty() )
+                    parent->m_bus_neighbors.erase( neighbors_it );
+            }
         }
+    }
 
-        for( auto el : m_sheet_to_subgraphs_map )
-        {
-            auto it = std::lower_bound( el.second.begin(), el.second.end(), sg );
+    // Each structure below is swept exactly once, testing membership in aSubgraphs, rather than
+    // once per removed subgraph.  Incremental updates on large designs remove many subgraphs at
+    // a time, and the per-subgraph sweeps made the update cost proportional to the whole design.
+    alg::delete_if( m_driver_subgraphs, isRemoved );
+    alg::delete_if( m_subgraphs, isRemoved );
 
-            while( it != el.second.end() && *it == sg )
-                it = el.second.erase( it );
-        }
+    for( auto& [ path, subgraphs ] : m_sheet_to_subgraphs_map )
+        alg::delete_if( subgraphs, isRemoved );
 
-        auto remove_sg = [sg]( auto it ) -> bool
-                        {
-                            for( const CONNECTION_SUBGRAPH* test_sg : it->second )
-                            {
-                                if( sg == test_sg )
-                                    return true;
-                            }
+    auto containsRemoved =
+            [&isRemoved]( const auto& aSubgraphList ) -> bool
+            {
+                return std::any_of( aSubgraphList.begin(), aSubgraphList.end(), isRemoved );
+            };
 
-                            return false;
-                        };
+    for( auto it = m_global_label_cache.begin(); it != m_global_label_cache.end(); )
+    {
+        if( containsRemoved( it->second ) )
+            it = m_global_label_cache.erase( it );
+        else
+            ++it;
+    }
 
-        for( auto it = m_global_label_cache.begin(); it != m_global_label_cache.end(); )
-        {
-            if( remove_sg( it ) )
-                it = m_global_label_cache.erase( it );
-            else
-                ++it;
-        }
+    for( auto it = m_local_label_cache.begin(); it != m_local_label_cache.end(); )
+    {
+        if( containsRemoved( it->second ) )
+            it = m_local_label_cache.erase( it );
+        else
+            ++it;
+    }
 
-        for( auto it = m_local_label_cache.begin(); it != m_local_label_cache.end(); )
+    for( auto it = m_net_code_to_subgraphs_map.begin(); it != m_net_code_to_subgraphs_map.end(); )
+    {
+        if( containsRemoved( it->second ) )
         {
-            if( remove_sg( it ) )
-                it = m_local_label_cache.erase( it );
-            else
-                ++it;
+            codes_to_remove.insert( it->first.Netcode );
+            it = m_net_code_to_subgraphs_map.erase( it );
         }
-
-        for( auto it = m_net_code_to_subgraphs_map.begin(); it != m_net_code_to_subgraphs_map.end(); )
+        else
         {
-            if( remove_sg( it ) )
-            {
-                codes_to_remove.insert( it->first.Netcode );
-                it = m_net_code_to_subgraphs_map.erase( it );
-            }
-            else
-                ++it;
+            ++it;
         }
+    }
 
-        for( auto it = m_net_name_to_subgraphs_map.begin(); it != m_net_name_to_subgraphs_map.end(); )
-        {
-            if( remove_sg( it ) )
-                it = m_net_name_to_subgraphs_map.erase( it );
-            else
-                ++it;
-        }
+    for( auto it = m_net_name_to_subgraphs_map.begin(); it != m_net_name_to_subgraphs_map.end(); )
+    {
+        if( containsRemoved( it->second ) )
+            it = m_net_name_to_subgraphs_map.erase( it );
+        else
+            ++it;
+    }
 
-        for( auto it = m_item_to_subgraph_map.begin(); it != m_item_to_subgraph_map.end(); )
-        {
-            if( it->second == sg )
-                it = m_item_to_subgraph_map.erase( it );
-            else
-                ++it;
-        }
+    for( auto it = m_item_to_subgraph_map.begin(); it != m_item_to_subgraph_map.end(); )
+    {
+        if( isRemoved( it->second ) )
+            it = m_item_to_subgraph_map.erase( it );
+        else
+            ++it;
     }
 
     for( auto it = m_net_name_to_code_map.begin(); it != m_net_name_to_code_map.end(); )
@@ -2763,17 +2768,34 @@ CONNECTION_SUBGRAPH* CONNECTION_GRAPH::GetSubgraphForItem( SCH_ITEM* aItem )
 }
 
 
-int CONNECTION_GRAPH::RunERC()
+/**
+ * While RunERC() is dispatching subgraph checks to the thread pool, each worker collects the
+ * markers it creates here instead of appending them to the (non thread-safe) screens.
+ */
+static thread_local std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>>* s_pendingErcMarkers = nullptr;
+
+
+void CONNECTION_GRAPH::addErcMarker( SCH_SCREEN* aScreen, SCH_MARKER* aMarker )
 {
-    int error_count = 0;
+    if( s_pendingErcMarkers )
+        s_pendingErcMarkers->emplace_back( aScreen, aMarker );
+    else
+        aScreen->Append( aMarker );
+}
 
+
+int CONNECTION_GRAPH::RunERC()
+{
     wxCHECK_MSG( m_schematic, true, wxS( "Null m_schematic in CONNECTION_GRAPH::RunERC" ) );
 
     ERC_SETTINGS& settings = m_schematic->ErcSettings();
 
+    m_ercTimings.clear();
+
     // We don't want to run many ERC checks more than once on a given screen even though it may
     // represent multiple sheets with multiple subgraphs.  We can tell these apart by drivers.
-    std::set<SCH_ITEM*> seenDriverInstances;
+    std::set<SCH_ITEM*>               seenDriverInstances;
+    std::vector<CONNECTION_SUBGRAPH*> ercSubgraphs;
 
     for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
     {
@@ -2792,78 +2814,149 @@ int CONNECTION_GRAPH::RunERC()
         if( subgraph->m_driver )
             seenDriverInstances.insert( subgraph->m_driver );
 
-        /**
-         * NOTE:
-         *
-         * We could check that labels attached to bus subgraphs follow the
-         * proper format (i.e. actually define a bus).
-         *
-         * This check doesn't need to be here right now because labels
-         * won't actually be connected to bus wires if they aren't in the right
-         * format due to their TestDanglingEnds() implementation.
-         */
-        if( settings.IsTestEnabled( ERCE_DRIVER_CONFLICT ) )
-        {
-            if( !ercCheckMultipleDrivers( subgraph ) )
-                error_count++;
-        }
+        ercSubgraphs.push_back( subgraph );
+    }
 
-        subgraph->ResolveDrivers( false );
+    enum ERC_CHECK
+    {
+        CHECK_MULTIPLE_DRIVERS,
+        CHECK_BUS_TO_NET,
+        CHECK_BUS_ENTRY,
+        CHECK_BUS_TO_BUS,
+        CHECK_FLOATING_WIRES,
+        CHECK_NO_CONNECTS,
+        CHECK_LABELS,
+        CHECK_COUNT
+    };
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT ) )
-        {
-            if( !ercCheckBusToNetConflicts( subgraph ) )
-                error_count++;
-        }
+    static const wxChar* checkNames[CHECK_COUNT] = { wxT( "multiple_drivers" ),
+                                                      wxT( "bus_to_net_conflicts" ),
+                                                      wxT( "bus_entry_conflicts" ),
+                                                      wxT( "bus_to_bus_conflicts" ),
+                                                      wxT( "floating_wires" ),
+                                                      wxT( "no_connects" ),
+                                                      wxT( "labels" ) };
+
+    bool enabled[CHECK_COUNT];
+
+    enabled[CHECK_MULTIPLE_DRIVERS] = settings.IsTestEnabled( ERCE_DRIVER_CONFLICT );
+    enabled[CHECK_BUS_TO_NET]       = settings.IsTestEnabled( ERCE_BUS_TO_NET_CONFLICT );
+    enabled[CHECK_BUS_ENTRY]        = settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT );
+    enabled[CHECK_BUS_TO_BUS]       = settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT );
+    enabled[CHECK_FLOATING_WIRES]   = settings.IsTestEnabled( ERCE_WIRE_DANGLING );
+    enabled[CHECK_NO_CONNECTS]      = settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED )
+                                        || settings.IsTestEnabled( ERCE_NOCONNECT_NOT_CONNECTED )
+                                        || settings.IsTestEnabled( ERCE_PIN_NOT_CONNECTED );
+    enabled[CHECK_LABELS]           = settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
+                                        || settings.IsTestEnabled( ERCE_GLOBLABEL );
+
+    typedef bool ( CONNECTION_GRAPH::*ERC_CHECK_FN )( const CONNECTION_SUBGRAPH* );
+
+    static const ERC_CHECK_FN checkFns[CHECK_COUNT] = {
+        &CONNECTION_GRAPH::ercCheckMultipleDrivers,
+        &CONNECTION_GRAPH::ercCheckBusToNetConflicts,
+        &CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts,
+        &CONNECTION_GRAPH::ercCheckBusToBusConflicts,
+        &CONNECTION_GRAPH::ercCheckFloatingWires,
+        &CONNECTION_GRAPH::ercCheckNoConnects,
+        &CONNECTION_GRAPH::ercCheckLabels
+    };
 
-        if( settings.IsTestEnabled( ERCE_BUS_ENTRY_CONFLICT ) )
-        {
-            if( !ercCheckBusToBusEntryConflicts( subgraph ) )
-                error_count++;
-        }
+    // Accumulated per-check worker time in nanoseconds
+    std::atomic<int64_t> checkTimes[CHECK_COUNT];
+    std::atomic<int>     errorCount( 0 );
 
-        if( settings.IsTestEnabled( ERCE_BUS_TO_BUS_CONFLICT ) )
-        {
-            if( !ercCheckBusToBusConflicts( subgraph ) )
-                error_count++;
-        }
+    for( std::atomic<int64_t>& time : checkTimes )
+        time.store( 0 );
 
-        if( settings.IsTestEnabled( ERCE_WIRE_DANGLING ) )
-        {
-            if( !ercCheckFloatingWires( subgraph ) )
-                error_count++;
-        }
+    // Markers are collected per subgraph and merged afterwards in subgraph order so that the
+    // result does not depend on how the work was split across threads.
+    std::vector<std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>>> pendingMarkers;
+    pendingMarkers.resize( ercSubgraphs.size() );
 
-        if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_NOCONNECT_NOT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_PIN_NOT_CONNECTED ) )
-        {
-            if( !ercCheckNoConnects( subgraph ) )
-                error_count++;
-        }
+    auto runChecks =
+            [&]( size_t aIdx, ERC_CHECK aFirst, ERC_CHECK aLast )
+            {
+                CONNECTION_SUBGRAPH* subgraph = ercSubgraphs[aIdx];
 
-        if( settings.IsTestEnabled( ERCE_LABEL_NOT_CONNECTED )
-                || settings.IsTestEnabled( ERCE_GLOBLABEL ) )
-        {
-            if( !ercCheckLabels( subgraph ) )
-                error_count++;
-        }
+                s_pendingErcMarkers = &pendingMarkers[aIdx];
+
+                for( int check = aFirst; check <= aLast; ++check )
+                {
+                    if( !enabled[check] )
+                        continue;
+
+                    PROF_TIMER timer;
+
+                    if( !( this->*checkFns[check] )( subgraph ) )
+                        errorCount++;
+
+                    timer.Stop();
+                    checkTimes[check] += timer.SinceStart<std::chrono::nanoseconds>().count();
+                }
+
+                s_pendingErcMarkers = nullptr;
+            };
+
+    thread_pool& tp = GetKiCadThreadPool();
+
+    // The multiple drivers check needs the drivers as they were captured during the graph build,
+    // so it runs before the drivers are re-resolved.  ResolveDrivers() only touches its own
+    // subgraph, but the remaining checks also read neighboring subgraphs so they must wait until
+    // every subgraph has been resolved.
+    tp.push_loop( ercSubgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                {
+                    runChecks( ii, CHECK_MULTIPLE_DRIVERS, CHECK_MULTIPLE_DRIVERS );
+                    ercSubgraphs[ii]->ResolveDrivers( false );
+                }
+            } );
+    tp.wait_for_tasks();
+
+    tp.push_loop( ercSubgraphs.size(),
+            [&]( const int a, const int b )
+            {
+                for( int ii = a; ii < b; ++ii )
+                    runChecks( ii, CHECK_BUS_TO_NET, CHECK_LABELS );
+            } );
+    tp.wait_for_tasks();
+
+    for( std::vector<std::pair<SCH_SCREEN*, SCH_MARKER*>>& markers : pendingMarkers )
+    {
+        for( const auto& [ screen, marker ] : markers )
+            screen->Append( marker );
+    }
+
+    for( int check = 0; check < CHECK_COUNT; ++check )
+    {
+        if( enabled[check] )
+            m_ercTimings[ checkNames[check] ] = checkTimes[check] / 1e6;
     }
 
+    int error_count = errorCount;
+
     // Hierarchical sheet checking is done at the schematic level
     if( settings.IsTestEnabled( ERCE_HIERACHICAL_LABEL )
             || settings.IsTestEnabled( ERCE_PIN_NOT_CONNECTED ) )
     {
+        PROF_TIMER timer;
         error_count += ercCheckHierSheets();
+        m_ercTimings[ wxT( "hier_sheets" ) ] = timer.msecs();
     }
 
     if( settings.IsTestEnabled( ERCE_NETCLASS_CONFLICT ) )
     {
+        PROF_TIMER timer;
+
         for( const auto& [ netname, subgraphs ] : m_net_name_to_subgraphs_map )
         {
             if( !ercCheckNetclassConflicts( subgraphs ) )
                 error_count++;
         }
+
+        m_ercTimings[ wxT( "netclass_conflicts" ) ] = timer.msecs();
     }
 
     return error_count;
@@ -2902,7 +2995,7 @@ bool CONNECTION_GRAPH::ercCheckMultipleDrivers( const CONNECTION_SUBGRAPH* aSubg
                 ercItem->SetErrorMessage( msg );
 
                 SCH_MARKER* marker = new SCH_MARKER( ercItem, driver->GetPosition() );
-                aSubgraph->m_sheet.LastScreen()->Append( marker );
+                addErcMarker( aSubgraph->m_sheet.LastScreen(), marker );
 
                 return false;
             }
@@ -2999,7 +3092,7 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
         ercItem->SetItems( net_item, bus_item );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, net_item->GetPosition() );
-        screen->Append( marker );
+        addErcMarker( screen, marker );
 
         return false;
     }
@@ -3066,7 +3159,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
             ercItem->SetItems( label, port );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, label->GetPosition() );
-            screen->Append( marker );
+            addErcMarker( screen, marker );
 
             return false;
         }
@@ -3170,7 +3263,7 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
         ercItem->SetErrorMessage( msg );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, bus_entry->GetPosition() );
-        screen->Append( marker );
+        addErcMarker( screen, marker );
 
         return false;
     }
@@ -3267,7 +3360,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             }
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pos );
-            screen->Append( marker );
+            addErcMarker( screen, marker );
 
             ok = false;
         }
@@ -3278,7 +3371,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( aSubgraph->m_no_connect );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aSubgraph->m_no_connect->GetPosition() );
-            screen->Append( marker );
+            addErcMarker( screen, marker );
 
             ok = false;
         }
@@ -3367,7 +3460,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
             ercItem->SetItems( pin );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, pin->GetTransformedPosition() );
-            screen->Append( marker );
+            addErcMarker( screen, marker );
 
             ok = false;
         }
@@ -3391,7 +3484,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph
 
                     SCH_MARKER* marker = new SCH_MARKER( ercItem,
                                                          testPin->GetTransformedPosition() );
-                    screen->Append( marker );
+                    addErcMarker( screen, marker );
 
                     ok = false;
                 }
@@ -3432,7 +3525,7 @@ bool CONNECTION_GRAPH::ercCheckFloatingWires( const CONNECTION_SUBGRAPH* aSubgra
                            wires.size() > 3 ? wires[3] : nullptr );
 
         SCH_MARKER* marker = new SCH_MARKER( ercItem, wires[0]->GetPosition() );
-        screen->Append( marker );
+        addErcMarker( screen, marker );
 
         return false;
     }
@@ -3482,7 +3575,7 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph )
             ercItem->SetItems( aText );
 
             SCH_MARKER* marker = new SCH_MARKER( ercItem, aText->GetPosition() );
-            aSubgraph->m_sheet.LastScreen()->Append( marker );
+            addErcMarker( aSubgraph->m_sheet.LastScreen(), marker );
         }
     };
 
@@ -22,6 +22,7 @@
 #ifndef _CONNECTION_GRAPH_H
 #define _CONNECTION_GRAPH_H
 
+#include <map>
 #include <mutex>
 #include <vector>
 
@@ -40,7 +41,9 @@ class CONNECTION_GRAPH;
 class SCHEMATIC;
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
+class SCH_MARKER;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -317,7 +320,9 @@ public:
      * Updates the connection graph for the given list of sheets.
      *
      * @param aSheetList is the list of possibly modified sheets
-     * @param aUnconditional is true if an unconditional full recalculation should be done
+     * @param aUnconditional is true if an unconditional full recalculation should be done.
+     *                       Otherwise only items flagged as connectivity-dirty are added, and
+     *                       sheets without any dirty items are skipped.
      * @param aChangedItemHandler an optional handler to receive any changed items
      */
     void Recalculate( const SCH_SHEET_LIST& aSheetList, bool aUnconditional = false,
@@ -345,10 +350,19 @@ public:
      *
      * Precondition: graph is up-to-date
      *
+     * Subgraph-local checks are run in parallel; the resulting markers are added to the screens
+     * in the same order as a serial run would produce.
+     *
      * @return the number of errors found
      */
     int RunERC();
 
+    /**
+     * @return the time spent in each check family during the last RunERC(), in milliseconds.
+     *         Subgraph-local checks report the sum of the time spent on all worker threads.
+     */
+    const std::map<wxString, double>& GetERCTimings() const { return m_ercTimings; }
+
     const NET_MAP& GetNetMap() const { return m_net_code_to_subgraphs_map; }
 
     /**
@@ -633,6 +647,11 @@ private:
      */
     size_t hasPins( const CONNECTION_SUBGRAPH* aLocSubgraph );
 
+    /**
+     * Add an ERC marker to a screen, or queue it if called from a RunERC() worker thread.
+     */
+    void addErcMarker( SCH_SCREEN* aScreen, SCH_MARKER* aMarker );
+
 
 private:
     // All the sheets in the schematic (as long as we don't have partial updates)
@@ -676,6 +695,8 @@ private:
     int m_last_subgraph_code;
 
     SCHEMATIC* m_schematic;     ///< The schematic this graph represents
+
+    std::map<wxString, double> m_ercTimings;
 };
 
 #endif
@@ -40,6 +40,7 @@
 #include <dialogs/panel_sym_lib_table.h>
 #include <kiway.h>
 #include <settings/settings_manager.h>
+#include <startup_trace.h>
 #include <symbol_editor_settings.h>
 #include <sexpr/sexpr.h>
 #include <sexpr/sexpr_parser.h>
@@ -379,6 +380,8 @@ bool IFACE::loadGlobalLibTable()
             // The global table is not related to a specific project.  All projects
             // will use the same global table.  So the KIFACE::OnKifaceStart() contract
             // of avoiding anything project specific is not violated here.
+            SCOPED_STARTUP_TRACE( "SYMBOL_LIB_TABLE::LoadGlobalTable", "libraries" );
+
             if( !SYMBOL_LIB_TABLE::LoadGlobalTable( SYMBOL_LIB_TABLE::GetGlobalLibTable() ) )
                 return false;
         }
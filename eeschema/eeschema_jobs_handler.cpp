@@ -27,6 +27,7 @@
 #include <jobs/job_export_sch_plot.h>
 #include <jobs/job_sym_export_svg.h>
 #include <jobs/job_sym_upgrade.h>
+#include <jobs/job_sch_erc.h>
 #include <schematic.h>
 #include <wx/crt.h>
 #include <wx/dir.h>
@@ -37,6 +38,14 @@
 #include <sch_painter.h>
 #include <locale_io.h>
 #include <erc.h>
+#include <erc_item.h>
+#include <sch_marker.h>
+#include <build_version.h>
+#include <profile.h>
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iomanip>
+#include <ignore.h>
 #include <wildcards_and_files_ext.h>
 #include <plotters/plotters_pslike.h>
 #include <drawing_sheet/ds_data_model.h>
@@ -68,6 +77,8 @@ EESCHEMA_JOBS_HANDLER::EESCHEMA_JOBS_HANDLER()
               std::bind( &EESCHEMA_JOBS_HANDLER::JobSymUpgrade, this, std::placeholders::_1 ) );
     Register( "symsvg",
               std::bind( &EESCHEMA_JOBS_HANDLER::JobSymExportSvg, this, std::placeholders::_1 ) );
+    Register( "erc",
+              std::bind( &EESCHEMA_JOBS_HANDLER::JobSchErc, this, std::placeholders::_1 ) );
 }
 
 
@@ -481,6 +492,182 @@ int EESCHEMA_JOBS_HANDLER::JobSymExportSvg( JOB* aJob )
 }
 
 
+int EESCHEMA_JOBS_HANDLER::JobSchErc( JOB* aJob )
+{
+    JOB_SCH_ERC* ercJob = dynamic_cast<JOB_SCH_ERC*>( aJob );
+
+    if( !ercJob )
+        return CLI::EXIT_CODES::ERR_UNKNOWN;
+
+    PROF_TIMER loadTimer;
+    SCHEMATIC* sch = EESCHEMA_HELPERS::LoadSchematic( ercJob->m_filename, SCH_IO_MGR::SCH_KICAD );
+    loadTimer.Stop();
+
+    if( sch == nullptr )
+    {
+        wxFprintf( stderr, _( "Failed to load schematic file\n" ) );
+        return CLI::EXIT_CODES::ERR_INVALID_INPUT_FILE;
+    }
+
+    if( ercJob->m_outputFile.IsEmpty() )
+    {
+        wxFileName fn = sch->GetFileName();
+        fn.SetName( fn.GetName() + wxS( "-erc" ) );
+        fn.SetExt( wxS( "json" ) );
+
+        ercJob->m_outputFile = fn.GetFullName();
+    }
+
+    ERC_SETTINGS&  settings = sch->ErcSettings();
+    ERC_TESTER     tester( sch );
+    nlohmann::json timings = nlohmann::json::object();
+
+    timings["load_and_connectivity"] = loadTimer.msecs();
+
+    // The connection graph was computed by LoadSchematic(); everything below only reads it
+    auto runTimed =
+            [&]( const char* aName, const std::function<void()>& aTest )
+            {
+                PROF_TIMER timer;
+                aTest();
+                timings[aName] = timer.msecs();
+            };
+
+    if( settings.IsTestEnabled( ERCE_DUPLICATE_SHEET_NAME ) )
+        runTimed( "duplicate_sheet_names", [&]() { tester.TestDuplicateSheetNames( true ); } );
+
+    if( settings.IsTestEnabled( ERCE_BUS_ALIAS_CONFLICT ) )
+        runTimed( "bus_alias_conflicts", [&]() { tester.TestConflictingBusAliases(); } );
+
+    runTimed( "connection_graph", [&]() { sch->ConnectionGraph()->RunERC(); } );
+
+    for( const auto& [ checkName, msecs ] : sch->ConnectionGraph()->GetERCTimings() )
+        timings["connection_graph_checks"][ checkName.ToStdString() ] = msecs;
+
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_FP ) )
+        runTimed( "multiunit_footprints", [&]() { tester.TestMultiunitFootprints(); } );
+
+    if( settings.IsTestEnabled( ERCE_MISSING_UNIT )
+            || settings.IsTestEnabled( ERCE_MISSING_INPUT_PIN )
+            || settings.IsTestEnabled( ERCE_MISSING_POWER_INPUT_PIN )
+            || settings.IsTestEnabled( ERCE_MISSING_BIDI_PIN ) )
+    {
+        runTimed( "missing_units", [&]() { tester.TestMissingUnits(); } );
+    }
+
+    if( settings.IsTestEnabled( ERCE_DIFFERENT_UNIT_NET ) )
+        runTimed( "multiunit_pin_conflicts", [&]() { tester.TestMultUnitPinConflicts(); } );
+
+    if( settings.IsTestEnabled( ERCE_PIN_TO_PIN_ERROR )
+            || settings.IsTestEnabled( ERCE_POWERPIN_NOT_DRIVEN )
+            || settings.IsTestEnabled( ERCE_PIN_NOT_DRIVEN ) )
+    {
+        runTimed( "pin_to_pin", [&]() { tester.TestPinToPin(); } );
+    }
+
+    if( settings.IsTestEnabled( ERCE_SIMILAR_LABELS ) )
+        runTimed( "similar_labels", [&]() { tester.TestSimilarLabels(); } );
+
+    // There is no drawing sheet proxy without a canvas, so only the schematic text is checked
+    if( settings.IsTestEnabled( ERCE_UNRESOLVED_VARIABLE ) )
+        runTimed( "text_vars", [&]() { tester.TestTextVars( nullptr ); } );
+
+    if( settings.IsTestEnabled( ERCE_SIMULATION_MODEL ) )
+        runTimed( "sim_models", [&]() { tester.TestSimModelIssues(); } );
+
+    if( settings.IsTestEnabled( ERCE_NOCONNECT_CONNECTED ) )
+        runTimed( "no_connect_pins", [&]() { tester.TestNoConnectPins(); } );
+
+    if( settings.IsTestEnabled( ERCE_LIB_SYMBOL_ISSUES ) )
+        runTimed( "lib_symbol_issues", [&]() { tester.TestLibSymbolIssues(); } );
+
+    if( settings.IsTestEnabled( ERCE_ENDPOINT_OFF_GRID ) )
+    {
+        runTimed( "off_grid_endpoints",
+                  [&]() { tester.TestOffGridEndpoints( schIUScale.MilsToIU( 50 ) ); } );
+    }
+
+    SCH_SHEET_LIST sheetList = sch->GetSheets();
+
+    for( SCH_MARKER* marker : sch->ResolveERCExclusions() )
+    {
+        SCH_SHEET_PATH errorPath;
+        ignore_unused( sheetList.GetItem( marker->GetRCItem()->GetMainItemID(), &errorPath ) );
+
+        if( errorPath.LastScreen() )
+            errorPath.LastScreen()->Append( marker );
+        else
+            sch->RootScreen()->Append( marker );
+    }
+
+    SHEETLIST_ERC_ITEMS_PROVIDER markerProvider( sch );
+    markerProvider.SetSeverities( RPT_SEVERITY_ERROR | RPT_SEVERITY_WARNING );
+
+    nlohmann::json violations = nlohmann::json::array();
+    int            errorCount = 0;
+
+    for( int ii = 0; ii < markerProvider.GetCount(); ++ii )
+    {
+        std::shared_ptr<ERC_ITEM> ercItem = markerProvider.GetERCItem( ii );
+        SEVERITY                  severity = settings.GetSeverity( ercItem->GetErrorCode() );
+        nlohmann::json            violation;
+
+        if( severity == RPT_SEVERITY_ERROR )
+            errorCount++;
+
+        violation["type"] = ercItem->GetSettingsKey().ToStdString();
+        violation["description"] = ercItem->GetErrorMessage().ToStdString();
+        violation["severity"] = severity == RPT_SEVERITY_ERROR ? "error" : "warning";
+
+        SCH_SHEET_PATH sheet;
+
+        if( ercItem->IsSheetSpecific() )
+            sheet = ercItem->GetSpecificSheetPath();
+        else
+            ignore_unused( sheetList.GetItem( ercItem->GetMainItemID(), &sheet ) );
+
+        violation["sheet"] = sheet.PathHumanReadable( false ).ToStdString();
+
+        if( MARKER_BASE* marker = ercItem->GetParent() )
+        {
+            violation["pos"] = { { "x", schIUScale.IUTomm( marker->GetPos().x ) },
+                                 { "y", schIUScale.IUTomm( marker->GetPos().y ) } };
+        }
+
+        nlohmann::json items = nlohmann::json::array();
+
+        for( const KIID& id : ercItem->GetIDs() )
+            items.push_back( id.AsString().ToStdString() );
+
+        violation["items"] = items;
+        violations.push_back( violation );
+    }
+
+    nlohmann::json report;
+    report["source"] = ercJob->m_filename.ToStdString();
+    report["kicad_version"] = GetMajorMinorVersion().ToStdString();
+    report["timings_ms"] = timings;
+    report["violations"] = violations;
+
+    std::ofstream out( ercJob->m_outputFile.fn_str() );
+
+    if( !out.is_open() )
+    {
+        wxFprintf( stderr, _( "Failed to create file '%s'.\n" ), ercJob->m_outputFile );
+        return CLI::EXIT_CODES::ERR_INVALID_OUTPUT_CONFLICT;
+    }
+
+    out << std::setw( 2 ) << report << std::endl;
+
+    wxPrintf( _( "Found %d violations\n" ), (int) violations.size() );
+
+    if( ercJob->m_exitCodeViolations && errorCount > 0 )
+        return CLI::EXIT_CODES::ERR_RC_VIOLATIONS;
+
+    return CLI::EXIT_CODES::OK;
+}
+
+
 int EESCHEMA_JOBS_HANDLER::JobSymUpgrade( JOB* aJob )
 {
     JOB_SYM_UPGRADE* upgradeJob = dynamic_cast<JOB_SYM_UPGRADE*>( aJob );
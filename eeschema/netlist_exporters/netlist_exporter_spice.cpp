@@ -166,6 +166,9 @@ bool NETLIST_EXPORTER_SPICE::ReadSchematicAndLibraries( unsigned aNetlistOptions
     m_referencesAlreadyFound.Clear();
     m_libParts.clear();
 
+    // Keep the models of unchanged symbols from the previous run rather than rebuilding them.
+    m_libMgr.RecycleModels();
+
     wxFileName cacheDir;
     cacheDir.AssignDir( PATHS::GetUserCachePath() );
     cacheDir.AppendDir( wxT( "ibis" ) );
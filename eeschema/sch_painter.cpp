@@ -598,6 +598,12 @@ void SCH_PAINTER::strokeText( const wxString& aText, const VECTOR2D& aPosition,
                                       aAttrs.m_Italic );
     }
 
+    if( isBelowDetailThreshold( aAttrs.m_Size.y, ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+    {
+        drawTextBar( aText, aPosition, aAttrs, font );
+        return;
+    }
+
     m_gal->SetIsFill( font->IsOutline() );
     m_gal->SetIsStroke( font->IsStroke() );
 
@@ -2056,8 +2062,13 @@ void SCH_PAINTER::draw( const SCH_TEXT* aText, int aLayer )
         {
             std::vector<std::unique_ptr<KIFONT::GLYPH>>* cache = nullptr;
 
-            if( !aText->IsHypertext() && font->IsOutline() )
+            // Text too small to read is drawn as a bar by strokeText()
+            if( !aText->IsHypertext() && font->IsOutline()
+                    && !isBelowDetailThreshold( attrs.m_Size.y,
+                                                ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+            {
                 cache = aText->GetRenderCache( font, shownText, text_offset );
+            }
 
             if( cache )
             {
@@ -2472,8 +2483,13 @@ void SCH_PAINTER::draw( const SCH_FIELD* aField, int aLayer, bool aDimmed )
         {
             std::vector<std::unique_ptr<KIFONT::GLYPH>>* cache = nullptr;
 
-            if( !aField->IsHypertext() )
+            // Text too small to read is drawn as a bar by strokeText()
+            if( !aField->IsHypertext()
+                    && !isBelowDetailThreshold( attributes.m_Size.y,
+                                                ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+            {
                 cache = aField->GetRenderCache( shownText, textpos, attributes );
+            }
 
             if( cache )
             {
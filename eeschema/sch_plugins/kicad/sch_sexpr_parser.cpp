@@ -78,7 +78,8 @@ SCH_SEXPR_PARSER::SCH_SEXPR_PARSER( LINE_READER* aLineReader, PROGRESS_REPORTER*
     m_lineReader( aLineReader ),
     m_lastProgressLine( 0 ),
     m_lineCount( aLineCount ),
-    m_rootSheet( aRootSheet )
+    m_rootSheet( aRootSheet ),
+    m_embeddedSymbolCache( nullptr )
 {
 }
 
@@ -2398,7 +2399,11 @@ void SCH_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
                 switch( token )
                 {
                 case T_symbol:
-                    symbol = ParseSymbol( symbolLibMap, m_requiredVersion );
+                    if( m_embeddedSymbolCache )
+                        symbol = parseCachedLibSymbol();
+                    else
+                        symbol = ParseSymbol( symbolLibMap, m_requiredVersion );
+
                     symbol->UpdateFieldOrdinals();
                     screen->AddLibSymbol( symbol );
                     break;
@@ -2553,6 +2558,116 @@ void SCH_SEXPR_PARSER::ParseSchematic( SCH_SHEET* aSheet, bool aIsCopyableOnly,
 }
 
 
+LIB_SYMBOL* SCH_SEXPR_PARSER::parseCachedLibSymbol()
+{
+    wxCHECK_MSG( CurTok() == T_symbol, nullptr,
+                 wxT( "Cannot parse " ) + GetTokenString( CurTok() ) + wxT( " as a symbol." ) );
+
+    // Capture the text of the whole definition by matching parentheses on the raw line buffer
+    // rather than tokenizing it, so that a cache hit doesn't lex the definition at all and a
+    // miss only lexes it once.  The line buffer is reused by the reader, so each line is copied
+    // (up to the closing parenthesis at most) before moving on to the next one.
+    int         firstLine = CurLineNumber();
+    int         firstColumn = CurOffset() - 2;      // offset of the opening parenthesis
+    std::string text( "(" );
+    const char* cur = start + curOffset;
+    int         depth = 1;
+
+    while( true )
+    {
+        const char* lineStart = cur;
+        const char* lineEnd = cur;
+
+        while( lineEnd < limit && ( *lineEnd == ' ' || *lineEnd == '\t' ) )
+            ++lineEnd;
+
+        // Comment lines are copied as they are so that line numbers are kept
+        if( lineEnd < limit && *lineEnd == '#' && lineStart == start )
+            lineEnd = limit;
+
+        while( lineEnd < limit && depth > 0 )
+        {
+            char c = *lineEnd++;
+
+            if( c == '(' )
+            {
+                depth++;
+            }
+            else if( c == ')' )
+            {
+                depth--;
+            }
+            else if( c == '"' )
+            {
+                while( lineEnd < limit && *lineEnd != '"' )
+                {
+                    if( *lineEnd == '\\' && lineEnd + 1 < limit )
+                        ++lineEnd;
+
+                    ++lineEnd;
+                }
+
+                if( lineEnd < limit )
+                    ++lineEnd;
+            }
+        }
+
+        text.append( lineStart, lineEnd );
+
+        if( depth == 0 )
+        {
+            // Leave the lexer on the closing parenthesis, as ParseSymbol() would
+            next = lineEnd;
+            curOffset = lineEnd - 1 - start;
+            prevTok = curTok;
+            curTok = DSN_RIGHT;
+            curText = ")";
+            break;
+        }
+
+        if( readLine() == 0 )
+        {
+            curTok = DSN_EOF;
+            Unexpected( T_EOF );
+        }
+
+        cur = start;
+    }
+
+    auto& versionCache = ( *m_embeddedSymbolCache )[m_requiredVersion];
+    auto  it = versionCache.find( text );
+
+    if( it != versionCache.end() )
+        return new LIB_SYMBOL( *it->second );
+
+    STRING_LINE_READER reader( text, CurSource() );
+    SCH_SEXPR_PARSER   parser( &reader );
+    LIB_SYMBOL_MAP     symbolLibMap;    // No derived symbols are allowed in the library cache.
+    LIB_SYMBOL*        symbol = nullptr;
+
+    try
+    {
+        parser.NeedLEFT();
+        parser.NextTok();
+
+        symbol = parser.ParseSymbol( symbolLibMap, m_requiredVersion );
+    }
+    catch( PARSE_ERROR& e )
+    {
+        // Report the error where it is in the file rather than in the captured text
+        int lineNumber = e.lineNumber + firstLine - 1;
+        int byteIndex = e.lineNumber == 1 ? e.byteIndex + firstColumn : e.byteIndex;
+
+        THROW_PARSE_ERROR( e.ParseProblem(), CurSource(), e.inputLine.c_str(), lineNumber,
+                           byteIndex );
+    }
+
+    versionCache[text] = std::make_unique<LIB_SYMBOL>( *symbol );
+
+    return symbol;
+}
+
+
 SCH_SYMBOL* SCH_SEXPR_PARSER::parseSchematicSymbol()
 {
     wxCHECK_MSG( CurTok() == T_symbol, nullptr,
@@ -37,6 +37,10 @@
 #include <sch_file_versions.h>
 #include <default_values.h>    // For some default values
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 
 class LIB_SHAPE;
 class LIB_ITEM;
@@ -71,6 +75,17 @@ public:
 };
 
 
+/**
+ * Embedded library symbols already parsed while loading a schematic hierarchy, keyed by the
+ * file format version they were parsed for and the s-expression text of their definition.
+ *
+ * The same text may parse differently depending on the version of the file it comes from (e.g.
+ * overbar conversion), and the sheets of a hierarchy may have been saved by different versions.
+ */
+typedef std::unordered_map<int, std::unordered_map<std::string, std::unique_ptr<LIB_SYMBOL>>>
+        EMBEDDED_LIB_SYMBOL_CACHE;
+
+
 /**
  * Object to parser s-expression symbol library and schematic file formats.
  */
@@ -110,6 +125,16 @@ public:
 
     int GetParsedRequiredVersion() const { return m_requiredVersion; }
 
+    /**
+     * Share a cache of embedded library symbols between the parsers of the sheets of a
+     * hierarchy.
+     *
+     * Sheets usually embed identical copies of the same library symbols.  With a cache set,
+     * each distinct definition is only parsed once and further copies are cloned from the
+     * cache.  The cache must outlive the parser.
+     */
+    void SetEmbeddedSymbolCache( EMBEDDED_LIB_SYMBOL_CACHE* aCache ) { m_embeddedSymbolCache = aCache; }
+
 private:
     void checkpoint();
 
@@ -201,6 +226,12 @@ private:
     SCH_TEXTBOX* parseSchTextBox();
     void parseBusAlias( SCH_SCREEN* aScreen );
 
+    /**
+     * Parse an embedded library symbol using #m_embeddedSymbolCache.  The current token
+     * must be the "symbol" keyword.
+     */
+    LIB_SYMBOL* parseCachedLibSymbol();
+
     int m_requiredVersion;  ///< Set to the symbol library file version required.
     int m_fieldId;          ///< The current field ID.
     int m_unit;             ///< The current unit being parsed.
@@ -222,6 +253,9 @@ private:
 
     /// The rootsheet for full project loads or null for importing a schematic.
     SCH_SHEET*         m_rootSheet;
+
+    /// Optional cache of embedded library symbols shared across a hierarchy load.
+    EMBEDDED_LIB_SYMBOL_CACHE* m_embeddedSymbolCache;
 };
 
 #endif    // __SCH_SEXPR_PARSER_H__
@@ -62,6 +62,7 @@
 #include <string_utils.h>
 #include <wx_filename.h>       // for ::ResolvePossibleSymlinks()
 #include <progress_reporter.h>
+#include <scoped_set_reset.h>
 #include <boost/algorithm/string/join.hpp>
 
 using namespace TSCHEMATIC_T;
@@ -93,6 +94,7 @@ void SCH_SEXPR_PLUGIN::init( SCHEMATIC* aSchematic, const STRING_UTF8_MAP* aProp
     m_schematic       = aSchematic;
     m_cache           = nullptr;
     m_out             = nullptr;
+    m_embeddedSymbolCache = nullptr;
     m_nextFreeFieldId = 100; // number arbitrarily > MANDATORY_FIELDS or SHEET_MANDATORY_FIELDS
 }
 
@@ -139,6 +141,11 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
     m_currentPath.push( m_path );
     init( aSchematic, aProperties );
 
+    // Identical embedded library symbols are only parsed once per hierarchy load
+    EMBEDDED_LIB_SYMBOL_CACHE embeddedSymbolCache;
+    SCOPED_SET_RESET<EMBEDDED_LIB_SYMBOL_CACHE*> cacheScope( m_embeddedSymbolCache,
+                                                             &embeddedSymbolCache );
+
     if( aAppendToMe == nullptr )
     {
         // Clean up any allocated memory if an exception occurs loading the schematic.
@@ -313,6 +320,7 @@ void SCH_SEXPR_PLUGIN::loadFile( const wxString& aFileName, SCH_SHEET* aSheet )
 
     SCH_SEXPR_PARSER parser( &reader, m_progressReporter, lineCount, m_rootSheet, m_appending );
 
+    parser.SetEmbeddedSymbolCache( m_embeddedSymbolCache );
     parser.ParseSchematic( aSheet );
 }
 
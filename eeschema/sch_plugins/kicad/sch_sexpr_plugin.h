@@ -27,6 +27,7 @@
 #include <sch_io_mgr.h>
 #include <sch_file_versions.h>
 #include <sch_sheet_path.h>
+#include <sch_plugins/kicad/sch_sexpr_parser.h>   // EMBEDDED_LIB_SYMBOL_CACHE
 #include <stack>
 
 
@@ -179,6 +180,9 @@ protected:
     OUTPUTFORMATTER*        m_out;              ///< The formatter for saving SCH_SCREEN objects.
     SCH_SEXPR_PLUGIN_CACHE* m_cache;
 
+    /// Embedded library symbols parsed so far during the current Load(), if any.
+    EMBEDDED_LIB_SYMBOL_CACHE* m_embeddedSymbolCache;
+
     /// initialize PLUGIN like a constructor would.
     void init( SCHEMATIC* aSchematic, const STRING_UTF8_MAP* aProperties = nullptr );
 };
@@ -34,6 +34,8 @@
 #include <wx/regex.h>
 #include <algorithm>
 #include <vector>
+#include <map>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <string_utils.h>
@@ -499,7 +501,168 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         AddItem( additionalRef ); //add to this container
     }
 
-    int LastReferenceNumber = 0;
+    // Index the annotated reference numbers by (case-insensitive) reference prefix so that free
+    // numbers can be found without rescanning the whole list for every symbol.  Prefixes are
+    // interned to small integers; each prefix maps reference numbers to the indices of the
+    // annotated references using them.
+    typedef std::map<int, std::vector<size_t>> NUMBER_MAP;
+
+    // Where to resume searching for a free number, so that annotating many references with the
+    // same prefix doesn't rescan the numbers taken so far.  All the numbers in [min, next) are
+    // known to be in use for the search the hint is keyed by (within a prefix).  Taking numbers
+    // only moves hints forward; releasing one moves back the hints beyond it.
+    struct FREE_HINT
+    {
+        int min;
+        int next;
+    };
+
+    typedef std::unordered_map<wxString, FREE_HINT> HINT_MAP;
+
+    std::unordered_map<wxString, int> prefixIds;
+    std::vector<int>                  refPrefix( m_flatList.size() );
+    std::vector<NUMBER_MAP>           usedNumbers;
+    std::vector<HINT_MAP>             freeHints;
+
+    // Symbol instances by symbol, for the locked unit lookups below
+    std::unordered_map<SCH_SYMBOL*, std::vector<size_t>> symbolRefs;
+
+    for( size_t ii = 0; ii < m_flatList.size(); ii++ )
+    {
+        const SCH_REFERENCE& ref = m_flatList[ii];
+        auto [ it, inserted ] = prefixIds.emplace( ref.m_ref.Lower(), (int) prefixIds.size() );
+
+        if( inserted )
+        {
+            usedNumbers.emplace_back();
+            freeHints.emplace_back();
+        }
+
+        refPrefix[ii] = it->second;
+
+        if( !ref.m_isNew )
+            usedNumbers[it->second][ref.m_numRef].push_back( ii );
+
+        symbolRefs[ref.GetSymbol()].push_back( ii );
+    }
+
+    std::unordered_map<SCH_SYMBOL*, std::vector<SCH_REFERENCE_LIST*>> lockedLists;
+
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+            lockedLists[pair.second[thisRefI].GetSymbol()].push_back( &pair.second );
+    }
+
+    // The searches may find number aNumber of the prefix of aIndex free again
+    auto releaseNumber =
+            [&]( size_t aIndex, int aNumber )
+            {
+                for( std::pair<const wxString, FREE_HINT>& hint : freeHints[refPrefix[aIndex]] )
+                {
+                    if( hint.second.min <= aNumber && aNumber < hint.second.next )
+                        hint.second.next = aNumber;
+                }
+            };
+
+    auto setRefNumber =
+            [&]( size_t aIndex, int aNumber )
+            {
+                SCH_REFERENCE& ref = m_flatList[aIndex];
+                NUMBER_MAP&    numbers = usedNumbers[refPrefix[aIndex]];
+
+                if( !ref.m_isNew )
+                {
+                    auto it = numbers.find( ref.m_numRef );
+
+                    if( it != numbers.end() )
+                    {
+                        alg::delete_matching( it->second, aIndex );
+
+                        if( it->second.empty() )
+                            numbers.erase( it );
+
+                        releaseNumber( aIndex, ref.m_numRef );
+                    }
+                }
+
+                ref.m_numRef = aNumber;
+                ref.m_isNew = false;
+                numbers[aNumber].push_back( aIndex );
+            };
+
+    // Equivalent to GetRefsInUse() followed by createFirstFreeRefId()
+    auto firstFreeRefId =
+            [&]( size_t aIndex, int aMinRefId ) -> int
+            {
+                const NUMBER_MAP& numbers = usedNumbers[refPrefix[aIndex]];
+                wxString          key = wxString::Format( wxS( "%d" ), aMinRefId );
+                FREE_HINT&        hint = freeHints[refPrefix[aIndex]].emplace(
+                                                key, FREE_HINT{ aMinRefId, aMinRefId } )
+                                                .first->second;
+                int               freeId = hint.next;
+
+                for( auto it = numbers.lower_bound( freeId );
+                     it != numbers.end() && it->first == freeId; ++it )
+                {
+                    freeId++;
+                }
+
+                hint.next = freeId;
+                return freeId;
+            };
+
+    // Equivalent to FindFirstUnusedReference()
+    auto firstUnusedReference =
+            [&]( size_t aIndex, int aMinValue, const std::vector<int>& aRequiredUnits ) -> int
+            {
+                const SCH_REFERENCE& aRef = m_flatList[aIndex];
+                const NUMBER_MAP&    numbers = usedNumbers[refPrefix[aIndex]];
+
+                // Whether a number is in use depends on the symbol, value and units searched for
+                const LIB_ID& libId = aRef.GetSymbol()->GetLibId();
+                wxString      key = wxString::Format( wxS( "%d\n%s\n%s" ), aMinValue,
+                                                      libId.GetUniStringLibItemName(),
+                                                      aRef.m_value );
+
+                for( int unit : aRequiredUnits )
+                    key << wxS( "\n" ) << unit;
+
+                FREE_HINT& hint = freeHints[refPrefix[aIndex]].emplace(
+                                          key, FREE_HINT{ aMinValue, aMinValue } )
+                                          .first->second;
+                int        minFreeNumber = hint.next;
+
+                for( auto it = numbers.lower_bound( minFreeNumber );
+                     it != numbers.end() && it->first == minFreeNumber; ++it, ++minFreeNumber )
+                {
+                    auto isNumberInUse =
+                            [&]() -> bool
+                            {
+                                for( const int& unit : aRequiredUnits )
+                                {
+                                    for( size_t refIndex : it->second )
+                                    {
+                                        const SCH_REFERENCE& ref = m_flatList[refIndex];
+
+                                        if( ref.CompareLibName( aRef ) || ref.CompareValue( aRef )
+                                            || ref.GetUnit() == unit )
+                                        {
+                                            return true;
+                                        }
+                                    }
+                                }
+
+                                return false;
+                            };
+
+                    if( !isNumberInUse() )
+                        break;
+                }
+
+                hint.next = minFreeNumber;
+                return minFreeNumber;
+            };
 
     /* calculate index of the first symbol with the same reference prefix
      * than the current symbol.  All symbols having the same reference
@@ -527,27 +690,27 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this symbol is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = nullptr;
+        auto                lockedIt = lockedLists.find( ref_unit.GetSymbol() );
 
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+        if( lockedIt != lockedLists.end() )
         {
-            unsigned n_refs = pair.second.GetCount();
-
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+            for( SCH_REFERENCE_LIST* candidate : lockedIt->second )
             {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( ref_unit ) )
+                for( unsigned thisRefI = 0; thisRefI < candidate->GetCount(); ++thisRefI )
                 {
-                    lockedList = &pair.second;
-                    break;
+                    if( ( *candidate )[thisRefI].IsSameInstance( ref_unit ) )
+                    {
+                        lockedList = candidate;
+                        break;
+                    }
                 }
-            }
 
-            if( lockedList != nullptr )
-                break;
+                if( lockedList != nullptr )
+                    break;
+            }
         }
 
-        if(  ( m_flatList[first].CompareRef( ref_unit ) != 0 )
+        if(  ( refPrefix[first] != refPrefix[ii] )
           || ( aUseSheetNum && ( m_flatList[first].m_sheetNum != ref_unit.m_sheetNum ) )  )
         {
             // New reference found: we need a new ref number for this reference
@@ -568,12 +731,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
         if( ref_unit.GetLibPart()->GetUnitCount() <= 1 )
         {
             if( ref_unit.m_isNew )
-            {
-                std::vector<int> idList;
-                GetRefsInUse( first, idList, minRefId );
-                LastReferenceNumber = createFirstFreeRefId( idList, minRefId );
-                ref_unit.m_numRef = LastReferenceNumber;
-            }
+                setRefNumber( ii, firstFreeRefId( ii, minRefId ) );
 
             ref_unit.m_flag  = 1;
             ref_unit.m_isNew = false;
@@ -589,9 +747,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
             if( ref_unit.m_isNew )
             {
-                LastReferenceNumber = FindFirstUnusedReference( ref_unit, minRefId, units );
-                ref_unit.m_numRef = LastReferenceNumber;
-                ref_unit.m_isNew = false;
+                setRefNumber( ii, firstUnusedReference( ii, minRefId, units ) );
                 ref_unit.m_flag = 1;
             }
 
@@ -602,7 +758,11 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( lockedRef.IsSameInstance( ref_unit ) )
                 {
                     // This is the symbol we're currently annotating. Hold the unit!
-                    ref_unit.m_unit = lockedRef.m_unit;
+                    if( ref_unit.m_unit != lockedRef.m_unit )
+                    {
+                        ref_unit.m_unit = lockedRef.m_unit;
+                        releaseNumber( ii, ref_unit.m_numRef );
+                    }
 
                     // lock this new full reference
                     inUseRefs.insert( buildFullReference( ref_unit ) );
@@ -614,10 +774,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( lockedRef.CompareLibName( ref_unit ) != 0 )
                     continue;
 
-                // Find the matching symbol
-                for( unsigned jj = ii + 1; jj < m_flatList.size(); jj++ )
+                // Find the matching symbol (symbolRefs lists are in increasing index order)
+                for( size_t jj : symbolRefs[lockedRef.GetSymbol()] )
                 {
-                    if( !lockedRef.IsSameInstance( m_flatList[jj] ) )
+                    if( jj <= ii || !lockedRef.IsSameInstance( m_flatList[jj] ) )
                         continue;
 
                     wxString ref_candidate = buildFullReference( ref_unit, lockedRef.m_unit );
@@ -627,8 +787,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     // multiunits symbols have duplicate references)
                     if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
                     {
-                        m_flatList[jj].m_numRef = ref_unit.m_numRef;
-                        m_flatList[jj].m_isNew = false;
+                        setRefNumber( jj, ref_unit.m_numRef );
                         m_flatList[jj].m_flag = 1;
 
                         // lock this new full reference
@@ -644,9 +803,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             // know what group this might belong to, so just find the first unused reference for
             // this specific unit. The other units will be annotated in the following passes.
             std::vector<int> units = { ref_unit.GetUnit() };
-            LastReferenceNumber = FindFirstUnusedReference( ref_unit, minRefId, units );
-            ref_unit.m_numRef = LastReferenceNumber;
-            ref_unit.m_isNew = false;
+            setRefNumber( ii, firstUnusedReference( ii, minRefId, units ) );
             ref_unit.m_flag = 1;
         }
     }
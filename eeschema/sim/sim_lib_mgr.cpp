@@ -25,20 +25,119 @@
 #include <pgm_base.h>
 #include <string>
 #include <string_utils.h>
+#include <algorithm>
 #include <common.h>
+#include <fmt/core.h>
 #include <functional>
+#include <mutex>
 #include <sch_symbol.h>
+#include <scoped_set_reset.h>
+#include <wx/tokenzr.h>
 
 // Include simulator headers after wxWidgets headers to avoid conflicts with Windows headers
 // (especially on msys2 + wxWidgets 3.0.x)
 #include <sim/sim_lib_mgr.h>
 #include <sim/sim_library.h>
+#include <sim/sim_library_spice.h>
 #include <sim/sim_model.h>
 #include <sim/sim_model_ideal.h>
 
 using namespace std::placeholders;
 
 
+namespace
+{
+
+/**
+ * A parsed Spice library along with the modification times of the files it was read from.
+ */
+struct CACHED_SPICE_LIBRARY
+{
+    std::shared_ptr<SIM_LIBRARY>                  library;
+    std::vector<std::pair<wxString, wxDateTime>>  timestamps;
+    unsigned                                      lastUsed = 0;
+};
+
+
+wxDateTime fileTimestamp( const wxString& aPath )
+{
+    wxFileName fn( aPath );
+
+    return fn.FileExists() ? fn.GetModificationTime() : wxInvalidDateTime;
+}
+
+
+bool isUpToDate( const CACHED_SPICE_LIBRARY& aEntry )
+{
+    for( const auto& [path, timestamp] : aEntry.timestamps )
+    {
+        wxDateTime current = fileTimestamp( path );
+
+        if( !current.IsValid() || !timestamp.IsValid() || current != timestamp )
+            return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Forwards everything to another reporter, remembering whether anything was reported.
+ */
+class TRACKING_REPORTER : public REPORTER
+{
+public:
+    TRACKING_REPORTER( REPORTER* aReporter ) :
+            m_reporter( aReporter ),
+            m_hasMessage( false )
+    {}
+
+    REPORTER& Report( const wxString& aText,
+                      SEVERITY aSeverity = RPT_SEVERITY_UNDEFINED ) override
+    {
+        m_hasMessage = true;
+        m_reporter->Report( aText, aSeverity );
+        return *this;
+    }
+
+    bool HasMessage() const override { return m_hasMessage; }
+
+private:
+    REPORTER* m_reporter;
+    bool      m_hasMessage;
+};
+
+
+/// Maximum number of parsed Spice libraries kept around; the least recently used go first.
+constexpr size_t MAX_CACHED_SPICE_LIBRARIES = 32;
+
+/**
+ * Parsed Spice libraries shared by all SIM_LIB_MGR instances, keyed by path.  Includes are
+ * resolved relative to the project, so the cache only ever holds the libraries of one project
+ * and is emptied when a library is asked for by another one.
+ */
+std::map<wxString, CACHED_SPICE_LIBRARY> s_spiceLibraryCache;
+wxString                                 s_spiceLibraryCacheProject;
+unsigned                                 s_spiceLibraryCacheClock = 0;
+std::mutex                               s_spiceLibraryCacheMutex;
+
+
+/**
+ * Drop the cached libraries if they belong to a project other than \a aProjectPath.  The cache
+ * mutex must be held.
+ */
+void selectCacheProject( const wxString& aProjectPath )
+{
+    if( aProjectPath != s_spiceLibraryCacheProject )
+    {
+        s_spiceLibraryCache.clear();
+        s_spiceLibraryCacheProject = aProjectPath;
+    }
+}
+
+}
+
+
 SIM_LIB_MGR::SIM_LIB_MGR( const PROJECT* aPrj, REPORTER* aReporter ) :
         m_project( aPrj ),
         m_reporter( aReporter )
@@ -50,6 +149,19 @@ void SIM_LIB_MGR::Clear()
 {
     m_libraries.clear();
     m_models.clear();
+    m_symbolModels.clear();
+    m_recycledModels.clear();
+}
+
+
+void SIM_LIB_MGR::RecycleModels()
+{
+    // Recycled models hold on to the library they were built from, so their base models stay
+    // valid even though this manager forgets about the libraries themselves.
+    m_recycledModels = std::move( m_symbolModels );
+    m_symbolModels.clear();
+    m_models.clear();
+    m_libraries.clear();
 }
 
 
@@ -123,12 +235,8 @@ void SIM_LIB_MGR::SetLibrary( const wxString& aLibraryPath )
 {
     try
     {
-        wxString path = ResolveLibraryPath( aLibraryPath, m_project );
-
-        std::function<wxString(const wxString&, const wxString&)> f2 =
-                std::bind( &SIM_LIB_MGR::ResolveEmbeddedLibraryPath, this, _1, _2 );
-
-        std::unique_ptr<SIM_LIBRARY> library = SIM_LIBRARY::Create( path, m_reporter, &f2 );
+        wxString                     path = ResolveLibraryPath( aLibraryPath, m_project );
+        std::shared_ptr<SIM_LIBRARY> library = loadLibrary( path );
 
         Clear();
         m_libraries[path] = std::move( library );
@@ -140,6 +248,93 @@ void SIM_LIB_MGR::SetLibrary( const wxString& aLibraryPath )
 }
 
 
+std::shared_ptr<SIM_LIBRARY> SIM_LIB_MGR::getLibrary( const wxString& aLibraryPath )
+{
+    wxString path = ResolveLibraryPath( aLibraryPath, m_project );
+    auto     it = m_libraries.find( path );
+
+    if( it == m_libraries.end() )
+        it = m_libraries.emplace( path, loadLibrary( path ) ).first;
+
+    return it->second;
+}
+
+
+std::shared_ptr<SIM_LIBRARY> SIM_LIB_MGR::loadLibrary( const wxString& aPath )
+{
+    std::function<wxString( const wxString&, const wxString& )> f2 =
+            std::bind( &SIM_LIB_MGR::ResolveEmbeddedLibraryPath, this, _1, _2 );
+
+    // IBIS libraries hang on to the reporter they were read with, so they can't be shared.
+    if( aPath.EndsWith( ".ibs" ) )
+        return SIM_LIBRARY::Create( aPath, m_reporter, &f2 );
+
+    wxString projectPath = m_project ? m_project->GetProjectFullName() : wxString();
+
+    {
+        std::lock_guard<std::mutex> lock( s_spiceLibraryCacheMutex );
+
+        selectCacheProject( projectPath );
+
+        auto it = s_spiceLibraryCache.find( aPath );
+
+        if( it != s_spiceLibraryCache.end() )
+        {
+            if( isUpToDate( it->second ) )
+            {
+                it->second.lastUsed = ++s_spiceLibraryCacheClock;
+                return it->second.library;
+            }
+
+            s_spiceLibraryCache.erase( it );
+        }
+    }
+
+    wxString           msg;
+    WX_STRING_REPORTER reporter( &msg );
+
+    std::shared_ptr<SIM_LIBRARY> library = SIM_LIBRARY::Create( aPath, &reporter, &f2 );
+
+    if( reporter.HasMessage() )
+    {
+        // Libraries with errors aren't cached so that the errors get reported on every run.
+        if( !m_reporter )
+            THROW_IO_ERROR( msg );
+
+        for( const wxString& line : wxStringTokenize( msg, wxS( "\n" ) ) )
+            m_reporter->Report( line, RPT_SEVERITY_ERROR );
+
+        return library;
+    }
+
+    CACHED_SPICE_LIBRARY entry;
+    entry.library = library;
+
+    for( const wxString& file : static_cast<SIM_LIBRARY_SPICE&>( *library ).GetSourceFiles() )
+        entry.timestamps.emplace_back( file, fileTimestamp( file ) );
+
+    std::lock_guard<std::mutex> lock( s_spiceLibraryCacheMutex );
+
+    selectCacheProject( projectPath );
+
+    entry.lastUsed = ++s_spiceLibraryCacheClock;
+    s_spiceLibraryCache[aPath] = std::move( entry );
+
+    while( s_spiceLibraryCache.size() > MAX_CACHED_SPICE_LIBRARIES )
+    {
+        auto oldest = std::min_element( s_spiceLibraryCache.begin(), s_spiceLibraryCache.end(),
+                                        []( const auto& aLhs, const auto& aRhs )
+                                        {
+                                            return aLhs.second.lastUsed < aRhs.second.lastUsed;
+                                        } );
+
+        s_spiceLibraryCache.erase( oldest );
+    }
+
+    return library;
+}
+
+
 SIM_MODEL& SIM_LIB_MGR::CreateModel( SIM_MODEL::TYPE aType, const std::vector<LIB_PIN*>& aPins )
 {
     m_models.push_back( SIM_MODEL::Create( aType, aPins, m_reporter ) );
@@ -229,10 +424,65 @@ SIM_LIBRARY::MODEL SIM_LIB_MGR::CreateModel( const SCH_SHEET_PATH* aSheetPath, S
                    return StrNumCmp( lhs->GetNumber(), rhs->GetNumber(), true ) < 0;
                } );
 
+    // The model is fully determined by its fields, its pins and the library its base model
+    // comes from, so a model of the previous run built from the same ones can be reused as is.
+    std::string key;
+
+    for( const SCH_FIELD& field : fields )
+    {
+        key += field.GetName().ToStdString() + '\x1f';
+        key += field.GetText().ToStdString() + '\x1e';
+    }
+
+    for( const LIB_PIN* pin : sourcePins )
+    {
+        key += fmt::format( "{}\x1f{}\x1f{}\x1e", static_cast<const void*>( pin ),
+                            pin->GetNumber().ToStdString(), pin->GetName().ToStdString() );
+    }
+
+    std::shared_ptr<SIM_LIBRARY> library;
+    std::string libraryPath = SIM_MODEL::GetFieldValue( &fields, SIM_LIBRARY::LIBRARY_FIELD );
+
+    if( !libraryPath.empty() )
+    {
+        try
+        {
+            library = getLibrary( libraryPath );
+        }
+        catch( const IO_ERROR& )
+        {
+            // Reported when creating the model below
+        }
+    }
+
+    auto recycled = m_recycledModels.find( key );
+
+    if( recycled != m_recycledModels.end() && recycled->second.library == library
+            && !m_symbolModels.count( key ) )
+    {
+        SYMBOL_MODEL& reused = m_symbolModels[key] = std::move( recycled->second );
+        m_recycledModels.erase( recycled );
+
+        return { reused.name, *reused.model };
+    }
+
+    TRACKING_REPORTER           tracker( m_reporter );
+    SCOPED_SET_RESET<REPORTER*> reporterScope( m_reporter, m_reporter ? &tracker : nullptr );
+
     SIM_LIBRARY::MODEL model = CreateModel( fields, sourcePins, true );
 
     model.model.SetIsStoredInValue( storeInValue );
 
+    // Models which reported something are rebuilt every time so their messages aren't lost.
+    if( !tracker.HasMessage() && !m_symbolModels.count( key ) )
+    {
+        SYMBOL_MODEL& entry = m_symbolModels[key];
+        entry.name = model.name;
+        entry.model = std::move( m_models.back() );
+        entry.library = library;
+        m_models.pop_back();
+    }
+
     return model;
 }
 
@@ -278,18 +528,7 @@ SIM_LIBRARY::MODEL SIM_LIB_MGR::CreateModel( const wxString& aLibraryPath,
     try
     {
         path = ResolveLibraryPath( aLibraryPath, m_project );
-
-        auto it = m_libraries.find( path );
-
-        if( it == m_libraries.end() )
-        {
-            std::function<wxString( const wxString&, const wxString& )> f2 =
-                    std::bind( &SIM_LIB_MGR::ResolveEmbeddedLibraryPath, this, _1, _2 );
-
-            it = m_libraries.emplace( path, SIM_LIBRARY::Create( path, m_reporter, &f2 ) ).first;
-        }
-
-        library = &*it->second;
+        library = getLibrary( path ).get();
     }
     catch( const IO_ERROR& e )
     {
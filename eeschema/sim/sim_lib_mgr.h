@@ -47,6 +47,14 @@ public:
 
     void Clear();
 
+    /**
+     * Release the libraries and models of the previous run while keeping the models created
+     * for symbols around, so that an unchanged symbol gets its previous #SIM_MODEL back from
+     * the next call to CreateModel( const SCH_SHEET_PATH*, SCH_SYMBOL& ) instead of having it
+     * rebuilt.  Previous models not asked for again are destroyed by the next call.
+     */
+    void RecycleModels();
+
     void SetLibrary( const wxString& aLibraryPath );
 
     SIM_MODEL& CreateModel( SIM_MODEL::TYPE aType, const std::vector<LIB_PIN*>& aPins );
@@ -79,10 +87,38 @@ public:
     wxString ResolveEmbeddedLibraryPath( const wxString& aLibPath, const wxString& aRelativeLib );
 
 private:
+    /**
+     * Return the library at \a aLibraryPath, loading it if this manager doesn't hold it yet.
+     *
+     * @throw IO_ERROR if the path cannot be resolved, or if the library cannot be read and no
+     *        reporter is set.
+     */
+    std::shared_ptr<SIM_LIBRARY> getLibrary( const wxString& aLibraryPath );
+
+    /**
+     * Read the library at the resolved path \a aPath.  Spice libraries are shared between all
+     * managers of the same project and only parsed again when the library or one of its includes
+     * has changed on disk, or when it has been evicted from the bounded cache.
+     */
+    std::shared_ptr<SIM_LIBRARY> loadLibrary( const wxString& aPath );
+
+    struct SYMBOL_MODEL
+    {
+        std::string                  name;
+        std::unique_ptr<SIM_MODEL>   model;
+        std::shared_ptr<SIM_LIBRARY> library;   ///< Library the base model was taken from.
+    };
+
     const PROJECT*                                   m_project;
     REPORTER*                                        m_reporter;
-    std::map<wxString, std::unique_ptr<SIM_LIBRARY>> m_libraries;
+    std::map<wxString, std::shared_ptr<SIM_LIBRARY>> m_libraries;
     std::vector<std::unique_ptr<SIM_MODEL>>          m_models;
+
+    /// Models created for symbols, keyed by their fields and pins.
+    std::map<std::string, SYMBOL_MODEL>              m_symbolModels;
+
+    /// Symbol models of the previous run which haven't been asked for again yet.
+    std::map<std::string, SYMBOL_MODEL>              m_recycledModels;
 };
 
 
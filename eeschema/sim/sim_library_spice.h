@@ -39,8 +39,15 @@ public:
     // @copydoc SIM_LIBRARY::ReadFile()
     void ReadFile( const wxString& aFilePath, REPORTER* aReporter ) override;
 
+    /**
+     * @return the library file followed by every file it includes (directly or not), as read
+     *         by the last call to ReadFile().
+     */
+    const std::vector<wxString>& GetSourceFiles() const { return m_sourceFiles; }
+
 private:
     std::unique_ptr<SPICE_LIBRARY_PARSER> m_spiceLibraryParser;
+    std::vector<wxString>                 m_sourceFiles;
 };
 
 #endif // SIM_LIBRARY_SPICE_H
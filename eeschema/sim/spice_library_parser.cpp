@@ -59,6 +59,8 @@ namespace SIM_LIBRARY_SPICE_PARSER
 
 void SPICE_LIBRARY_PARSER::parseFile( const wxString &aFilePath, REPORTER& aReporter )
 {
+    m_library.m_sourceFiles.push_back( aFilePath );
+
     try
     {
         tao::pegtl::string_input<> in( SafeReadFile( aFilePath, wxS( "r" ) ).ToStdString(),
@@ -132,6 +134,7 @@ void SPICE_LIBRARY_PARSER::ReadFile( const wxString& aFilePath, REPORTER* aRepor
 {
     m_library.m_models.clear();
     m_library.m_modelNames.clear();
+    m_library.m_sourceFiles.clear();
 
     if( aReporter )
     {
@@ -24,6 +24,8 @@
 #ifndef ADVANCED_CFG__H
 #define ADVANCED_CFG__H
 
+#include <wx/string.h>
+
 class wxConfigBase;
 
 /**
@@ -239,6 +241,20 @@ public:
      */
     bool m_UseClipper2;
 
+    /**
+     * Split the Cairo canvas into tiles and draw the cached layers of each tile on a separate
+     * thread.
+     */
+    bool m_CairoTiledRendering;
+
+    /**
+     * Level of detail thresholds in pixels: pads and vias drawn smaller than m_LODItemMinPixels
+     * become boxes and text smaller than m_LODTextMinPixels becomes a bar.  0 disables a
+     * threshold.
+     */
+    double m_LODItemMinPixels;
+    double m_LODTextMinPixels;
+
     /**
      * Use the 3DConnexion Driver
      */
@@ -249,6 +265,12 @@ public:
      */
     bool m_IncrementalConnectivity;
 
+    /**
+     * Write a Chrome trace-event JSON profile of application startup to this file.  Empty
+     * disables the startup tracer.
+     */
+    wxString m_StartupTracePath;
+
 ///@}
 
 
@@ -32,6 +32,7 @@ namespace CLI
         static const int ERR_UNKNOWN = 2;
         static const int  ERR_INVALID_INPUT_FILE = 3;
         static const int  ERR_INVALID_OUTPUT_CONFLICT = 4;
+        static const int  ERR_RC_VIOLATIONS = 5;
     };
 }
 
@@ -209,23 +209,18 @@ protected:
     }
 
     /**
-     * Draws a single line of text. Multiline texts should be split before using the
-     * function.
+     * Convert a string, which may span several lines and contain markup, into glyphs laid out
+     * exactly as Draw() draws them.
      *
-     * @param aGal is a pointer to the graphics abstraction layer, or nullptr (nothing is drawn)
-     * @param aBBox is an optional pointer to be filled with the bounding box.
-     * @param aText is the text to be drawn.
-     * @param aPosition is text position.
-     * @param aSize is the cap-height and em-width of the text
-     * @param aAngle is text angle.
-     * @param aMirror is true if text should be drawn mirrored, false otherwise.
+     * @param aGlyphs receives the glyphs of all the lines.
+     * @param aText is the text to be converted.
+     * @param aPosition is the position of the first line.
      * @param aOrigin is the point around which the text should be rotated, mirrored, etc.
-     * @return new cursor position in non-rotated, non-mirrored coordinates
+     * @param aAttrs are the styling attributes of the text, including its rotation.
      */
-    void drawSingleLineText( KIGFX::GAL* aGal, BOX2I* aBoundingBox, const wxString& aText,
-                             const VECTOR2I& aPosition, const VECTOR2I& aSize,
-                             const EDA_ANGLE& aAngle, bool aMirror, const VECTOR2I& aOrigin,
-                             bool aItalic, bool aUnderline ) const;
+    void getLinesAsGlyphs( std::vector<std::unique_ptr<GLYPH>>* aGlyphs, const wxString& aText,
+                           const VECTOR2I& aPosition, const VECTOR2I& aOrigin,
+                           const TEXT_ATTRIBUTES& aAttrs ) const;
 
     /**
      * Computes the bounding box for a single line of text.
@@ -41,7 +41,9 @@
 #include <font/glyph.h>
 #include <font/outline_decomposer.h>
 
+#include <map>
 #include <mutex>
+#include <tuple>
 
 namespace KIFONT
 {
@@ -134,6 +136,18 @@ protected:
                               const VECTOR2I& aOrigin, TEXT_STYLE_FLAGS aTextStyle ) const;
 
 private:
+    /**
+     * Return a glyph decomposed into straight segments, with its holes assigned and its
+     * triangulation cached, in size-normalized coordinates.
+     *
+     * The glyph is built on first use and then shared by every text item using this font.
+     * Must be called with m_freeTypeMutex held and the face size already set.
+     *
+     * @param aGlyphIndex is the glyph index in the font face (not the Unicode code point).
+     * @param aScript selects the sub/superscript face size.
+     */
+    const OUTLINE_GLYPH& getNormalizedGlyph( unsigned int aGlyphIndex, bool aScript ) const;
+
     VECTOR2I getTextAsGlyphsUnlocked( BOX2I* aBoundingBox,
                                       std::vector<std::unique_ptr<GLYPH>>* aGlyphs,
                                       const wxString& aText, const VECTOR2I& aSize,
@@ -155,9 +169,16 @@ private:
     bool              m_fakeBold;
     bool              m_fakeItal;
 
-    // cache for glyphs converted to straight segments
-    // key is glyph index (FT_GlyphSlot field glyph_index)
-    std::map<unsigned int, GLYPH_POINTS_LIST> m_contourCache;
+    // Process-wide cache of glyphs converted to straight segments and triangulated, keyed by
+    // font, glyph index (FT_GlyphSlot field glyph_index) and sub/superscript sizing.  Text items
+    // instance these with their own size, position and rotation.  Guarded by m_freeTypeMutex.
+    typedef std::tuple<const OUTLINE_FONT*, unsigned int, bool> GLYPH_CACHE_KEY;
+
+    static std::map<GLYPH_CACHE_KEY, std::unique_ptr<OUTLINE_GLYPH>> s_glyphCache;
+
+    // Cached glyphs are stored in integer coordinates; scale the decomposed font units up so
+    // that rounding them stays well below what any text size can show.
+    static constexpr double m_glyphCacheScaler = 1024.0;
 
     // The height of the KiCad stroke font is the distance between stroke endpoints for a vertical
     // line of cap-height.  So the cap-height of the font is actually stroke-width taller than its
@@ -33,6 +33,7 @@
 #include <map>
 #include <deque>
 #include <algorithm>
+#include <atomic>
 #include <utf8.h>
 #include <math/box2.h>
 #include <font/font.h>
@@ -87,19 +88,46 @@ public:
                               const VECTOR2I& aPosition, const EDA_ANGLE& aAngle, bool aMirror,
                               const VECTOR2I& aOrigin, TEXT_STYLE_FLAGS aTextStyle ) const override;
 
+    /**
+     * Lay out a string, which may span several lines and contain markup, and flatten all of its
+     * strokes into a single list of polylines in world coordinates.
+     *
+     * This is the batched form of Draw() for consumers which do not go through a GAL, such as
+     * the plotters: the whole string is converted in one call and each stroke can be emitted as
+     * a single polyline rather than segment by segment.  The polylines are appended, so the
+     * strokes of several strings can be collected into the same list.
+     *
+     * @param aPolylines receives the strokes of the text.
+     * @param aText is the text to be converted.
+     * @param aPosition is the text position in world coordinates.
+     * @param aAttrs are the styling attributes of the text, including its rotation.
+     */
+    void GetLinesAsPolylines( std::vector<std::vector<VECTOR2D>>* aPolylines,
+                              const wxString& aText, const VECTOR2I& aPosition,
+                              const TEXT_ATTRIBUTES& aAttrs ) const;
+
 private:
     /**
      * Load the standard KiCad stroke font.
      *
+     * Glyphs are not decoded here, only on first use by getGlyph().
+     *
      * @param aNewStrokeFont is the pointer to the font data.
      * @param aNewStrokeFontSize is the size of the font data.
      */
     void loadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize );
 
+    /**
+     * Return a glyph of the font, decoding it from the font data the first time it is needed.
+     *
+     * @param aIndex is the index of the glyph in the font data (code point - ' ').
+     */
+    STROKE_GLYPH* getGlyph( int aIndex ) const;
+
 private:
-    const std::vector<std::shared_ptr<GLYPH>>* m_glyphs;
-    const GLYPH_BOUNDING_BOX_LIST*             m_glyphBoundingBoxes;
-    double                                     m_maxGlyphWidth;
+    const char* const*          m_fontData;       ///< Encoded glyphs, compiled into the binary
+    int                         m_fontDataSize;   ///< Number of glyphs in m_fontData
+    std::atomic<STROKE_GLYPH*>* m_glyphs;         ///< Decoded glyphs, shared by all instances
 };
 
 } //namespace KIFONT
@@ -104,11 +104,7 @@ public:
     void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override { drawPoly( aLineChain ); }
 
     /// @copydoc GAL::DrawPolylines()
-    void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists ) override
-    {
-        for( const std::vector<VECTOR2D>& points : aPointLists )
-            drawPoly( points );
-    }
+    void DrawPolylines( const std::vector<std::vector<VECTOR2D>>& aPointLists ) override;
 
     /// @copydoc GAL::DrawPolygon()
     void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override { drawPoly( aPointList ); }
@@ -124,11 +120,7 @@ public:
     void DrawGlyph( const KIFONT::GLYPH& aPolySet, int aNth, int aTotal ) override;
 
     /// @copydoc GAL::DrawGlyphs()
-    void DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>& aGlyphs ) override
-    {
-        for( size_t i = 0; i < aGlyphs.size(); i++ )
-            DrawGlyph( *aGlyphs[i], i, aGlyphs.size() );
-    }
+    void DrawGlyphs( const std::vector<std::unique_ptr<KIFONT::GLYPH>>& aGlyphs ) override;
 
     /// @copydoc GAL::DrawCurve()
     void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
@@ -297,6 +289,14 @@ protected:
     void drawPoly( const VECTOR2D aPointList[], int aListSize );
     void drawPoly( const SHAPE_LINE_CHAIN& aLineChain );
 
+    /**
+     * Add a polyline to the current path as a new sub-path, without stroking it.
+     *
+     * Several polylines added this way are stroked together by a single flushPath(), which is
+     * much cheaper in Cairo than stroking (or, when grouping, storing) each of them on its own.
+     */
+    void appendPolyline( const std::vector<VECTOR2D>& aPointList );
+
     /**
      * Return a valid key that can be used as a new group number.
      *
@@ -347,6 +347,30 @@ protected:
 
     typedef std::deque<GROUP_ELEMENT> GROUP;        ///< A graphic group type definition
 
+    /// Fill and stroke settings carried between the commands of replayed groups
+    struct GROUP_REPLAY_STATE
+    {
+        bool    m_IsFillEnabled;
+        bool    m_IsStrokeEnabled;
+        COLOR4D m_FillColor;
+        COLOR4D m_StrokeColor;
+    };
+
+    /**
+     * Execute the commands stored in a group on a Cairo context.
+     *
+     * Neither the groups nor the GAL state are modified, so groups may be replayed concurrently
+     * on different contexts.
+     *
+     * @param aContext is the context to draw on.
+     * @param aGroupNumber is the group to replay.
+     * @param aState is the fill and stroke state, updated by the group commands.
+     * @param aDraw is false to only apply the state changes of the group without drawing its
+     *              paths, e.g. for a group which lies outside of the area being drawn.
+     */
+    void replayGroup( cairo_t* aContext, int aGroupNumber, GROUP_REPLAY_STATE& aState,
+                      bool aDraw = true ) const;
+
     // Variables for the grouping function
     bool                  m_isGrouping;             ///< Is grouping enabled ?
     bool                  m_isElementAdded;         ///< Was an graphic element added ?
@@ -452,6 +476,24 @@ public:
     /// @copydoc GAL::EndDrawing()
     void EndDrawing() override;
 
+    /// @copydoc GAL::DrawGroup()
+    void DrawGroup( int aGroupNumber ) override;
+
+    /// @copydoc GAL::BeginGroupBatch()
+    void BeginGroupBatch() override;
+
+    /// @copydoc GAL::EndGroupBatch()
+    void EndGroupBatch() override;
+
+    /**
+     * Replay a list of groups in horizontal bands of the screen, each band on a separate
+     * thread, then composite the bands onto the current buffer.  Groups whose paths lie
+     * entirely outside of a band are not drawn in it.
+     *
+     * @return false if the groups cannot be drawn in parallel; nothing has been drawn then.
+     */
+    bool drawGroupsTiled( const std::vector<int>& aGroups );
+
     /// Prepare Cairo surfaces for drawing
     void initSurface();
 
@@ -516,6 +558,11 @@ protected:
     bool                m_isInitialized;       ///< Are Cairo image & surface ready to use
     COLOR4D             m_backgroundColor;     ///< Background color
     wxCursor            m_currentwxCursor;     ///< wxCursor showing the current native cursor
+
+    // Tiled rendering of group batches
+    bool                m_isBatchingGroups;    ///< Are DrawGroup() calls being deferred?
+    std::vector<int>    m_batchedGroups;       ///< Groups deferred since BeginGroupBatch()
+    std::vector<cairo_surface_t*> m_tileSurfaces; ///< One surface per band of the screen
 };
 
 } // namespace KIGFX
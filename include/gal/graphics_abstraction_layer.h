@@ -484,6 +484,17 @@ public:
      */
     virtual void DrawGroup( int aGroupNumber ) {};
 
+    /**
+     * Begin a batch of DrawGroup() calls with no other drawing in between.
+     *
+     * The GAL may defer drawing the groups until EndGroupBatch(), e.g. to render them in
+     * parallel.  The groups are always composited in the order they were submitted.
+     */
+    virtual void BeginGroupBatch() {};
+
+    /// Draw all the groups submitted since BeginGroupBatch().
+    virtual void EndGroupBatch() {};
+
     /**
      * Change the color used to draw the group.
      *
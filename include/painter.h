@@ -35,10 +35,19 @@
 #include <wx/dc.h>
 
 #include <gal/color4d.h>
+#include <math/vector2d.h>
 #include <render_settings.h>
 #include <layer_ids.h>
+#include <limits>
 #include <memory>
 
+class TEXT_ATTRIBUTES;
+
+namespace KIFONT
+{
+class FONT;
+}
+
 namespace KIGFX
 {
 class GAL;
@@ -95,10 +104,57 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Build the geometry caches owned by \a aItem that drawing it relies on (polygon
+     * triangulations, effective shapes, etc.) without drawing anything.
+     *
+     * Called from worker threads for batches of items about to be redrawn, so that the
+     * tessellation work is spread over the thread pool and Draw() mostly uploads cached data.
+     * Implementations may only modify \a aItem and must not touch the GAL.
+     */
+    virtual void PrepareDraw( const VIEW_ITEM* aItem ) const {}
+
+    /**
+     * Forget the level of detail choices recorded so far.  Called by the VIEW before drawing an
+     * item into a cached group.
+     */
+    void ResetDetailRange()
+    {
+        m_detailMinScale = 0.0;
+        m_detailMaxScale = std::numeric_limits<double>::max();
+    }
+
+    /**
+     * Return the range of world scales (see GAL::GetWorldScale()) over which the level of detail
+     * chosen by the Draw() calls since ResetDetailRange() remains the same.  Outside of it, the
+     * cached geometry of the item has to be redrawn.
+     */
+    double GetDetailMinScale() const { return m_detailMinScale; }
+    double GetDetailMaxScale() const { return m_detailMaxScale; }
+
 protected:
+    /**
+     * Check if a feature of a given size is drawn so small that it should be replaced by a
+     * cheaper approximation.  The decision is recorded in the detail range.
+     *
+     * @param aWorldSize is the size of the feature in world units.
+     * @param aMinPixels is the smallest size in pixels drawn in full detail; level of detail is
+     *                   disabled if it is not positive.
+     */
+    bool isBelowDetailThreshold( double aWorldSize, double aMinPixels );
+
+    /**
+     * Draw text too small to be read as a bar spanning the text extents.
+     */
+    void drawTextBar( const wxString& aText, const VECTOR2D& aPosition,
+                      const TEXT_ATTRIBUTES& aAttrs, const KIFONT::FONT* aFont );
+
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
     GAL* m_gal;
+
+    double m_detailMinScale;    ///< Smallest world scale the current detail choices hold for
+    double m_detailMaxScale;    ///< Largest world scale the current detail choices hold for
 };
 
 } // namespace KIGFX
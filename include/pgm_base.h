@@ -50,6 +50,7 @@ class wxWindow;
 class COMMON_SETTINGS;
 class SETTINGS_MANAGER;
 class SCRIPTING;
+class STARTUP_TRACER;
 
 /**
  * A small class to handle the list of existing translations.
@@ -292,6 +293,17 @@ public:
     // too late for contained objects like wxSingleInstanceChecker.
     void Destroy();
 
+    /**
+     * @return the startup tracer, or nullptr when startup tracing is not enabled.
+     */
+    STARTUP_TRACER* GetStartupTracer() const { return m_startup_tracer.get(); }
+
+    /**
+     * Mark the end of application startup and write the startup trace, if enabled.  Call once
+     * the main frame is shown or, for kicad-cli, once the command has run.
+     */
+    void FinishStartupTrace();
+
     /**
      * Save the program (process) settings subset which are stored .kicad_common.
      */
@@ -347,6 +359,8 @@ protected:
 
     std::unique_ptr<SCRIPTING> m_python_scripting;
 
+    std::unique_ptr<STARTUP_TRACER> m_startup_tracer;
+
     wxString        m_bin_dir;                /// full path to this program
     wxString        m_kicad_env;              /// The KICAD system environment variable.
 
@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file startup_trace.h
+ * @brief Scoped timings of application startup, written as Chrome trace-event JSON.
+ */
+
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Collect the duration of the expensive steps of application startup (settings, library tables,
+ * fonts, python, KIFACE loading) and write them as a Chrome trace-event JSON file which can be
+ * opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * A single tracer is owned by the PGM_BASE so that the KIFACEs, which each link their own copy
+ * of common, record into the same event list as the program that loaded them.  The tracer only
+ * exists when enabled by the KICAD_STARTUP_TRACE environment variable or by the
+ * StartupTracePath advanced config setting, both of which name the output file.
+ */
+class STARTUP_TRACER
+{
+public:
+    using CLOCK = std::chrono::steady_clock;
+
+    STARTUP_TRACER( const wxString& aOutputPath );
+
+    /**
+     * Return the output file requested by the environment or the advanced config, or an empty
+     * string when startup tracing is disabled.
+     */
+    static wxString GetRequestedOutputPath();
+
+    /**
+     * Add a complete event covering [aStart, aEnd] on the calling thread.
+     */
+    void AddEvent( const std::string& aName, const char* aCategory, CLOCK::time_point aStart,
+                   CLOCK::time_point aEnd );
+
+    /**
+     * Add a zero-length marker, e.g. the point at which the main frame is shown.
+     */
+    void AddInstant( const char* aName, const char* aCategory );
+
+    /**
+     * Write all events recorded so far to the output file, replacing any previous contents.
+     * Called once startup has completed and again on exit so that KIFACEs loaded later by the
+     * project manager are included.
+     *
+     * @return false if the file could not be written.
+     */
+    bool Write();
+
+private:
+    struct EVENT
+    {
+        std::string name;
+        const char* category;
+        char        phase;              ///< 'X' complete event or 'i' instant event
+        double      start_us;           ///< relative to tracer creation
+        double      duration_us;
+        size_t      thread_id;
+    };
+
+    double toMicros( CLOCK::time_point aTime ) const
+    {
+        return std::chrono::duration<double, std::micro>( aTime - m_epoch ).count();
+    }
+
+    wxString           m_outputPath;
+    CLOCK::time_point  m_epoch;
+    std::mutex         m_mutex;
+    std::vector<EVENT> m_events;
+};
+
+
+/**
+ * Record the lifetime of the enclosing scope in the program's startup tracer, if there is one.
+ */
+class STARTUP_TRACE_SCOPE
+{
+public:
+    STARTUP_TRACE_SCOPE( const std::string& aName, const char* aCategory );
+    ~STARTUP_TRACE_SCOPE();
+
+private:
+    STARTUP_TRACER*                   m_tracer;
+    std::string                       m_name;
+    const char*                       m_category;
+    STARTUP_TRACER::CLOCK::time_point m_start;
+};
+
+
+#define STARTUP_TRACE_CONCAT2( a, b ) a##b
+#define STARTUP_TRACE_CONCAT( a, b ) STARTUP_TRACE_CONCAT2( a, b )
+
+/**
+ * Time the rest of the enclosing scope as \a aName in category \a aCategory.  The category
+ * must be a string literal.
+ */
+#define SCOPED_STARTUP_TRACE( aName, aCategory ) \
+    STARTUP_TRACE_SCOPE STARTUP_TRACE_CONCAT( startupTraceScope, __LINE__ )( aName, aCategory )
+
+#endif // STARTUP_TRACE_H
@@ -846,6 +846,12 @@ protected:
     ///< Flat list of all items.
     std::shared_ptr<std::vector<VIEW_ITEM*>> m_allItems;
 
+    ///< Items with pending update flags, processed by UpdateItems().
+    std::vector<VIEW_ITEM*>            m_updateQueue;
+
+    ///< Items drawn at a level of detail not matching the zoom were queued by the last redraw.
+    bool                               m_detailUpdatesQueued;
+
     ///< The set of layers that are displayed on the top.
     std::set<unsigned int>             m_topLayers;
 
@@ -0,0 +1,56 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "command_sch_erc.h"
+#include <cli/exit_codes.h>
+#include "jobs/job_sch_erc.h"
+#include <kiface_base.h>
+#include <wx/crt.h>
+
+#include <macros.h>
+
+#define ARG_EXIT_CODE_VIOLATIONS "--exit-code-violations"
+
+CLI::SCH_ERC_COMMAND::SCH_ERC_COMMAND() : EXPORT_PCB_BASE_COMMAND( "erc" )
+{
+    m_argParser.add_argument( ARG_EXIT_CODE_VIOLATIONS )
+            .help( UTF8STDSTR( _( "Return a nonzero exit code if ERC errors exist" ) ) )
+            .implicit_value( true )
+            .default_value( false );
+}
+
+
+int CLI::SCH_ERC_COMMAND::doPerform( KIWAY& aKiway )
+{
+    std::unique_ptr<JOB_SCH_ERC> ercJob = std::make_unique<JOB_SCH_ERC>( true );
+
+    ercJob->m_filename = FROM_UTF8( m_argParser.get<std::string>( ARG_INPUT ).c_str() );
+    ercJob->m_outputFile = FROM_UTF8( m_argParser.get<std::string>( ARG_OUTPUT ).c_str() );
+    ercJob->m_exitCodeViolations = m_argParser.get<bool>( ARG_EXIT_CODE_VIOLATIONS );
+
+    if( !wxFile::Exists( ercJob->m_filename ) )
+    {
+        wxFprintf( stderr, _( "Schematic file does not exist or is not accessible\n" ) );
+        return EXIT_CODES::ERR_INVALID_INPUT_FILE;
+    }
+
+    int exitCode = aKiway.ProcessJob( KIWAY::FACE_SCH, ercJob.get() );
+
+    return exitCode;
+}
@@ -35,6 +35,7 @@
 #include <paths.h>
 #include <settings/settings_manager.h>
 #include <settings/kicad_settings.h>
+#include <startup_trace.h>
 #include <systemdirsappend.h>
 #include <trace_helpers.h>
 
@@ -66,6 +67,7 @@
 #include "cli/command_fp_export_svg.h"
 #include "cli/command_fp_upgrade.h"
 #include "cli/command_sch.h"
+#include "cli/command_sch_erc.h"
 #include "cli/command_sch_export.h"
 #include "cli/command_sym.h"
 #include "cli/command_sym_export.h"
@@ -134,6 +136,7 @@ static CLI::EXPORT_PCB_COMMAND           exportPcbCmd{};
 static CLI::PCB_COMMAND                  pcbCmd{};
 static CLI::EXPORT_SCH_COMMAND           exportSchCmd{};
 static CLI::SCH_COMMAND                  schCmd{};
+static CLI::SCH_ERC_COMMAND              schErcCmd{};
 static CLI::EXPORT_SCH_PYTHONBOM_COMMAND exportSchPythonBomCmd{};
 static CLI::EXPORT_SCH_NETLIST_COMMAND   exportSchNetlistCmd{};
 static CLI::EXPORT_SCH_PLOT_COMMAND      exportSchDxfCmd{ "dxf", PLOT_FORMAT::DXF };
@@ -199,6 +202,9 @@ static std::vector<COMMAND_ENTRY> commandStack = {
                     &exportSchPythonBomCmd,
                     &exportSchSvgCmd
                 }
+            },
+            {
+                &schErcCmd
             }
         }
     },
@@ -385,7 +391,15 @@ int PGM_KICAD::OnPgmRun()
 
     if( cliCmd )
     {
-        int exitCode = cliCmd->Perform( Kiway );
+        // The command itself is recorded too; the trace is rewritten on exit
+        FinishStartupTrace();
+
+        int exitCode;
+
+        {
+            SCOPED_STARTUP_TRACE( "CLI command", "cli" );
+            exitCode = cliCmd->Perform( Kiway );
+        }
 
         if( exitCode != CLI::EXIT_CODES::AVOID_CLOSING )
         {
@@ -272,6 +272,21 @@ class SHAPE_INDEX
             return this->m_tree->Search( min, max, aVisitor );
         }
 
+        /**
+         * Run a callback on every #SHAPE object whose bounding box intersects \a aBox.
+         *
+         * @param aBox is the area to search.
+         * @param aVisitor is the object to be invoked on every object contained in the search area.
+         */
+        template <class V>
+        int Query( const BOX2I& aBox, V& aVisitor ) const
+        {
+            int min[2] = { aBox.GetX(),         aBox.GetY() };
+            int max[2] = { aBox.GetRight(),     aBox.GetBottom() };
+
+            return this->m_tree->Search( min, max, aVisitor );
+        }
+
         /**
          * Create an iterator for the current index object.
          *
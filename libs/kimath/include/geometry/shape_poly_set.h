@@ -30,6 +30,7 @@
 
 #include <cstdio>
 #include <deque>                        // for deque
+#include <functional>                   // for function
 #include <vector>                       // for vector
 #include <iosfwd>                       // for string, stringstream
 #include <memory>
@@ -172,6 +173,12 @@ public:
                 vertex += aVec;
         }
 
+        void TransformPoints( const std::function<VECTOR2I( const VECTOR2I& )>& aTransform )
+        {
+            for( VECTOR2I& vertex : m_vertices )
+                vertex = aTransform( vertex );
+        }
+
     private:
         int                  m_sourceOutline;
         std::deque<TRI>      m_triangles;
@@ -1082,6 +1089,17 @@ public:
      */
     void Rotate( const EDA_ANGLE& aAngle, const VECTOR2I& aCenter = { 0, 0 } ) override;
 
+    /**
+     * Map all vertices through an arbitrary point transform.
+     *
+     * The transform must be affine (any combination of translation, scaling, rotation and
+     * mirroring).  Triangles stay valid under such a mapping, so a cached triangulation is
+     * transformed along with the outlines instead of being recalculated.
+     *
+     * @param aTransform maps a vertex to its new position.
+     */
+    void TransformPoints( const std::function<VECTOR2I( const VECTOR2I& )>& aTransform );
+
     /// @copydoc SHAPE::IsSolid()
     bool IsSolid() const override
     {
@@ -2258,6 +2258,25 @@ void SHAPE_POLY_SET::Rotate( const EDA_ANGLE& aAngle, const VECTOR2I& aCenter )
 }
 
 
+void SHAPE_POLY_SET::TransformPoints(
+        const std::function<VECTOR2I( const VECTOR2I& )>& aTransform )
+{
+    for( POLYGON& poly : m_polys )
+    {
+        for( SHAPE_LINE_CHAIN& path : poly )
+        {
+            for( int ii = 0; ii < path.PointCount(); ++ii )
+                path.SetPoint( ii, aTransform( path.CPoint( ii ) ) );
+        }
+    }
+
+    for( std::unique_ptr<TRIANGULATED_POLYGON>& tri : m_triangulatedPolys )
+        tri->TransformPoints( aTransform );
+
+    m_hash = checksum();
+}
+
+
 int SHAPE_POLY_SET::TotalVertices() const
 {
     int c = 0;
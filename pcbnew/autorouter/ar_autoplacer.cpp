@@ -39,8 +39,10 @@
 
 #include "ar_autoplacer.h"
 #include "ar_matrix.h"
+#include <map>
 #include <memory>
 #include <ratsnest/ratsnest_data.h>
+#include <thread_pool.h>
 
 #define AR_GAIN            16
 #define AR_KEEPOUT_MARGIN  500
@@ -398,110 +400,136 @@ void AR_AUTOPLACER::genModuleOnRoutingMatrix( FOOTPRINT* Module )
 }
 
 
-int AR_AUTOPLACER::testRectangle( const BOX2I& aRect, int side )
+void AR_AUTOPLACER::buildCellSums()
 {
-    BOX2I rect = aRect;
+    int rows = m_matrix.m_Nrows;
+    int cols = m_matrix.m_Ncols;
+    int stride = cols + 1;
 
-    rect.Inflate( m_matrix.m_GridRouting / 2 );
+    for( int side = 0; side < AR_MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        std::vector<long long>& outOfBoard = m_outOfBoardSums[side];
+        std::vector<long long>& occupied = m_occupiedSums[side];
+        std::vector<long long>& keepOut = m_keepOutSums[side];
+
+        outOfBoard.assign( (size_t) ( rows + 1 ) * stride, 0 );
+        occupied.assign( (size_t) ( rows + 1 ) * stride, 0 );
+        keepOut.assign( (size_t) ( rows + 1 ) * stride, 0 );
+
+        if( !m_matrix.m_BoardSide[side] || !m_matrix.m_DistSide[side] )
+            continue;
+
+        const AR_MATRIX::MATRIX_CELL* cells = m_matrix.m_BoardSide[side];
+        const AR_MATRIX::DIST_CELL*   dists = m_matrix.m_DistSide[side];
+
+        for( int row = 0; row < rows; row++ )
+        {
+            const AR_MATRIX::MATRIX_CELL* cellRow = cells + (size_t) row * cols;
+            const AR_MATRIX::DIST_CELL*   distRow = dists + (size_t) row * cols;
+            size_t                        above = (size_t) row * stride;
+            size_t                        here = above + stride;
+            long long                     outOfBoardRow = 0;
+            long long                     occupiedRow = 0;
+            long long                     keepOutRow = 0;
+
+            for( int col = 0; col < cols; col++ )
+            {
+                outOfBoardRow += ( cellRow[col] & CELL_IS_ZONE ) == 0;
+                occupiedRow += ( cellRow[col] & CELL_IS_MODULE ) != 0;
+                keepOutRow += distRow[col];
+
+                outOfBoard[here + col + 1] = outOfBoard[above + col + 1] + outOfBoardRow;
+                occupied[here + col + 1] = occupied[above + col + 1] + occupiedRow;
+                keepOut[here + col + 1] = keepOut[above + col + 1] + keepOutRow;
+            }
+        }
+    }
+}
 
-    VECTOR2I start = rect.GetOrigin();
-    VECTOR2I end     = rect.GetEnd();
+
+bool AR_AUTOPLACER::getCellRange( const BOX2I& aRect, int& aRowMin, int& aRowMax, int& aColMin,
+                                  int& aColMax ) const
+{
+    VECTOR2I start = aRect.GetOrigin();
+    VECTOR2I end     = aRect.GetEnd();
 
     start   -= m_matrix.m_BrdBox.GetOrigin();
     end     -= m_matrix.m_BrdBox.GetOrigin();
 
-    int row_min = start.y / m_matrix.m_GridRouting;
-    int row_max = end.y / m_matrix.m_GridRouting;
-    int col_min = start.x / m_matrix.m_GridRouting;
-    int col_max = end.x / m_matrix.m_GridRouting;
+    aRowMin = start.y / m_matrix.m_GridRouting;
+    aRowMax = end.y / m_matrix.m_GridRouting;
+    aColMin = start.x / m_matrix.m_GridRouting;
+    aColMax = end.x / m_matrix.m_GridRouting;
 
-    if( start.y > row_min * m_matrix.m_GridRouting )
-        row_min++;
+    if( start.y > aRowMin * m_matrix.m_GridRouting )
+        aRowMin++;
 
-    if( start.x > col_min * m_matrix.m_GridRouting )
-        col_min++;
+    if( start.x > aColMin * m_matrix.m_GridRouting )
+        aColMin++;
 
-    if( row_min < 0 )
-        row_min = 0;
+    if( aRowMin < 0 )
+        aRowMin = 0;
 
-    if( row_max >= ( m_matrix.m_Nrows - 1 ) )
-        row_max = m_matrix.m_Nrows - 1;
+    if( aRowMax >= ( m_matrix.m_Nrows - 1 ) )
+        aRowMax = m_matrix.m_Nrows - 1;
 
-    if( col_min < 0 )
-        col_min = 0;
+    if( aColMin < 0 )
+        aColMin = 0;
 
-    if( col_max >= ( m_matrix.m_Ncols - 1 ) )
-        col_max = m_matrix.m_Ncols - 1;
+    if( aColMax >= ( m_matrix.m_Ncols - 1 ) )
+        aColMax = m_matrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = m_matrix.GetCell( row, col, side );
+    return aRowMin <= aRowMax && aColMin <= aColMax;
+}
 
-            if( ( data & CELL_IS_ZONE ) == 0 )
-                return AR_OUT_OF_BOARD;
 
-            if( (data & CELL_IS_MODULE) )
-                return AR_OCCUIPED_BY_MODULE;
-        }
-    }
+long long AR_AUTOPLACER::cellSum( const std::vector<long long>& aSums, int aRowMin, int aRowMax,
+                                  int aColMin, int aColMax ) const
+{
+    size_t stride = m_matrix.m_Ncols + 1;
+    size_t top = (size_t) aRowMin * stride;
+    size_t bottom = (size_t) ( aRowMax + 1 ) * stride;
 
-    return AR_FREE_CELL;
+    return aSums[bottom + aColMax + 1] - aSums[top + aColMax + 1] - aSums[bottom + aColMin]
+           + aSums[top + aColMin];
 }
 
 
-unsigned int AR_AUTOPLACER::calculateKeepOutArea( const BOX2I& aRect, int side )
+int AR_AUTOPLACER::testRectangle( const BOX2I& aRect, int side ) const
 {
-    VECTOR2I start = aRect.GetOrigin();
-    VECTOR2I end = aRect.GetEnd();
-
-    start   -= m_matrix.m_BrdBox.GetOrigin();
-    end     -= m_matrix.m_BrdBox.GetOrigin();
+    BOX2I rect = aRect;
 
-    int row_min = start.y / m_matrix.m_GridRouting;
-    int row_max = end.y / m_matrix.m_GridRouting;
-    int col_min = start.x / m_matrix.m_GridRouting;
-    int col_max = end.x / m_matrix.m_GridRouting;
+    rect.Inflate( m_matrix.m_GridRouting / 2 );
 
-    if( start.y > row_min * m_matrix.m_GridRouting )
-        row_min++;
+    int row_min, row_max, col_min, col_max;
 
-    if( start.x > col_min * m_matrix.m_GridRouting )
-        col_min++;
+    if( !getCellRange( rect, row_min, row_max, col_min, col_max ) )
+        return AR_FREE_CELL;
 
-    if( row_min < 0 )
-        row_min = 0;
+    if( cellSum( m_outOfBoardSums[side], row_min, row_max, col_min, col_max ) )
+        return AR_OUT_OF_BOARD;
 
-    if( row_max >= ( m_matrix.m_Nrows - 1 ) )
-        row_max = m_matrix.m_Nrows - 1;
+    if( cellSum( m_occupiedSums[side], row_min, row_max, col_min, col_max ) )
+        return AR_OCCUIPED_BY_MODULE;
 
-    if( col_min < 0 )
-        col_min = 0;
+    return AR_FREE_CELL;
+}
 
-    if( col_max >= ( m_matrix.m_Ncols - 1 ) )
-        col_max = m_matrix.m_Ncols - 1;
 
-    unsigned int keepOutCost = 0;
+unsigned int AR_AUTOPLACER::calculateKeepOutArea( const BOX2I& aRect, int side ) const
+{
+    int row_min, row_max, col_min, col_max;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // m_matrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += m_matrix.GetDist( row, col, side );
-        }
-    }
+    if( !getCellRange( aRect, row_min, row_max, col_min, col_max ) )
+        return 0;
 
-    return keepOutCost;
+    // The "cost" of the cells inside aRect
+    return (unsigned int) cellSum( m_keepOutSums[side], row_min, row_max, col_min, col_max );
 }
 
 
 int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSide,
-                                         const VECTOR2I& aOffset )
+                                         const BOX2I& aFpBBox ) const
 {
     int side = AR_SIDE_TOP;
     int otherside = AR_SIDE_BOTTOM;
@@ -511,21 +539,16 @@ int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSid
         side = AR_SIDE_BOTTOM; otherside = AR_SIDE_TOP;
     }
 
-    BOX2I fpBBox = aFootprint->GetBoundingBox( false, false );
-    fpBBox.Move( -1*aOffset );
-
-    buildFpAreas( aFootprint, 0 );
+    BOX2I fpBBox = aFpBBox;
 
-    int diag = //testModuleByPolygon( aFootprint, side, aOffset );
-        testRectangle( fpBBox, side );
+    int diag = testRectangle( fpBBox, side );
 
     if( diag != AR_FREE_CELL )
         return diag;
 
     if( TstOtherSide )
     {
-        diag = //testModuleByPolygon( aFootprint, otherside, aOffset );
-                testRectangle( fpBBox, otherside );
+        diag = testRectangle( fpBBox, otherside );
 
         if( diag != AR_FREE_CELL )
             return diag;
@@ -540,13 +563,6 @@ int AR_AUTOPLACER::testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSid
 
 int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
 {
-    int     error = 1;
-    VECTOR2I lastPosOK;
-    double  min_cost, curr_cost, Score;
-    bool    testOtherSide;
-
-    lastPosOK = m_matrix.m_BrdBox.GetOrigin();
-
     VECTOR2I fpPos = aFootprint->GetPosition();
     BOX2I    fpBBox  = aFootprint->GetBoundingBox( false, false );
 
@@ -563,11 +579,8 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    VECTOR2I fpOffset = fpPos - m_curPosition;
-
     // Examine pads, and set testOtherSide to true if a footprint has at least 1 pad through.
-    testOtherSide = false;
+    bool testOtherSide = false;
 
     if( m_matrix.m_RoutingLayersCount > 1 )
     {
@@ -583,62 +596,109 @@ int AR_AUTOPLACER::getOptimalFPPlacement( FOOTPRINT* aFootprint )
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
+    // The matrix and the other footprints don't change while looking for the position, so
+    // everything the candidate positions have in common is gathered first.  The positions are
+    // then evaluated concurrently, one block of columns per task.
+    buildCellSums();
 
-    min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
+    std::vector<PAD_NEIGHBOURS> pads = collectPadNeighbours( aFootprint );
 
-
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    struct BEST_POSITION
     {
-        m_curPosition.y = initialPos.y;
+        VECTOR2I pos;
+        double   cost = -1.0;
+    };
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
-        {
+    auto isBetter =
+            []( const BEST_POSITION& aBest, double aScore )
+            {
+                return aBest.cost >= aScore || aBest.cost < 0;
+            };
+
+    int colCount = 0;
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            fpOffset = fpPos - m_curPosition;
-            int keepOutCost = testFootprintOnBoard( aFootprint, testOtherSide, fpOffset );
+    if( xylimit.x > initialPos.x )
+        colCount = ( xylimit.x - initialPos.x - 1 ) / m_matrix.m_GridRouting + 1;
 
-            if( keepOutCost >= 0 )    // i.e. if the footprint can be put here
+    auto evalColumns =
+            [&]( int aStart, int aEnd ) -> BEST_POSITION
             {
-                error = 0;
-                // m_frame->build_ratsnest_footprint( aFootprint ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aFootprint, fpOffset );
-                Score       = curr_cost + keepOutCost;
+                BEST_POSITION best;
+                VECTOR2I      pos;
+                BOX2I         candidateBBox = fpBBox;
 
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
+                for( int col = aStart; col < aEnd; col++ )
                 {
-                    lastPosOK   = m_curPosition;
-                    min_cost    = Score;
-/*
-                    wxString msg;
-                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                ::CoordinateToString( LastPosOK.x ),
-                                ::CoordinateToString( LastPosOK.y ) );
-                    m_frame->SetStatusText( msg );*/
+                    pos.x = initialPos.x + col * m_matrix.m_GridRouting;
+
+                    for( pos.y = initialPos.y; pos.y < xylimit.y; pos.y += m_matrix.m_GridRouting )
+                    {
+                        candidateBBox.SetOrigin( fpBBoxOrg + pos );
+                        int keepOutCost = testFootprintOnBoard( aFootprint, testOtherSide,
+                                                                candidateBBox );
+
+                        if( keepOutCost < 0 )    // i.e. if the footprint can't be put here
+                            continue;
+
+                        double score = computePlacementRatsnestCost( pads, fpPos - pos )
+                                       + keepOutCost;
+
+                        if( isBetter( best, score ) )
+                        {
+                            best.pos = pos;
+                            best.cost = score;
+                        }
+                    }
                 }
-            }
-        }
+
+                return best;
+            };
+
+    thread_pool&               tp = GetKiCadThreadPool();
+    std::vector<BEST_POSITION> blockResults;
+
+    if( colCount > 0 )
+    {
+        auto returns = tp.parallelize_loop( 0, colCount, evalColumns );
+
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+            blockResults.push_back( returns[ii].get() );
     }
 
-    // Regeneration of the modified variable.
-    m_curPosition = lastPosOK;
+    // Merge the blocks in scan order so that ties resolve as if the positions were scanned
+    // one after the other
+    BEST_POSITION best;
+    best.pos = m_matrix.m_BrdBox.GetOrigin();
 
-    m_minCost = min_cost;
-    return error;
+    for( const BEST_POSITION& block : blockResults )
+    {
+        if( block.cost >= 0 && isBetter( best, block.cost ) )
+            best = block;
+    }
+
+    m_curPosition = best.pos;
+    m_minCost = best.cost;
+
+    return best.cost < 0 ? 1 : 0;
 }
 
 
-const PAD* AR_AUTOPLACER::nearestPad( FOOTPRINT* aRefFP, PAD* aRefPad, const VECTOR2I& aOffset )
+std::vector<AR_AUTOPLACER::PAD_NEIGHBOURS>
+AR_AUTOPLACER::collectPadNeighbours( FOOTPRINT* aFootprint )
 {
-    const PAD* nearest = nullptr;
-    int64_t    nearestDist = INT64_MAX;
+    std::map<int, std::vector<VECTOR2I>> netPads;
+    std::vector<PAD_NEIGHBOURS>          neighbours;
+
+    for( PAD* pad : aFootprint->Pads() )
+    {
+        if( pad->GetNetCode() > 0 )
+            netPads[pad->GetNetCode()];
+    }
 
+    // Same order as a walk of the board, so that the first of several equally near pads wins
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
-        if ( footprint == aRefFP )
+        if ( footprint == aFootprint )
             continue;
 
         if( !m_matrix.m_BrdBox.Contains( footprint->GetPosition() ) )
@@ -646,25 +706,27 @@ const PAD* AR_AUTOPLACER::nearestPad( FOOTPRINT* aRefFP, PAD* aRefPad, const VEC
 
         for( PAD* pad: footprint->Pads() )
         {
-            if( pad->GetNetCode() != aRefPad->GetNetCode() || pad->GetNetCode() <= 0 )
-                continue;
-
-            auto dist = ( VECTOR2I( aRefPad->GetPosition() - aOffset ) -
-                          VECTOR2I( pad->GetPosition() ) ).EuclideanNorm();
+            auto it = netPads.find( pad->GetNetCode() );
 
-            if ( dist < nearestDist )
-            {
-                nearestDist = dist;
-                nearest = pad;
-            }
+            if( it != netPads.end() )
+                it->second.push_back( pad->GetPosition() );
         }
     }
 
-    return nearest;
+    for( PAD* pad : aFootprint->Pads() )
+    {
+        auto it = netPads.find( pad->GetNetCode() );
+
+        if( it != netPads.end() && !it->second.empty() )
+            neighbours.push_back( { pad->GetPosition(), it->second } );
+    }
+
+    return neighbours;
 }
 
 
-double AR_AUTOPLACER::computePlacementRatsnestCost( FOOTPRINT* aFootprint, const VECTOR2I& aOffset )
+double AR_AUTOPLACER::computePlacementRatsnestCost( const std::vector<PAD_NEIGHBOURS>& aPads,
+                                                    const VECTOR2I& aOffset ) const
 {
     double  curr_cost;
     VECTOR2I start;      // start point of a ratsnest
@@ -673,19 +735,23 @@ double AR_AUTOPLACER::computePlacementRatsnestCost( FOOTPRINT* aFootprint, const
 
     curr_cost = 0;
 
-    for( PAD* pad : aFootprint->Pads() )
+    for( const PAD_NEIGHBOURS& pad : aPads )
     {
-        const PAD* nearest = nearestPad( aFootprint, pad, aOffset );
+        start = pad.position - aOffset;
 
-        if( !nearest )
-            continue;
+        // Find the nearest pad of the same net
+        int64_t nearestDist = INT64_MAX;
 
-        start   = VECTOR2I( pad->GetPosition() ) - VECTOR2I(aOffset);
-        end     = VECTOR2I( nearest->GetPosition() );
+        for( const VECTOR2I& candidate : pad.candidates )
+        {
+            int64_t dist = ( start - candidate ).EuclideanNorm();
 
-        //m_overlay->SetIsStroke( true );
-        //m_overlay->SetStrokeColor( COLOR4D(0.0, 1.0, 0.0, 1.0) );
-        //m_overlay->Line( start, end );
+            if( dist < nearestDist )
+            {
+                nearestDist = dist;
+                end = candidate;
+            }
+        }
 
         // Cost of the ratsnest.
         dx  = end.x - start.x;
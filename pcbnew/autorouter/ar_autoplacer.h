@@ -95,11 +95,40 @@ private:
     bool fillMatrix();
     void genModuleOnRoutingMatrix( FOOTPRINT* aFootprint );
 
-    int testRectangle( const BOX2I& aRect, int side );
-    unsigned int calculateKeepOutArea( const  BOX2I& aRect, int side );
-    int testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSide, const VECTOR2I& aOffset );
+    /**
+     * Pads of the footprint being placed, with the positions of the pads of the same net on the
+     * footprints already on the board.
+     */
+    struct PAD_NEIGHBOURS
+    {
+        VECTOR2I              position;
+        std::vector<VECTOR2I> candidates;
+    };
+
+    /**
+     * Build the summed-area tables of m_matrix, so that the cells of any rectangle can be tested
+     * and their keepout cost added up in constant time.
+     */
+    void buildCellSums();
+
+    /**
+     * Convert \a aRect to the (inclusive) range of matrix cells it covers.
+     *
+     * @return false if the range is empty.
+     */
+    bool getCellRange( const BOX2I& aRect, int& aRowMin, int& aRowMax, int& aColMin,
+                       int& aColMax ) const;
+
+    long long cellSum( const std::vector<long long>& aSums, int aRowMin, int aRowMax,
+                       int aColMin, int aColMax ) const;
+
+    int testRectangle( const BOX2I& aRect, int side ) const;
+    unsigned int calculateKeepOutArea( const  BOX2I& aRect, int side ) const;
+    int testFootprintOnBoard( FOOTPRINT* aFootprint, bool TstOtherSide,
+                              const BOX2I& aFpBBox ) const;
     int getOptimalFPPlacement( FOOTPRINT* aFootprint );
-    double computePlacementRatsnestCost( FOOTPRINT* aFootprint, const VECTOR2I& aOffset );
+    double computePlacementRatsnestCost( const std::vector<PAD_NEIGHBOURS>& aPads,
+                                         const VECTOR2I& aOffset ) const;
 
     /**
      * Find the "best" footprint place. The criteria are:
@@ -110,7 +139,11 @@ private:
 
     void placeFootprint( FOOTPRINT* aFootprint, bool aDoNotRecreateRatsnest, const VECTOR2I& aPos );
 
-    const PAD* nearestPad( FOOTPRINT* aRefFP, PAD* aRefPad, const VECTOR2I& aOffset );
+    /**
+     * Collect the pads of \a aFootprint that have a net, together with the pads they would
+     * connect to (see computePlacementRatsnestCost()).
+     */
+    std::vector<PAD_NEIGHBOURS> collectPadNeighbours( FOOTPRINT* aFootprint );
 
     // Add a polygonal shape (rectangle) to m_fpAreaFront and/or m_fpAreaBack
     void addFpBody( const VECTOR2I& aStart, const VECTOR2I& aEnd, LSET aLayerMask );
@@ -123,6 +156,12 @@ private:
     void buildFpAreas( FOOTPRINT* aFootprint, int aFpClearance );
 
     AR_MATRIX m_matrix;
+
+    // Summed-area tables of m_matrix, per side, of (m_Nrows + 1) x (m_Ncols + 1) entries:
+    std::vector<long long> m_outOfBoardSums[AR_MAX_ROUTING_LAYERS_COUNT]; // cells not in board
+    std::vector<long long> m_occupiedSums[AR_MAX_ROUTING_LAYERS_COUNT];   // footprint cells
+    std::vector<long long> m_keepOutSums[AR_MAX_ROUTING_LAYERS_COUNT];    // keepout costs
+
     SHAPE_POLY_SET m_topFreeArea;       // The polygonal description of the top side free areas;
     SHAPE_POLY_SET m_bottomFreeArea;    // The polygonal description of the bottom side free areas;
     SHAPE_POLY_SET m_boardShape;        // The polygonal description of the board;
@@ -34,6 +34,7 @@
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <connectivity/from_to_cache.h>
+#include <connectivity/net_length_cache.h>
 #include <project/net_settings.h>
 #include <board_design_settings.h>
 #include <geometry/shape_segment.h>
@@ -49,12 +50,14 @@ CONNECTIVITY_DATA::CONNECTIVITY_DATA()
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_progressReporter = nullptr;
     m_fromToCache.reset( new FROM_TO_CACHE );
+    m_netLengthCache.reset( new NET_LENGTH_CACHE );
 }
 
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA( const std::vector<BOARD_ITEM*>& aItems, bool aSkipRatsnest )
     : m_skipRatsnest( aSkipRatsnest )
 {
+    m_netLengthCache.reset( new NET_LENGTH_CACHE );
     Build( aItems );
     m_progressReporter = nullptr;
     m_fromToCache.reset( new FROM_TO_CACHE );
@@ -73,6 +76,7 @@ CONNECTIVITY_DATA::~CONNECTIVITY_DATA()
 bool CONNECTIVITY_DATA::Add( BOARD_ITEM* aItem )
 {
     m_connAlgo->Add( aItem );
+    m_netLengthCache->Add( aItem );
     return true;
 }
 
@@ -80,6 +84,7 @@ bool CONNECTIVITY_DATA::Add( BOARD_ITEM* aItem )
 bool CONNECTIVITY_DATA::Remove( BOARD_ITEM* aItem )
 {
     m_connAlgo->Remove( aItem );
+    m_netLengthCache->Remove( aItem );
     return true;
 }
 
@@ -88,6 +93,8 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 {
     m_connAlgo->Remove( aItem );
     m_connAlgo->Add( aItem );
+    m_netLengthCache->Remove( aItem );
+    m_netLengthCache->Add( aItem );
     return true;
 }
 
@@ -112,6 +119,8 @@ bool CONNECTIVITY_DATA::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
     m_connAlgo->Build( aBoard, aReporter );
 
+    m_netLengthCache->Rebuild( aBoard );
+
     m_netclassMap.clear();
 
     for( NETINFO_ITEM* net : aBoard->GetNetInfo() )
@@ -228,6 +237,20 @@ void CONNECTIVITY_DATA::internalRecalculateRatsnest( BOARD_COMMIT* aCommit  )
 
     int lastNet = m_connAlgo->NetCount();
 
+    if( m_netLengthCache->IsValid() )
+    {
+        // Net propagation changes the net of items without going through Update()
+        std::vector<int> dirtyNets;
+
+        for( int net = 0; net < lastNet; net++ )
+        {
+            if( m_connAlgo->IsNetDirty( net ) )
+                dirtyNets.push_back( net );
+        }
+
+        m_netLengthCache->RefreshNets( dirtyNets );
+    }
+
     if( lastNet >= (int) m_nets.size() )
     {
         unsigned int prevSize = m_nets.size();
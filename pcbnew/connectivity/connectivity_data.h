@@ -40,6 +40,7 @@
 #include <zone.h>
 
 class FROM_TO_CACHE;
+class NET_LENGTH_CACHE;
 class CN_CLUSTER;
 class CN_CONNECTIVITY_ALGO;
 class CN_EDGE;
@@ -278,6 +279,12 @@ public:
 
     std::shared_ptr<FROM_TO_CACHE> GetFromToCache() { return m_fromToCache; }
 
+    /**
+     * Per-net routed length, via and pad-to-die totals, kept up to date by Add(), Remove() and
+     * Update().  Only valid for board connectivity built by Build( BOARD* ).
+     */
+    std::shared_ptr<NET_LENGTH_CACHE> GetNetLengthCache() { return m_netLengthCache; }
+
 private:
 
     /**
@@ -293,6 +300,7 @@ private:
     std::shared_ptr<CN_CONNECTIVITY_ALGO> m_connAlgo;
 
     std::shared_ptr<FROM_TO_CACHE>  m_fromToCache;
+    std::shared_ptr<NET_LENGTH_CACHE> m_netLengthCache;
     std::vector<RN_DYNAMIC_LINE>    m_dynamicRatsnest;
     std::vector<RN_NET*>            m_nets;
 
@@ -0,0 +1,263 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <board.h>
+#include <board_stackup_manager/board_stackup.h>
+#include <footprint.h>
+#include <math/util.h>      // for KiROUND
+#include <pad.h>
+#include <pcb_track.h>
+
+#include <connectivity/net_length_cache.h>
+
+
+int NET_LENGTH_CACHE::NET_LENGTH::ViaLength( const BOARD_STACKUP& aStackup ) const
+{
+    int total = 0;
+
+    for( const auto& [ span, count ] : viaSpans )
+        total += count * aStackup.GetLayerDistance( span.first, span.second );
+
+    return total;
+}
+
+
+void NET_LENGTH_CACHE::Rebuild( BOARD* aBoard )
+{
+    Clear();
+    m_valid = true;
+
+    for( PCB_TRACK* track : aBoard->Tracks() )
+        Add( track );
+
+    for( FOOTPRINT* footprint : aBoard->Footprints() )
+        Add( footprint );
+}
+
+
+void NET_LENGTH_CACHE::Clear()
+{
+    m_valid = false;
+    m_items.clear();
+    m_netItems.clear();
+    m_nets.clear();
+    m_footprintPads.clear();
+}
+
+
+void NET_LENGTH_CACHE::Add( BOARD_ITEM* aItem )
+{
+    if( !m_valid )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+        addItem( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
+        break;
+
+    case PCB_FOOTPRINT_T:
+    {
+        // Footprints are re-added after being changed, and may have lost some pads since
+        Remove( aItem );
+
+        FOOTPRINT*                               footprint = static_cast<FOOTPRINT*>( aItem );
+        std::vector<const BOARD_CONNECTED_ITEM*>& pads = m_footprintPads[footprint];
+
+        for( PAD* pad : footprint->Pads() )
+        {
+            addItem( pad );
+            pads.push_back( pad );
+        }
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+void NET_LENGTH_CACHE::Remove( BOARD_ITEM* aItem )
+{
+    if( !m_valid )
+        return;
+
+    if( aItem->Type() == PCB_FOOTPRINT_T )
+    {
+        auto it = m_footprintPads.find( static_cast<FOOTPRINT*>( aItem ) );
+
+        if( it == m_footprintPads.end() )
+            return;
+
+        for( const BOARD_CONNECTED_ITEM* pad : it->second )
+            removeItem( pad );
+
+        m_footprintPads.erase( it );
+    }
+    else if( aItem->IsConnected() )
+    {
+        removeItem( static_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
+    }
+}
+
+
+void NET_LENGTH_CACHE::RefreshNets( const std::vector<int>& aNets )
+{
+    if( !m_valid )
+        return;
+
+    std::vector<const BOARD_CONNECTED_ITEM*> moved;
+
+    for( int net : aNets )
+    {
+        auto netIt = m_netItems.find( net );
+
+        if( netIt == m_netItems.end() )
+            continue;
+
+        for( const BOARD_CONNECTED_ITEM* item : netIt->second )
+        {
+            if( item->GetNetCode() != net )
+                moved.push_back( item );
+        }
+    }
+
+    for( const BOARD_CONNECTED_ITEM* item : moved )
+    {
+        ITEM_LENGTH& length = m_items.at( item );
+
+        accumulate( length, -1 );
+        m_netItems[length.net].erase( item );
+
+        length.net = item->GetNetCode();
+
+        accumulate( length, 1 );
+        m_netItems[length.net].insert( item );
+    }
+}
+
+
+bool NET_LENGTH_CACHE::GetNetLength( int aNetCode, NET_LENGTH& aLength ) const
+{
+    if( !m_valid )
+        return false;
+
+    auto it = m_nets.find( aNetCode );
+
+    if( it != m_nets.end() )
+        aLength = it->second;
+    else
+        aLength = NET_LENGTH();
+
+    return true;
+}
+
+
+void NET_LENGTH_CACHE::addItem( const BOARD_CONNECTED_ITEM* aItem )
+{
+    // Items are re-added after being changed
+    removeItem( aItem );
+
+    ITEM_LENGTH length = { aItem->Type(), aItem->GetNetCode(), 0, 0, UNDEFINED_LAYER,
+                           UNDEFINED_LAYER };
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+        // Rounded so that the totals don't drift as lengths are added and subtracted
+        length.length = KiROUND( static_cast<const PCB_TRACK*>( aItem )->GetLength() );
+        break;
+
+    case PCB_VIA_T:
+    {
+        const PCB_VIA* via = static_cast<const PCB_VIA*>( aItem );
+
+        length.viaTop = via->TopLayer();
+        length.viaBottom = via->BottomLayer();
+        break;
+    }
+
+    case PCB_PAD_T:
+        length.padToDie = static_cast<const PAD*>( aItem )->GetPadToDieLength();
+        break;
+
+    default:
+        return;
+    }
+
+    m_items[aItem] = length;
+    m_netItems[length.net].insert( aItem );
+    accumulate( length, 1 );
+}
+
+
+void NET_LENGTH_CACHE::removeItem( const BOARD_CONNECTED_ITEM* aItem )
+{
+    auto it = m_items.find( aItem );
+
+    if( it == m_items.end() )
+        return;
+
+    accumulate( it->second, -1 );
+    m_netItems[it->second.net].erase( aItem );
+    m_items.erase( it );
+}
+
+
+void NET_LENGTH_CACHE::accumulate( const ITEM_LENGTH& aLength, int aSign )
+{
+    NET_LENGTH& net = m_nets[aLength.net];
+
+    switch( aLength.type )
+    {
+    case PCB_TRACE_T:
+    case PCB_ARC_T:
+        net.trackLength += aSign * aLength.length;
+        net.trackCount += aSign;
+        break;
+
+    case PCB_VIA_T:
+    {
+        auto span = std::make_pair( aLength.viaTop, aLength.viaBottom );
+        int& count = net.viaSpans[span];
+
+        count += aSign;
+        net.viaCount += aSign;
+
+        if( count == 0 )
+            net.viaSpans.erase( span );
+
+        break;
+    }
+
+    case PCB_PAD_T:
+        net.padToDieLength += aSign * aLength.padToDie;
+        net.padCount += aSign;
+        break;
+
+    default:
+        break;
+    }
+}
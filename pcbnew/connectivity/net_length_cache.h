@@ -0,0 +1,126 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NET_LENGTH_CACHE_H
+#define NET_LENGTH_CACHE_H
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <core/typeinfo.h>
+#include <layer_ids.h>
+
+class BOARD;
+class BOARD_ITEM;
+class BOARD_CONNECTED_ITEM;
+class BOARD_STACKUP;
+class FOOTPRINT;
+
+
+/**
+ * Per-net totals of the routed length, via count and span and pad-to-die length of a board.
+ *
+ * The totals are kept up to date by CONNECTIVITY_DATA as items are added, removed and changed,
+ * so that the length-constrained DRC and the net info panel can look them up without walking
+ * the net.  The cache is only valid once the board connectivity has been built; it ignores the
+ * items of local (preview) connectivity data.
+ */
+class NET_LENGTH_CACHE
+{
+public:
+    struct NET_LENGTH
+    {
+        long long trackLength = 0;      ///< sum of the track and arc lengths, each rounded
+        int       trackCount = 0;       ///< number of tracks and arcs
+        int       viaCount = 0;
+        int       padCount = 0;
+        long long padToDieLength = 0;
+
+        ///< number of vias per (top, bottom) layer span
+        std::map<std::pair<PCB_LAYER_ID, PCB_LAYER_ID>, int> viaSpans;
+
+        /**
+         * @return the total height of the vias of the net in \a aStackup.
+         */
+        int ViaLength( const BOARD_STACKUP& aStackup ) const;
+    };
+
+    NET_LENGTH_CACHE() :
+        m_valid( false )
+    {
+    }
+
+    void Rebuild( BOARD* aBoard );
+    void Clear();
+
+    bool IsValid() const { return m_valid; }
+
+    /**
+     * Record a track, arc, via, pad or all the pads of a footprint, replacing what was recorded
+     * for it before.
+     */
+    void Add( BOARD_ITEM* aItem );
+
+    /**
+     * Forget an item previously passed to Add().  Footprints forget the pads they had when they
+     * were added, even if some of them have been deleted since.
+     */
+    void Remove( BOARD_ITEM* aItem );
+
+    /**
+     * Move the items recorded under \a aNets that have since changed net (e.g. by net
+     * propagation) to their current net.
+     */
+    void RefreshNets( const std::vector<int>& aNets );
+
+    /**
+     * Fetch the totals of net \a aNetCode.
+     *
+     * @return false if the cache hasn't been built.
+     */
+    bool GetNetLength( int aNetCode, NET_LENGTH& aLength ) const;
+
+private:
+    struct ITEM_LENGTH
+    {
+        KICAD_T      type;
+        int          net;
+        long long    length;            ///< track or arc length
+        int          padToDie;
+        PCB_LAYER_ID viaTop;            ///< UNDEFINED_LAYER for anything but vias
+        PCB_LAYER_ID viaBottom;
+    };
+
+    void addItem( const BOARD_CONNECTED_ITEM* aItem );
+    void removeItem( const BOARD_CONNECTED_ITEM* aItem );
+    void accumulate( const ITEM_LENGTH& aLength, int aSign );
+
+private:
+    bool m_valid;
+
+    std::unordered_map<const BOARD_CONNECTED_ITEM*, ITEM_LENGTH>                   m_items;
+    std::unordered_map<int, std::unordered_set<const BOARD_CONNECTED_ITEM*>>       m_netItems;
+    std::unordered_map<int, NET_LENGTH>                                            m_nets;
+    std::unordered_map<const FOOTPRINT*, std::vector<const BOARD_CONNECTED_ITEM*>> m_footprintPads;
+};
+
+#endif
@@ -93,6 +93,9 @@ bool DRC_CACHE_GENERATOR::Run()
                 return true;
             };
 
+    // Items are gathered per layer so each layer's tree can be packed in a single pass
+    std::map<PCB_LAYER_ID, std::vector<BOARD_ITEM*>> copperItems;
+
     auto addToCopperTree =
             [&]( BOARD_ITEM* item ) -> bool
             {
@@ -113,7 +116,7 @@ bool DRC_CACHE_GENERATOR::Run()
                 for( PCB_LAYER_ID layer : copperLayers.Seq() )
                 {
                     if( IsCopperLayer( layer ) )
-                        m_board->m_CopperItemRTreeCache->Insert( item, layer, largestClearance );
+                        copperItems[layer].push_back( item );
                 }
 
                 return true;
@@ -133,6 +136,9 @@ bool DRC_CACHE_GENERATOR::Run()
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), countItems );
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
 
+    for( const auto& [layer, items] : copperItems )
+        m_board->m_CopperItemRTreeCache->BulkLoad( items, layer, largestClearance );
+
     if( !reportPhase( _( "Tessellating copper zones..." ) ) )
         return false;   // DRC cancelled
 
@@ -164,7 +170,7 @@ bool DRC_CACHE_GENERATOR::Run()
                    for( PCB_LAYER_ID layer : aZone->GetLayerSet().Seq() )
                    {
                        if( IsCopperLayer( layer ) )
-                           rtree->Insert( aZone, layer );
+                           rtree->BulkLoad( { aZone }, layer );
                    }
 
                    std::unique_lock<std::mutex> cacheLock( m_board->m_CachesMutex );
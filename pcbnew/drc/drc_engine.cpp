@@ -1679,6 +1679,93 @@ bool DRC_ENGINE::HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID )
 }
 
 
+/**
+ * @return true if the rule condition \a aExpression only reads the net name or class of A.
+ *
+ * This is a lexical check, so it may refuse conditions which would qualify.
+ */
+static bool isNetOnlyCondition( const wxString& aExpression )
+{
+    const std::set<wxString> netFields = { wxS( "netclass" ), wxS( "netname" ),
+                                           wxS( "indiffpair" ) };
+
+    size_t len = aExpression.length();
+    bool   expectField = false;
+
+    for( size_t i = 0; i < len; )
+    {
+        wxUniChar ch = aExpression[i];
+
+        if( ch == '\'' || ch == '"' )
+        {
+            // Skip string literals
+            for( i++; i < len && aExpression[i] != ch; i++ )
+                ;
+
+            i++;
+            continue;
+        }
+
+        if( !wxIsalpha( ch ) && ch != '_' )
+        {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+
+        while( i < len && ( wxIsalnum( aExpression[i] ) || aExpression[i] == '_' ) )
+            i++;
+
+        wxString ident = aExpression.Mid( start, i - start );
+
+        // Units of numeric values (e.g. "0.2mm")
+        if( start > 0 && wxIsdigit( aExpression[start - 1] ) )
+            continue;
+
+        if( expectField )
+        {
+            if( !netFields.count( ident.Lower() ) )
+                return false;
+
+            expectField = false;
+            continue;
+        }
+
+        size_t next = i;
+
+        while( next < len && wxIsspace( aExpression[next] ) )
+            next++;
+
+        if( ident != wxS( "A" ) || next >= len || aExpression[next] != '.' )
+            return false;
+
+        expectField = true;
+        i = next + 1;
+    }
+
+    return !expectField;
+}
+
+
+bool DRC_ENGINE::RulesDependOnNetOnly( DRC_CONSTRAINT_T aConstraintType )
+{
+    if( !m_constraintMap.count( aConstraintType ) )
+        return true;
+
+    for( DRC_ENGINE_CONSTRAINT* c : *m_constraintMap[aConstraintType] )
+    {
+        if( ( c->layerTest & LSET::AllCuMask() ) != LSET::AllCuMask() )
+            return false;
+
+        if( c->condition && !isNetOnlyCondition( c->condition->GetExpression() ) )
+            return false;
+    }
+
+    return true;
+}
+
+
 bool DRC_ENGINE::QueryWorstConstraint( DRC_CONSTRAINT_T aConstraintId, DRC_CONSTRAINT& aConstraint )
 {
     int worst = 0;
@@ -159,6 +159,13 @@ public:
 
     bool HasRulesForConstraintType( DRC_CONSTRAINT_T constraintID );
 
+    /**
+     * @return true if the rules for \a aConstraintType resolve to the same constraint for all
+     *         the copper items of a net: they apply to all copper layers and their conditions
+     *         only test the net name or class of A.
+     */
+    bool RulesDependOnNetOnly( DRC_CONSTRAINT_T aConstraintType );
+
     bool GetReportAllTrackErrors() const { return m_reportAllTrackErrors; }
     bool GetTestFootprints() const { return m_testFootprints; }
 
@@ -115,49 +115,53 @@ public:
     {
         wxCHECK( aTargetLayer != UNDEFINED_LAYER, /* void */ );
 
-        if( aItem->Type() == PCB_FP_TEXT_T && !static_cast<FP_TEXT*>( aItem )->IsVisible() )
-            return;
+        forEachShape( aItem, aRefLayer, aWorstClearance,
+                [&]( const BOX2I& aBBox, ITEM_WITH_SHAPE* aItemShape )
+                {
+                    const int mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+                    const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
 
-        std::vector<const SHAPE*> subshapes;
-        std::shared_ptr<SHAPE> shape = aItem->GetEffectiveShape( aRefLayer );
+                    m_tree[aTargetLayer]->Insert( mmin, mmax, aItemShape );
+                    m_count++;
+                } );
+    }
 
-        if( shape->HasIndexableSubshapes() )
-            shape->GetIndexableSubshapes( subshapes );
-        else
-            subshapes.push_back( shape.get() );
+    /**
+     * Insert a set of items into the tree on a particular layer with an optional worst clearance.
+     *
+     * An empty layer is packed in a single pass, which is much faster than inserting the items
+     * one by one when there are many of them (such as all the triangles of a zone fill).
+     */
+    void BulkLoad( const std::vector<BOARD_ITEM*>& aItems, PCB_LAYER_ID aLayer,
+                   int aWorstClearance = 0 )
+    {
+        wxCHECK( aLayer != UNDEFINED_LAYER, /* void */ );
 
-        for( const SHAPE* subshape : subshapes )
+        // Packing would drop what's already there
+        if( m_tree[aLayer]->Count() > 0 )
         {
-            if( dynamic_cast<const SHAPE_NULL*>( subshape ) )
-                continue;
+            for( BOARD_ITEM* item : aItems )
+                Insert( item, aLayer, aLayer, aWorstClearance );
 
-            BOX2I bbox = subshape->BBox();
-
-            bbox.Inflate( aWorstClearance );
-
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, subshape, shape );
-
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+            return;
         }
 
-        if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
-        {
-            std::shared_ptr<SHAPE_SEGMENT> hole = aItem->GetEffectiveHoleShape();
-            BOX2I                          bbox = hole->BBox();
-
-            bbox.Inflate( aWorstClearance );
-
-            const int        mmin[2] = { bbox.GetX(), bbox.GetY() };
-            const int        mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
-            ITEM_WITH_SHAPE* itemShape = new ITEM_WITH_SHAPE( aItem, hole, shape );
+        std::vector<std::pair<drc_rtree::Rect, ITEM_WITH_SHAPE*>> entries;
 
-            m_tree[aTargetLayer]->Insert( mmin, mmax, itemShape );
-            m_count++;
+        for( BOARD_ITEM* item : aItems )
+        {
+            forEachShape( item, aLayer, aWorstClearance,
+                    [&]( const BOX2I& aBBox, ITEM_WITH_SHAPE* aItemShape )
+                    {
+                        drc_rtree::Rect rect = { { aBBox.GetX(), aBBox.GetY() },
+                                                 { aBBox.GetRight(), aBBox.GetBottom() } };
 
+                        entries.emplace_back( rect, aItemShape );
+                    } );
         }
+
+        m_tree[aLayer]->BulkLoad( entries );
+        m_count += entries.size();
     }
 
     /**
@@ -577,6 +581,48 @@ public:
 
 
 private:
+    /**
+     * Call \a aFunc with the clearance-inflated bounding box and a new ITEM_WITH_SHAPE for each
+     * indexable subshape of \a aItem, and for its hole if it is a pad.
+     */
+    template <typename Func>
+    void forEachShape( BOARD_ITEM* aItem, PCB_LAYER_ID aRefLayer, int aWorstClearance,
+                       Func aFunc ) const
+    {
+        if( aItem->Type() == PCB_FP_TEXT_T && !static_cast<FP_TEXT*>( aItem )->IsVisible() )
+            return;
+
+        std::vector<const SHAPE*> subshapes;
+        std::shared_ptr<SHAPE> shape = aItem->GetEffectiveShape( aRefLayer );
+
+        if( shape->HasIndexableSubshapes() )
+            shape->GetIndexableSubshapes( subshapes );
+        else
+            subshapes.push_back( shape.get() );
+
+        for( const SHAPE* subshape : subshapes )
+        {
+            if( dynamic_cast<const SHAPE_NULL*>( subshape ) )
+                continue;
+
+            BOX2I bbox = subshape->BBox();
+
+            bbox.Inflate( aWorstClearance );
+
+            aFunc( bbox, new ITEM_WITH_SHAPE( aItem, subshape, shape ) );
+        }
+
+        if( aItem->Type() == PCB_PAD_T && aItem->HasHole() )
+        {
+            std::shared_ptr<SHAPE_SEGMENT> hole = aItem->GetEffectiveHoleShape();
+            BOX2I                          bbox = hole->BBox();
+
+            bbox.Inflate( aWorstClearance );
+
+            aFunc( bbox, new ITEM_WITH_SHAPE( aItem, hole, shape ) );
+        }
+    }
+
     drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
     size_t      m_count;
 };
@@ -30,6 +30,7 @@
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/from_to_cache.h>
+#include <connectivity/net_length_cache.h>
 
 #include <pcb_expr_evaluator.h>
 
@@ -232,43 +233,87 @@ bool DRC_TEST_PROVIDER_MATCHED_LENGTH::runInternal( bool aDelayReportMode )
     size_t       count = 0;
     size_t       ii = 0;
 
-    forEachGeometryItem( { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T }, LSET::AllCuMask(),
-            [&]( BOARD_ITEM *item ) -> bool
-            {
-                count++;
-                return true;
-            } );
+    const DRC_CONSTRAINT_T constraintsToCheck[] = {
+            LENGTH_CONSTRAINT,
+            SKEW_CONSTRAINT,
+            VIA_COUNT_CONSTRAINT,
+    };
+
+    std::shared_ptr<CONNECTIVITY_DATA> connectivity = m_board->GetConnectivity();
+    std::shared_ptr<NET_LENGTH_CACHE>  lengthCache = connectivity->GetNetLengthCache();
+
+    // When the rules can't tell the items of a net apart, they are resolved once per net and
+    // always cover whole nets, whose totals are then all taken from the length cache
+    bool perNet = lengthCache->IsValid();
+
+    for( DRC_CONSTRAINT_T constraintType : constraintsToCheck )
+        perNet = perNet && m_drcEngine->RulesDependOnNetOnly( constraintType );
+
+    if( perNet )
+    {
+        count = m_board->GetNetInfo().GetNetCount();
+
+        for( NETINFO_ITEM* net : m_board->GetNetInfo() )
+        {
+            if( !reportProgress( ii++, count, progressDelta ) )
+                return false;
 
-    forEachGeometryItem( { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T }, LSET::AllCuMask(),
-            [&]( BOARD_ITEM *item ) -> bool
+            std::vector<BOARD_CONNECTED_ITEM*> items =
+                    connectivity->GetNetItems( net->GetNetCode(),
+                                               { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T } );
+
+            if( items.empty() )
+                continue;
+
+            for( DRC_CONSTRAINT_T constraintType : constraintsToCheck )
             {
-                if( !reportProgress( ii++, count, progressDelta ) )
-                    return false;
+                auto constraint = m_drcEngine->EvalRules( constraintType, items.front(), nullptr,
+                                                          items.front()->GetLayer() );
 
-                const DRC_CONSTRAINT_T constraintsToCheck[] = {
-                        LENGTH_CONSTRAINT,
-                        SKEW_CONSTRAINT,
-                        VIA_COUNT_CONSTRAINT,
-                };
+                if( constraint.IsNull() )
+                    continue;
 
-                for( int i = 0; i < 3; i++ )
+                itemSets[ constraint.GetParentRule() ].insert( items.begin(), items.end() );
+            }
+        }
+    }
+    else
+    {
+        forEachGeometryItem( { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T }, LSET::AllCuMask(),
+                [&]( BOARD_ITEM *item ) -> bool
                 {
-                    auto constraint = m_drcEngine->EvalRules( constraintsToCheck[i], item, nullptr,
-                                                              item->GetLayer() );
+                    count++;
+                    return true;
+                } );
 
-                    if( constraint.IsNull() )
-                        continue;
+        forEachGeometryItem( { PCB_TRACE_T, PCB_ARC_T, PCB_VIA_T }, LSET::AllCuMask(),
+                [&]( BOARD_ITEM *item ) -> bool
+                {
+                    if( !reportProgress( ii++, count, progressDelta ) )
+                        return false;
 
-                    auto citem = static_cast<BOARD_CONNECTED_ITEM*>( item );
+                    for( DRC_CONSTRAINT_T constraintType : constraintsToCheck )
+                    {
+                        auto constraint = m_drcEngine->EvalRules( constraintType, item, nullptr,
+                                                                  item->GetLayer() );
 
-                    itemSets[ constraint.GetParentRule() ].insert( citem );
-                }
+                        if( constraint.IsNull() )
+                            continue;
 
-                return true;
-            } );
+                        auto citem = static_cast<BOARD_CONNECTED_ITEM*>( item );
+
+                        itemSets[ constraint.GetParentRule() ].insert( citem );
+                    }
+
+                    return true;
+                } );
+    }
 
     std::map< DRC_RULE*, std::vector<CONNECTION> > matches;
 
+    const BOARD_DESIGN_SETTINGS&      bds = m_board->GetDesignSettings();
+    const BOARD_STACKUP&              stackup = bds.GetStackupDescriptor();
+
     for( const std::pair< DRC_RULE* const, std::set<BOARD_CONNECTED_ITEM*> >& it : itemSets )
     {
         std::map<int, std::set<BOARD_CONNECTED_ITEM*> > netMap;
@@ -290,33 +335,47 @@ bool DRC_TEST_PROVIDER_MATCHED_LENGTH::runInternal( bool aDelayReportMode )
             ent.fromItem = nullptr;
             ent.toItem = nullptr;
 
-            for( BOARD_CONNECTED_ITEM* citem : nitem.second )
+            NET_LENGTH_CACHE::NET_LENGTH netLength;
+
+            // The items are tracks, arcs and vias of the net, so if there are as many of them as
+            // the net has then the rule covers the whole net and the cached totals apply
+            if( lengthCache->GetNetLength( ent.netcode, netLength )
+                    && (int) nitem.second.size() == netLength.trackCount + netLength.viaCount )
             {
-                if( citem->Type() == PCB_VIA_T )
+                ent.viaCount = netLength.viaCount;
+                ent.totalRoute = (int) netLength.trackLength;
+
+                if( bds.m_UseHeightForLengthCalcs )
+                    ent.totalVia = netLength.ViaLength( stackup );
+            }
+            else
+            {
+                for( BOARD_CONNECTED_ITEM* citem : nitem.second )
                 {
-                    const BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
-                    const BOARD_STACKUP&         stackup = bds.GetStackupDescriptor();
+                    if( citem->Type() == PCB_VIA_T )
+                    {
+                        ent.viaCount++;
 
-                    ent.viaCount++;
+                        if( bds.m_UseHeightForLengthCalcs )
+                        {
+                            const PCB_VIA* v = static_cast<PCB_VIA*>( citem );
 
-                    if( bds.m_UseHeightForLengthCalcs )
+                            ent.totalVia += stackup.GetLayerDistance( v->TopLayer(),
+                                                                      v->BottomLayer() );
+                        }
+                    }
+                    else if( citem->Type() == PCB_TRACE_T )
                     {
-                        const PCB_VIA* v = static_cast<PCB_VIA*>( citem );
-
-                        ent.totalVia += stackup.GetLayerDistance( v->TopLayer(), v->BottomLayer() );
+                        ent.totalRoute += static_cast<PCB_TRACK*>( citem )->GetLength();
+                    }
+                    else if ( citem->Type() == PCB_ARC_T )
+                    {
+                        ent.totalRoute += static_cast<PCB_ARC*>( citem )->GetLength();
+                    }
+                    else if( citem->Type() == PCB_PAD_T )
+                    {
+                        ent.totalPadToDie += static_cast<PAD*>( citem )->GetPadToDieLength();
                     }
-                }
-                else if( citem->Type() == PCB_TRACE_T )
-                {
-                    ent.totalRoute += static_cast<PCB_TRACK*>( citem )->GetLength();
-                }
-                else if ( citem->Type() == PCB_ARC_T )
-                {
-                    ent.totalRoute += static_cast<PCB_ARC*>( citem )->GetLength();
-                }
-                else if( citem->Type() == PCB_PAD_T )
-                {
-                    ent.totalPadToDie += static_cast<PAD*>( citem )->GetPadToDieLength();
                 }
             }
 
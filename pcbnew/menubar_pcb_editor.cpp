@@ -368,6 +368,7 @@ void PCB_EDIT_FRAME::doReCreateMenuBar()
     routeMenu->AppendSeparator();
     routeMenu->Add( PCB_ACTIONS::routeSingleTrack );
     routeMenu->Add( PCB_ACTIONS::routeDiffPair );
+    routeMenu->Add( PCB_ACTIONS::routerAutorouteUnconnected );
 
     routeMenu->AppendSeparator();
     routeMenu->Add( PCB_ACTIONS::routerTuneSingleTrace );
@@ -34,6 +34,7 @@
 #include <board.h>
 #include <board_design_settings.h>
 #include <connectivity/connectivity_data.h>
+#include <connectivity/net_length_cache.h>
 #include <footprint.h>
 #include <pcb_track.h>
 #include <pad.h>
@@ -95,12 +96,23 @@ void NETINFO_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANE
         int        count      = 0;
         PCB_TRACK* startTrack = nullptr;
 
-        for( FOOTPRINT* footprint : board->Footprints() )
+        NET_LENGTH_CACHE::NET_LENGTH netLength;
+        bool cached = board->GetConnectivity()->GetNetLengthCache()->GetNetLength( GetNetCode(),
+                                                                                  netLength );
+
+        if( cached )
+        {
+            count = netLength.padCount;
+        }
+        else
         {
-            for( PAD* pad : footprint->Pads() )
+            for( FOOTPRINT* footprint : board->Footprints() )
             {
-                if( pad->GetNetCode() == GetNetCode() )
-                    count++;
+                for( PAD* pad : footprint->Pads() )
+                {
+                    if( pad->GetNetCode() == GetNetCode() )
+                        count++;
+                }
             }
         }
 
@@ -116,9 +128,16 @@ void NETINFO_ITEM::GetMsgPanelInfo( EDA_DRAW_FRAME* aFrame, std::vector<MSG_PANE
                     count++;
                 else if( !startTrack )
                     startTrack = track;
+
+                // The cache has the via count, so only the first track is needed
+                if( cached && startTrack )
+                    break;
             }
         }
 
+        if( cached )
+            count = netLength.viaCount;
+
         aList.emplace_back( _( "Vias" ), wxString::Format( wxT( "%d" ), count ) );
 
         if( startTrack )
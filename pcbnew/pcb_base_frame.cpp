@@ -90,6 +90,15 @@ PCB_BASE_FRAME::~PCB_BASE_FRAME()
     // Ensure m_canvasType is up to date, to save it in config
     m_canvasType = GetCanvas()->GetBackend();
 
+    // Tools are destroyed after the board, don't let them reach it once it is gone
+    if( m_toolManager )
+    {
+        m_toolManager->SetEnvironment( nullptr, m_toolManager->GetView(),
+                                       m_toolManager->GetViewControls(),
+                                       m_toolManager->GetSettings(),
+                                       m_toolManager->GetToolHolder() );
+    }
+
     delete m_pcb;
     m_pcb = nullptr;
 }
@@ -65,6 +65,7 @@
 #include <kiface_base.h>
 #include <gr_text.h>
 #include <pgm_base.h>
+#include <advanced_config.h>
 
 using namespace KIGFX;
 
@@ -655,6 +656,47 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
     return true;
 }
 
+void PCB_PAINTER::PrepareDraw( const VIEW_ITEM* aItem ) const
+{
+    const BOARD_ITEM* item = dynamic_cast<const BOARD_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    switch( item->Type() )
+    {
+    case PCB_SHAPE_T:
+    case PCB_FP_SHAPE_T:
+    {
+        PCB_SHAPE* shape = static_cast<PCB_SHAPE*>( const_cast<BOARD_ITEM*>( item ) );
+
+        // See draw( const PCB_SHAPE* ): filled polygons are drawn from their triangulation
+        if( shape->GetShape() == SHAPE_T::POLY && shape->IsFilled() && m_gal->IsOpenGlEngine() )
+        {
+            SHAPE_POLY_SET& poly = shape->GetPolyShape();
+
+            if( poly.OutlineCount() > 0 && !poly.IsTriangulationUpToDate() )
+                poly.CacheTriangulation( true, true );
+        }
+
+        break;
+    }
+
+    case PCB_PAD_T:
+    {
+        const PAD* pad = static_cast<const PAD*>( item );
+
+        // Both are built lazily under the pad's own lock
+        pad->GetEffectiveShape();
+        pad->GetEffectivePolygon();
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
 
 void PCB_PAINTER::draw( const PCB_TRACK* aTrack, int aLayer )
 {
@@ -974,6 +1016,14 @@ void PCB_PAINTER::draw( const PCB_VIA* aVia, int aLayer )
     }
     else if( aLayer == LAYER_VIA_HOLES )
     {
+        // Not visible in vias drawn as boxes (see below)
+        if( !outline_mode
+                && isBelowDetailThreshold( aVia->GetWidth(),
+                                           ADVANCED_CFG::GetCfg().m_LODItemMinPixels ) )
+        {
+            return;
+        }
+
         m_gal->SetIsStroke( false );
         m_gal->SetIsFill( true );
         m_gal->DrawCircle( center, getViaDrillSize( aVia ) / 2.0 );
@@ -1005,8 +1055,21 @@ void PCB_PAINTER::draw( const PCB_VIA* aVia, int aLayer )
             radius -= annular_width / 2.0;
         }
 
-        if( draw )
+        if( draw && !outline_mode
+                && isBelowDetailThreshold( aVia->GetWidth(),
+                                           ADVANCED_CFG::GetCfg().m_LODItemMinPixels ) )
+        {
+            // Too small to make out the hole; a box is cheaper to draw than the annulus
+            VECTOR2I halfSize( aVia->GetWidth() / 2, aVia->GetWidth() / 2 );
+
+            m_gal->SetIsStroke( false );
+            m_gal->SetIsFill( true );
+            m_gal->DrawRectangle( center - halfSize, center + halfSize );
+        }
+        else if( draw )
+        {
             m_gal->DrawCircle( center, radius );
+        }
     }
     else if( aLayer == LAYER_VIA_BBLIND || aLayer == LAYER_VIA_MICROVIA )
     {
@@ -1364,6 +1427,21 @@ void PCB_PAINTER::draw( const PAD* aPad, int aLayer )
             break;
         }
 
+        BOX2I bbox = aPad->GetBoundingBox();
+
+        // Pads too small to make out their shape are drawn as their bounding box
+        if( !outline_mode
+                && isBelowDetailThreshold( std::max( bbox.GetWidth(), bbox.GetHeight() ),
+                                           ADVANCED_CFG::GetCfg().m_LODItemMinPixels ) )
+        {
+            bbox.Inflate( margin.x, margin.y );
+
+            if( bbox.GetWidth() > 0 && bbox.GetHeight() > 0 )
+                m_gal->DrawRectangle( bbox.GetOrigin(), bbox.GetEnd() );
+
+            return;
+        }
+
         std::unique_ptr<PAD>            dummyPad;
         std::shared_ptr<SHAPE_COMPOUND> shapes;
 
@@ -1879,6 +1957,12 @@ void PCB_PAINTER::strokeText( const wxString& aText, const VECTOR2I& aPosition,
     if( !font )
         font = KIFONT::FONT::GetFont( wxEmptyString, aAttrs.m_Bold, aAttrs.m_Italic );
 
+    if( isBelowDetailThreshold( aAttrs.m_Size.y, ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+    {
+        drawTextBar( aText, aPosition, aAttrs, font );
+        return;
+    }
+
     m_gal->SetIsFill( font->IsOutline() );
     m_gal->SetIsStroke( font->IsStroke() );
 
@@ -2013,8 +2097,13 @@ void PCB_PAINTER::draw( const PCB_TEXT* aText, int aLayer )
 
         std::vector<std::unique_ptr<KIFONT::GLYPH>>* cache = nullptr;
 
-        if( font->IsOutline() )
+        // Text too small to read is drawn as a bar by strokeText()
+        if( font->IsOutline()
+                && !isBelowDetailThreshold( attrs.m_Size.y,
+                                            ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+        {
             cache = aText->GetRenderCache( font, resolvedText );
+        }
 
         if( cache )
         {
@@ -2179,8 +2268,13 @@ void PCB_PAINTER::draw( const FP_TEXT* aText, int aLayer )
 
         std::vector<std::unique_ptr<KIFONT::GLYPH>>* cache = nullptr;
 
-        if( font->IsOutline() )
+        // Text too small to read is drawn as a bar by strokeText()
+        if( font->IsOutline()
+                && !isBelowDetailThreshold( attrs.m_Size.y,
+                                            ADVANCED_CFG::GetCfg().m_LODTextMinPixels ) )
+        {
             cache = aText->GetRenderCache( font, resolvedText );
+        }
 
         if( cache )
         {
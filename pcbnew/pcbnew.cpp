@@ -38,6 +38,7 @@
 #include <footprint_editor_settings.h>
 #include <settings/settings_manager.h>
 #include <settings/cvpcb_settings.h>
+#include <startup_trace.h>
 #include <fp_lib_table.h>
 #include <footprint_edit_frame.h>
 #include <footprint_viewer_frame.h>
@@ -398,6 +399,8 @@ bool IFACE::loadGlobalLibTable()
             // The global table is not related to a specific project.  All projects
             // will use the same global table.  So the KIFACE::OnKifaceStart() contract
             // of avoiding anything project specific is not violated here.
+            SCOPED_STARTUP_TRACE( "FP_LIB_TABLE::LoadGlobalTable", "libraries" );
+
             if( !FP_LIB_TABLE::LoadGlobalTable( GFootprintTable ) )
                 return false;
         }
@@ -0,0 +1,467 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include <geometry/direction45.h>
+#include <profile.h>
+#include <progress_reporter.h>
+
+#include "pns_batch_router.h"
+#include "pns_debug_decorator.h"
+#include "pns_node.h"
+#include "pns_optimizer.h"
+#include "pns_placement_algo.h"
+#include "pns_router.h"
+#include "pns_sizes_settings.h"
+#include "pns_walkaround.h"
+
+namespace PNS {
+
+
+BATCH_ROUTER::BATCH_ROUTER( ROUTER* aRouter ) :
+        m_router( aRouter ),
+        m_reporter( nullptr )
+{
+}
+
+
+std::vector<std::vector<int>>
+BATCH_ROUTER::FindRegions( const std::vector<CONNECTION>& aConnections, int aMargin )
+{
+    std::vector<BOX2I> boxes;
+    std::vector<int>   parent( aConnections.size() );
+    std::vector<int>   order( aConnections.size() );
+
+    for( const CONNECTION& conn : aConnections )
+    {
+        BOX2I box( conn.start );
+        box.Merge( conn.end );
+        box.Inflate( aMargin );
+        boxes.push_back( box );
+    }
+
+    std::iota( parent.begin(), parent.end(), 0 );
+    std::iota( order.begin(), order.end(), 0 );
+
+    auto find =
+            [&]( int aIndex )
+            {
+                while( parent[aIndex] != aIndex )
+                {
+                    parent[aIndex] = parent[parent[aIndex]];
+                    aIndex = parent[aIndex];
+                }
+
+                return aIndex;
+            };
+
+    // Sweep along X, only comparing the boxes whose X spans overlap
+    std::sort( order.begin(), order.end(),
+               [&]( int a, int b )
+               {
+                   return boxes[a].GetLeft() < boxes[b].GetLeft();
+               } );
+
+    for( size_t i = 0; i < order.size(); i++ )
+    {
+        const BOX2I& box = boxes[order[i]];
+
+        for( size_t j = i + 1; j < order.size() && boxes[order[j]].GetLeft() <= box.GetRight();
+             j++ )
+        {
+            if( box.Intersects( boxes[order[j]] ) )
+                parent[find( order[j] )] = find( order[i] );
+        }
+    }
+
+    std::map<int, int>            regionIndex;
+    std::vector<std::vector<int>> regions;
+
+    for( int i = 0; i < (int) aConnections.size(); i++ )
+    {
+        auto it = regionIndex.emplace( find( i ), (int) regions.size() ).first;
+
+        if( it->second == (int) regions.size() )
+            regions.emplace_back();
+
+        regions[it->second].push_back( i );
+    }
+
+    return regions;
+}
+
+
+bool BATCH_ROUTER::prepareTask( const CONNECTION& aConnection, TASK& aTask )
+{
+    NODE* world = m_router->GetWorld();
+    ITEM* startItem = world->FindItemByParent( aConnection.startParent );
+    ITEM* endItem = world->FindItemByParent( aConnection.endParent );
+
+    if( !startItem || !endItem )
+        return false;
+
+    // Pick a layer both ends are on, preferring the caller's choice
+    int layer = -1;
+
+    if( startItem->Layers().Overlaps( aConnection.preferredLayer )
+            && endItem->Layers().Overlaps( aConnection.preferredLayer ) )
+    {
+        layer = aConnection.preferredLayer;
+    }
+    else
+    {
+        for( int l = startItem->Layers().Start(); l <= startItem->Layers().End(); l++ )
+        {
+            if( endItem->Layers().Overlaps( l ) )
+            {
+                layer = l;
+                break;
+            }
+        }
+    }
+
+    if( layer < 0 )
+        return false;
+
+    SIZES_SETTINGS sizes( m_router->Sizes() );
+
+    if( !m_router->GetInterface()->ImportSizes( sizes, startItem, aConnection.net ) )
+        return false;
+
+    DIRECTION_45::CORNER_MODE cornerMode = m_router->Settings().GetCornerMode();
+
+    aTask.line.SetShape( DIRECTION_45().BuildInitialTrace( aConnection.start, aConnection.end,
+                                                           false, cornerMode ) );
+    aTask.line.SetWidth( sizes.TrackWidth() );
+    aTask.line.SetNet( aConnection.net );
+    aTask.line.SetLayer( layer );
+
+    return true;
+}
+
+
+void BATCH_ROUTER::walkRegion( NODE* aNode, std::vector<TASK*>& aTasks )
+{
+    ROUTING_SETTINGS&         settings = m_router->Settings();
+    DIRECTION_45::CORNER_MODE cornerMode = settings.GetCornerMode();
+    int                       effort = OPTIMIZER::MERGE_SEGMENTS;
+
+    // Smart Pads is incompatible with 90-degree mode for now
+    if( settings.SmartPads()
+            && ( cornerMode == DIRECTION_45::MITERED_45 || cornerMode == DIRECTION_45::ROUNDED_45 ) )
+    {
+        effort |= OPTIMIZER::SMART_PADS;
+    }
+
+    // Shortest first, so that the longer connections go around the shorter ones rather than
+    // blocking them
+    std::sort( aTasks.begin(), aTasks.end(),
+               []( const TASK* a, const TASK* b )
+               {
+                   return a->line.CLine().Length() < b->line.CLine().Length();
+               } );
+
+    for( TASK* task : aTasks )
+    {
+        if( m_reporter && m_reporter->IsCancelled() )
+            return;
+
+        PROF_TIMER timer;
+        VECTOR2I   end = task->line.CLine().CPoint( -1 );
+
+        WALKAROUND walkaround( aNode, m_router );
+
+        walkaround.SetSolidsOnly( false );
+        walkaround.SetIterationLimit( settings.WalkaroundIterationLimit() );
+
+        WALKAROUND::RESULT wr = walkaround.Route( task->line );
+        std::optional<LINE> best;
+
+        if( wr.statusCw == WALKAROUND::DONE )
+            best = wr.lineCw;
+
+        if( wr.statusCcw == WALKAROUND::DONE
+                && ( !best || wr.lineCcw.CLine().Length() < best->CLine().Length() ) )
+        {
+            best = wr.lineCcw;
+        }
+
+        if( best && best->CLine().CPoint( -1 ) == end && !aNode->CheckColliding( &*best ) )
+        {
+            OPTIMIZER::Optimize( &*best, effort, aNode );
+
+            task->line = *best;
+            task->routed = true;
+
+            aNode->Add( *best );
+        }
+
+        task->timeMs = timer.msecs();
+
+        if( m_reporter )
+            m_reporter->AdvanceProgress();
+    }
+}
+
+
+bool BATCH_ROUTER::routeInteractive( const CONNECTION& aConnection )
+{
+    NODE* world = m_router->GetWorld();
+    ITEM* startItem = world->FindItemByParent( aConnection.startParent );
+    ITEM* endItem = world->FindItemByParent( aConnection.endParent );
+
+    if( !startItem || !endItem )
+        return false;
+
+    int layer = startItem->Layers().Overlaps( aConnection.preferredLayer )
+                        ? aConnection.preferredLayer
+                        : startItem->Layers().Start();
+
+    SIZES_SETTINGS sizes( m_router->Sizes() );
+    m_router->GetInterface()->ImportSizes( sizes, startItem, aConnection.net );
+    m_router->UpdateSizes( sizes );
+
+    m_router->SetMode( PNS_MODE_ROUTE_SINGLE );
+
+    if( !m_router->StartRouting( aConnection.start, startItem, layer ) )
+        return false;
+
+    // Unlike Finish(), which heads for the ratsnest anchor nearest to the head, only complete
+    // the route if it reaches the end of this very connection
+    PLACEMENT_ALGO* placer = m_router->Placer();
+
+    for( int tries = 0; tries < 5; tries++ )
+    {
+        VECTOR2I lastEnd = placer->CurrentEnd();
+
+        m_router->Move( aConnection.end, endItem );
+
+        if( placer->CurrentEnd() == lastEnd )
+            break;
+    }
+
+    if( placer->CurrentEnd() == aConnection.end
+            && endItem->Layers().Overlaps( m_router->GetCurrentLayer() )
+            && m_router->FixRoute( aConnection.end, endItem ) )
+    {
+        m_router->CommitRouting();
+
+        if( m_onCommit )
+            m_onCommit();
+
+        return true;
+    }
+
+    m_router->StopRouting();
+    return false;
+}
+
+
+bool BATCH_ROUTER::keepRefreshing()
+{
+    return !m_reporter || m_reporter->KeepRefreshing();
+}
+
+
+std::vector<BATCH_ROUTER::RESULT> BATCH_ROUTER::Route( const std::vector<CONNECTION>& aConnections )
+{
+    std::vector<RESULT> results( aConnections.size() );
+    std::vector<TASK>   tasks( aConnections.size() );
+    std::vector<int>    prepared;
+    NODE*               world = m_router->GetWorld();
+    int                 maxWidth = 0;
+
+    for( size_t i = 0; i < aConnections.size(); i++ )
+    {
+        results[i] = { aConnections[i].net, -1, FAILED, 0.0 };
+        tasks[i].index = (int) i;
+        tasks[i].region = -1;
+        tasks[i].routed = false;
+        tasks[i].timeMs = 0.0;
+
+        if( prepareTask( aConnections[i], tasks[i] ) )
+        {
+            prepared.push_back( (int) i );
+            maxWidth = std::max( maxWidth, tasks[i].line.Width() );
+        }
+    }
+
+    // Connections further apart than this can't push each other around
+    int margin = 4 * ( world->GetMaxClearance() + maxWidth );
+
+    std::vector<CONNECTION> preparedConnections;
+
+    for( int i : prepared )
+        preparedConnections.push_back( aConnections[i] );
+
+    std::vector<std::vector<int>> regionMembers = FindRegions( preparedConnections, margin );
+    std::vector<std::vector<TASK*>> regions( regionMembers.size() );
+    std::vector<NODE*>              regionNodes;
+
+    for( size_t r = 0; r < regionMembers.size(); r++ )
+    {
+        for( int member : regionMembers[r] )
+        {
+            TASK* task = &tasks[prepared[member]];
+
+            task->region = (int) r;
+            results[task->index].region = (int) r;
+            regions[r].push_back( task );
+        }
+
+        // Branching modifies the world, so it has to be done here rather than by the workers
+        regionNodes.push_back( world->Branch() );
+    }
+
+    if( m_reporter )
+    {
+        m_reporter->Report( _( "Routing unconnected items..." ) );
+        m_reporter->SetMaxProgress( (int) prepared.size() );
+    }
+
+    // The workers are dedicated threads rather than thread pool tasks as the walkaround and the
+    // optimizer submit their own work to the pool and wait for it.
+    DEBUG_DECORATOR* dbg = m_router->GetInterface()->GetDebugDecorator();
+    std::atomic<int> nextRegion( 0 );
+
+    auto worker =
+            [&]()
+            {
+                for( int r = nextRegion++; r < (int) regions.size(); r = nextRegion++ )
+                    walkRegion( regionNodes[r], regions[r] );
+            };
+
+    // The debug decorator can only record from a single thread
+    if( dbg && dbg->IsDebugEnabled() )
+    {
+        worker();
+    }
+    else
+    {
+        size_t threadCount = std::min<size_t>( regions.size(),
+                                               std::max( 1u, std::thread::hardware_concurrency() ) );
+        std::vector<std::future<void>> workers;
+
+        for( size_t i = 0; i < threadCount; i++ )
+            workers.push_back( std::async( std::launch::async, worker ) );
+
+        for( std::future<void>& f : workers )
+        {
+            while( f.wait_for( std::chrono::milliseconds( 100 ) ) != std::future_status::ready )
+                keepRefreshing();
+        }
+    }
+
+    world->KillChildren();
+
+    // Lines of different regions may still collide where the margin was too small, so they are
+    // checked against each other before being committed
+    NODE* commitNode = world->Branch();
+    bool  routedAny = false;
+
+    for( TASK& task : tasks )
+    {
+        if( !task.routed )
+            continue;
+
+        if( commitNode->CheckColliding( &task.line ) )
+        {
+            task.routed = false;
+            continue;
+        }
+
+        commitNode->Add( task.line );
+        results[task.index].status = ROUTED;
+        routedAny = true;
+    }
+
+    if( routedAny )
+    {
+        m_router->CommitRouting( commitNode );
+
+        if( m_onCommit )
+            m_onCommit();
+    }
+    else
+    {
+        world->KillChildren();
+    }
+
+    if( m_reporter )
+    {
+        int remaining = std::count_if( results.begin(), results.end(),
+                                       []( const RESULT& r )
+                                       {
+                                           return r.status != ROUTED;
+                                       } );
+
+        m_reporter->AdvancePhase( _( "Retrying unrouted connections..." ) );
+        m_reporter->SetMaxProgress( remaining );
+    }
+
+    // Retry the rest one at a time with the interactive placer, which can also shove
+    for( TASK& task : tasks )
+    {
+        RESULT& result = results[task.index];
+
+        result.timeMs = task.timeMs;
+
+        if( result.status == ROUTED )
+            continue;
+
+        if( m_reporter && m_reporter->IsCancelled() )
+            break;
+
+        const CONNECTION& conn = aConnections[task.index];
+
+        if( m_isConnected && m_isConnected( conn ) )
+        {
+            result.status = SKIPPED;
+
+            if( m_reporter )
+                m_reporter->AdvanceProgress();
+
+            continue;
+        }
+
+        PROF_TIMER timer;
+
+        if( routeInteractive( conn ) )
+            result.status = ROUTED;
+
+        result.timeMs += timer.msecs();
+
+        if( m_reporter )
+            m_reporter->AdvanceProgress();
+
+        keepRefreshing();
+    }
+
+    return results;
+}
+
+}
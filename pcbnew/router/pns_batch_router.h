@@ -0,0 +1,141 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_BATCH_ROUTER_H
+#define __PNS_BATCH_ROUTER_H
+
+#include <functional>
+#include <vector>
+
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+#include "pns_line.h"
+
+class BOARD_ITEM;
+class PROGRESS_REPORTER;
+
+namespace PNS {
+
+class NODE;
+class ROUTER;
+
+/**
+ * Route a list of unconnected anchor pairs (e.g. the ratsnest edges of a board) without user
+ * interaction.
+ *
+ * The connections are first grouped into regions whose (inflated) bounding boxes don't overlap.
+ * The regions are walked around concurrently, each on its own branch of the world, with the
+ * connections of a region routed shortest first so that the later ones avoid the earlier ones.
+ * The resulting lines are then committed in a single step after checking them against the
+ * lines of the other regions.
+ *
+ * Whatever couldn't be routed that way (no common layer, walkaround stuck or colliding with
+ * another region's line) is retried one connection at a time with the interactive placer and
+ * the current routing mode, so it may shove other tracks out of the way.
+ */
+class BATCH_ROUTER
+{
+public:
+    struct CONNECTION
+    {
+        BOARD_ITEM* startParent;
+        BOARD_ITEM* endParent;
+        VECTOR2I    start;
+        VECTOR2I    end;
+        int         net;
+        int         preferredLayer;     ///< used when both ends are on several common layers
+    };
+
+    enum STATUS
+    {
+        ROUTED = 0,
+        FAILED,
+        SKIPPED     ///< already connected by the time it was retried
+    };
+
+    struct RESULT
+    {
+        int    net;
+        int    region;
+        STATUS status;
+        double timeMs;      ///< time spent routing the connection, over both passes
+    };
+
+    BATCH_ROUTER( ROUTER* aRouter );
+
+    /**
+     * Set a function telling whether a connection has already been made, e.g. by the route of
+     * another connection of the same net.  Connections are otherwise always retried.
+     */
+    void SetConnectedCheck( const std::function<bool( const CONNECTION& )>& aCheck )
+    {
+        m_isConnected = aCheck;
+    }
+
+    /**
+     * Set a function called after each commit of routed tracks to the board.
+     */
+    void SetCommitCallback( const std::function<void()>& aCallback )
+    {
+        m_onCommit = aCallback;
+    }
+
+    void SetProgressReporter( PROGRESS_REPORTER* aReporter ) { m_reporter = aReporter; }
+
+    /**
+     * Route \a aConnections and commit the results.
+     *
+     * @return one result per connection, in the same order.
+     */
+    std::vector<RESULT> Route( const std::vector<CONNECTION>& aConnections );
+
+    /**
+     * Group connections whose bounding boxes, inflated by \a aMargin, overlap.
+     *
+     * @return the connection indices of each region.
+     */
+    static std::vector<std::vector<int>> FindRegions( const std::vector<CONNECTION>& aConnections,
+                                                      int aMargin );
+
+private:
+    struct TASK
+    {
+        int  index;             ///< in the connection list
+        int  region;
+        LINE line;              ///< initial line, then the route if successful
+        bool routed;
+        double timeMs;
+    };
+
+    bool prepareTask( const CONNECTION& aConnection, TASK& aTask );
+    void walkRegion( NODE* aNode, std::vector<TASK*>& aTasks );
+    bool routeInteractive( const CONNECTION& aConnection );
+    bool keepRefreshing();
+
+    ROUTER*            m_router;
+    PROGRESS_REPORTER* m_reporter;
+
+    std::function<bool( const CONNECTION& )> m_isConnected;
+    std::function<void()>                    m_onCommit;
+};
+
+}
+
+#endif    // __PNS_BATCH_ROUTER_H
@@ -132,12 +132,12 @@ bool COMPONENT_DRAGGER::Start( const VECTOR2I& aP, ITEM_SET& aPrimitives )
                 addLinked( solid, jt, static_cast<LINKED_ITEM*>( link ) );
         }
 
-        std::vector<JOINT*> extraJoints;
+        std::vector<const JOINT*> extraJoints;
 
         m_world->QueryJoints( solid->Hull().BBox(), extraJoints, solid->Layers(),
                               ITEM::SEGMENT_T | ITEM::ARC_T );
 
-        for( JOINT* extraJoint : extraJoints )
+        for( const JOINT* extraJoint : extraJoints )
         {
             if( extraJoint->Net() == jt->Net() && extraJoint->LinkCount() == 1 )
             {
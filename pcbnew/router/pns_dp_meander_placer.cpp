@@ -41,6 +41,7 @@ DP_MEANDER_PLACER::DP_MEANDER_PLACER( ROUTER* aRouter ) :
 
     m_padToDieP = 0;
     m_padToDieN = 0;
+    m_origPathLength = 0;
 
     // Init temporary variables (do not leave uninitialized members)
     m_initialSegment = nullptr;
@@ -120,6 +121,11 @@ bool DP_MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     if( m_endPad_n )
         m_padToDieN += m_endPad_n->GetPadToDie();
 
+    // The tuned paths don't change while moving the meanders
+    long long int totalP = m_padToDieP + lineLength( m_tunedPathP, m_startPad_p, m_endPad_p );
+    long long int totalN = m_padToDieN + lineLength( m_tunedPathN, m_startPad_n, m_endPad_n );
+    m_origPathLength = std::max( totalP, totalN );
+
     m_world->Remove( m_originPair.PLine() );
     m_world->Remove( m_originPair.NLine() );
 
@@ -136,9 +142,7 @@ void DP_MEANDER_PLACER::release()
 
 long long int DP_MEANDER_PLACER::origPathLength() const
 {
-    long long int totalP = m_padToDieP + lineLength( m_tunedPathP, m_startPad_p, m_endPad_p );
-    long long int totalN = m_padToDieN + lineLength( m_tunedPathN, m_startPad_n, m_endPad_n );
-    return std::max( totalP, totalN );
+    return m_origPathLength;
 }
 
 
@@ -145,6 +145,7 @@ private:
     long long int m_lastLength;
     int           m_padToDieP;
     int           m_padToDieN;
+    long long int m_origPathLength;     ///< longer of the two tuned paths, computed by Start()
     TUNING_STATUS m_lastStatus;
 };
 
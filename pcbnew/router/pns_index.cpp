@@ -40,6 +40,9 @@ void INDEX::Add( ITEM* aItem )
 
     if( net >= 0 )
         m_netMap[net].push_back( aItem );
+
+    if( aItem->Parent() )
+        m_parentMap.emplace( aItem->Parent(), aItem );
 }
 
 
@@ -58,6 +61,20 @@ void INDEX::Remove( ITEM* aItem )
 
     if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
         m_netMap[net].remove( aItem );
+
+    if( aItem->Parent() )
+    {
+        auto range = m_parentMap.equal_range( aItem->Parent() );
+
+        for( auto it = range.first; it != range.second; ++it )
+        {
+            if( it->second == aItem )
+            {
+                m_parentMap.erase( it );
+                break;
+            }
+        }
+    }
 }
 
 
@@ -76,4 +93,13 @@ INDEX::NET_ITEMS_LIST* INDEX::GetItemsForNet( int aNet )
     return &m_netMap[aNet];
 }
 
+
+void INDEX::GetItemsForParent( const BOARD_ITEM* aParent, std::vector<ITEM*>& aItems ) const
+{
+    auto range = m_parentMap.equal_range( aParent );
+
+    for( auto it = range.first; it != range.second; ++it )
+        aItems.push_back( it->second );
+}
+
 };
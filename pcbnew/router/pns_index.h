@@ -22,10 +22,14 @@
 #ifndef __PNS_INDEX_H
 #define __PNS_INDEX_H
 
+#include <algorithm>
+#include <climits>
 #include <deque>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <layer_ids.h>
 #include <geometry/shape_index.h>
@@ -94,11 +98,32 @@ public:
     template<class Visitor>
     int Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
+    /**
+     * Searches items in the index that are in proximity of any of aItems (e.g. the segments and
+     * the via of a line) in a single pass.  Items lying close to each other on a layer share one
+     * search of that layer's subindex, covering their common bounding box; the candidates found
+     * are then matched against the bounding box of each item.
+     *
+     * @param aItems items to search against
+     * @param aMinDistance proximity distance (wrs to the items' shapes)
+     * @param aVisitor function object called as aVisitor( found, item ) for each found item
+              and each item of aItems it is close to. Return false from the visitor to stop
+              searching.
+     * @return number of items found.
+     */
+    template<class Visitor>
+    int Query( const std::vector<const ITEM*>& aItems, int aMinDistance, Visitor& aVisitor ) const;
+
     /**
      * Returns list of all items in a given net.
      */
     NET_ITEMS_LIST* GetItemsForNet( int aNet );
 
+    /**
+     * Appends the items created from board item aParent to aItems.
+     */
+    void GetItemsForParent( const BOARD_ITEM* aParent, std::vector<ITEM*>& aItems ) const;
+
     /**
      * Function Contains()
      *
@@ -121,10 +146,39 @@ private:
     template <class Visitor>
     int querySingle( std::size_t aIndex, const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const;
 
+    ///< Dispatches the candidates of a batched search to the items they are close to.
+    template <class Visitor>
+    struct BATCH_VISITOR
+    {
+        bool operator()( ITEM* aCandidate )
+        {
+            const BOX2I bbox = aCandidate->Shape()->BBox();
+
+            for( size_t i : m_members )
+            {
+                if( m_boxes[i].Intersects( bbox ) && !m_visitor( aCandidate, m_items[i] ) )
+                {
+                    m_stopped = true;
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const std::vector<const ITEM*>& m_items;
+        const std::vector<BOX2I>&       m_boxes;
+        std::vector<size_t>             m_members;   ///< items covered by the current search
+        Visitor&                        m_visitor;
+        bool                            m_stopped;
+    };
+
 private:
     std::deque<ITEM_SHAPE_INDEX>  m_subIndices;
     std::map<int, NET_ITEMS_LIST> m_netMap;
     ITEM_SET                      m_allItems;
+
+    std::unordered_multimap<const BOARD_ITEM*, ITEM*> m_parentMap;
 };
 
 
@@ -150,6 +204,87 @@ int INDEX::Query( const ITEM* aItem, int aMinDistance, Visitor& aVisitor ) const
     return total;
 }
 
+template<class Visitor>
+int INDEX::Query( const std::vector<const ITEM*>& aItems, int aMinDistance,
+                  Visitor& aVisitor ) const
+{
+    // Merging the bounding boxes of two groups of items is only worth it if it doesn't add much
+    // empty space to search, e.g. for long diagonal segments.
+    const double maxAreaRatio = 2.0;
+
+    std::vector<BOX2I> boxes;
+    int                firstLayer = INT_MAX;
+    int                lastLayer = -1;
+
+    boxes.reserve( aItems.size() );
+
+    for( const ITEM* item : aItems )
+    {
+        BOX2I box = item->Shape()->BBox();
+        box.Inflate( aMinDistance );
+        boxes.push_back( box );
+
+        firstLayer = std::min( firstLayer, item->Layers().Start() );
+        lastLayer = std::max( lastLayer, item->Layers().End() );
+    }
+
+    lastLayer = std::min( lastLayer, (int) m_subIndices.size() - 1 );
+
+    BATCH_VISITOR<Visitor> batch{ aItems, boxes, {}, aVisitor, false };
+    int                    total = 0;
+
+    for( int layer = std::max( firstLayer, 0 ); layer <= lastLayer; ++layer )
+    {
+        BOX2I  searchBox;
+        double searchArea = 0.0;    // sum of the areas of the merged boxes
+
+        auto search =
+                [&]() -> bool
+                {
+                    if( !batch.m_members.empty() )
+                        total += m_subIndices[layer].Query( searchBox, batch );
+
+                    batch.m_members.clear();
+                    return !batch.m_stopped;
+                };
+
+        for( size_t i = 0; i < aItems.size(); ++i )
+        {
+            if( !aItems[i]->Layers().Overlaps( layer ) )
+                continue;
+
+            double area = (double) boxes[i].GetWidth() * boxes[i].GetHeight();
+
+            if( !batch.m_members.empty() )
+            {
+                BOX2I merged = searchBox;
+                merged.Merge( boxes[i] );
+
+                if( (double) merged.GetWidth() * merged.GetHeight()
+                        <= maxAreaRatio * ( searchArea + area ) )
+                {
+                    searchBox = merged;
+                    searchArea += area;
+                    batch.m_members.push_back( i );
+                    continue;
+                }
+
+                if( !search() )
+                    return total;
+            }
+
+            searchBox = boxes[i];
+            searchArea = area;
+            batch.m_members.push_back( i );
+        }
+
+        if( !search() )
+            return total;
+    }
+
+    return total;
+}
+
 template<class Visitor>
 int INDEX::Query( const SHAPE* aShape, int aMinDistance, Visitor& aVisitor ) const
 {
@@ -51,7 +51,12 @@
 
 #include <wx/log.h>
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <hash.h>
 
 #include <advanced_config.h>
 #include <pcbnew_settings.h>
@@ -73,11 +78,60 @@
 typedef VECTOR2I::extended_type ecoord;
 
 
+/**
+ * The properties of a router item which the clearance rules can see.  Branches of the world
+ * clone their items, but the clones keep these, so a cache keyed on them (rather than on the
+ * item pointers) stays valid while shoving and never needs to be pruned of individual items.
+ *
+ * Items with a board item parent are evaluated through that parent.  Items without one (e.g.
+ * the track being routed) are evaluated through a dummy board item carrying only their net and
+ * layer, so those are all that matters for them.
+ */
+struct CLEARANCE_CACHE_ITEM_KEY
+{
+    const BOARD_ITEM* Parent;
+    const BOARD_ITEM* BoardItem;    ///< differs from Parent for the holes of pads and vias
+    int               Kind;
+    int               Net;
+    int               LayerStart;
+    int               LayerEnd;
+
+    CLEARANCE_CACHE_ITEM_KEY( const PNS::ITEM* aItem )
+    {
+        if( aItem )
+        {
+            Parent = aItem->Parent();
+            BoardItem = aItem->BoardItem();
+            Kind = aItem->Kind();
+            Net = aItem->Net();
+            LayerStart = aItem->Layers().Start();
+            LayerEnd = aItem->Layers().End();
+        }
+        else
+        {
+            Parent = nullptr;
+            BoardItem = nullptr;
+            Kind = -1;
+            Net = -1;
+            LayerStart = -1;
+            LayerEnd = -1;
+        }
+    }
+
+    bool operator==( const CLEARANCE_CACHE_ITEM_KEY& other ) const
+    {
+        return Parent == other.Parent && BoardItem == other.BoardItem && Kind == other.Kind
+               && Net == other.Net && LayerStart == other.LayerStart
+               && LayerEnd == other.LayerEnd;
+    }
+};
+
+
 struct CLEARANCE_CACHE_KEY
 {
-    const PNS::ITEM*  A;
-    const PNS::ITEM*  B;
-    bool              Flag;
+    CLEARANCE_CACHE_ITEM_KEY A;
+    CLEARANCE_CACHE_ITEM_KEY B;
+    bool                     Flag;
 
     bool operator==(const CLEARANCE_CACHE_KEY& other) const
     {
@@ -87,12 +141,21 @@ struct CLEARANCE_CACHE_KEY
 
 namespace std
 {
+    template <>
+    struct hash<CLEARANCE_CACHE_ITEM_KEY>
+    {
+        std::size_t operator()( const CLEARANCE_CACHE_ITEM_KEY& k ) const
+        {
+            return hash_val( k.Parent, k.BoardItem, k.Kind, k.Net, k.LayerStart, k.LayerEnd );
+        }
+    };
+
     template <>
     struct hash<CLEARANCE_CACHE_KEY>
     {
         std::size_t operator()( const CLEARANCE_CACHE_KEY& k ) const
         {
-            return hash<const void*>()( k.A ) ^ hash<const void*>()( k.B ) ^ hash<int>()( k.Flag );
+            return hash_val( k.A, k.B, k.Flag );
         }
     };
 }
@@ -147,7 +210,13 @@ private:
     PCB_VIA            m_dummyVias[2];
     int                m_clearanceEpsilon;
 
+    // The walkaround queries clearances from several threads at once.  Lookups vastly outnumber
+    // insertions, so they share the cache lock.
+    std::mutex                                   m_dummyItemsMutex;
+    std::shared_mutex                            m_clearanceCacheMutex;
     std::unordered_map<CLEARANCE_CACHE_KEY, int> m_clearanceCache;
+    std::atomic<int>                             m_clearanceCacheHits;
+    std::atomic<int>                             m_clearanceCacheMisses;
 };
 
 
@@ -157,7 +226,9 @@ PNS_PCBNEW_RULE_RESOLVER::PNS_PCBNEW_RULE_RESOLVER( BOARD* aBoard,
     m_board( aBoard ),
     m_dummyTracks{ { aBoard }, { aBoard } },
     m_dummyArcs{ { aBoard }, { aBoard } },
-    m_dummyVias{ { aBoard }, { aBoard } }
+    m_dummyVias{ { aBoard }, { aBoard } },
+    m_clearanceCacheHits( 0 ),
+    m_clearanceCacheMisses( 0 )
 {
     if( aBoard )
         m_clearanceEpsilon = aBoard->GetDesignSettings().GetDRCEpsilon();
@@ -343,6 +414,11 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
     BOARD_ITEM*    parentB = aItemB ? aItemB->BoardItem() : nullptr;
     DRC_CONSTRAINT hostConstraint;
 
+    std::unique_lock<std::mutex> dummyItemsLock( m_dummyItemsMutex, std::defer_lock );
+
+    if( ( aItemA && !parentA ) || ( aItemB && !parentB ) )
+        dummyItemsLock.lock();
+
     // A track being routed may not have a BOARD_ITEM associated yet.
     if( aItemA && !parentA )
     {
@@ -419,34 +495,32 @@ bool PNS_PCBNEW_RULE_RESOLVER::QueryConstraint( PNS::CONSTRAINT_TYPE aType,
 
 void PNS_PCBNEW_RULE_RESOLVER::ClearCacheForItems( std::vector<const PNS::ITEM*>& aItems )
 {
-    int n_pruned = 0;
-    std::set<const PNS::ITEM*> remainingItems( aItems.begin(), aItems.end() );
-
-/* We need to carefully check both A and B item pointers in the cache against dirty/invalidated
-   items in the set, as the clearance relation is commutative ( CL[a,b] == CL[b,a] ). The code
-   below is a bit ugly, but works in O(n*log(m)) and is run once or twice during ROUTER::Move() call
-   - so I hope it still gets better performance than no cache at all */
-    for( auto it = m_clearanceCache.begin(); it != m_clearanceCache.end(); )
-    {
-        bool dirty = remainingItems.find( it->first.A ) != remainingItems.end();
-        dirty |= remainingItems.find( it->first.B) != remainingItems.end();
-
-        if( dirty )
-        {
-            it = m_clearanceCache.erase( it );
-            n_pruned++;
-        } else
-            it++;
-    }
-#if 0
-    printf("ClearCache : n_pruned %d\n", n_pruned );
-#endif
+    // Nothing to do: the cache isn't keyed by item, and cloned or moved items keep the properties
+    // it is keyed by.  Changes to the board items themselves go through ClearCaches().
 }
 
 
 void PNS_PCBNEW_RULE_RESOLVER::ClearCaches()
 {
+    std::unique_lock<std::shared_mutex> lock( m_clearanceCacheMutex );
+
+    int hits = m_clearanceCacheHits.load( std::memory_order_relaxed );
+    int lookups = hits + m_clearanceCacheMisses.load( std::memory_order_relaxed );
+
+    if( lookups > 0 )
+    {
+        wxString stats = wxString::Format( wxT( "Clearance cache: %d lookups, %d entries, "
+                                                "%.1f%% hit rate" ),
+                                           lookups, (int) m_clearanceCache.size(),
+                                           100.0 * hits / lookups );
+
+        PNS_DBG( m_routerIface->GetDebugDecorator(), Message, stats );
+        wxLogTrace( wxT( "PNS" ), stats );
+    }
+
     m_clearanceCache.clear();
+    m_clearanceCacheHits.store( 0, std::memory_order_relaxed );
+    m_clearanceCacheMisses.store( 0, std::memory_order_relaxed );
 }
 
 
@@ -454,10 +528,19 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
                                          bool aUseClearanceEpsilon )
 {
     CLEARANCE_CACHE_KEY key = { aA, aB, aUseClearanceEpsilon };
-    auto it = m_clearanceCache.find( key );
 
-    if( it != m_clearanceCache.end() )
-        return it->second;
+    {
+        std::shared_lock<std::shared_mutex> lock( m_clearanceCacheMutex );
+        auto                                it = m_clearanceCache.find( key );
+
+        if( it != m_clearanceCache.end() )
+        {
+            m_clearanceCacheHits.fetch_add( 1, std::memory_order_relaxed );
+            return it->second;
+        }
+    }
+
+    m_clearanceCacheMisses.fetch_add( 1, std::memory_order_relaxed );
 
     PNS::CONSTRAINT constraint;
     int             rv = 0;
@@ -517,13 +600,8 @@ int PNS_PCBNEW_RULE_RESOLVER::Clearance( const PNS::ITEM* aA, const PNS::ITEM* a
         rv = std::max( 0, rv - m_clearanceEpsilon );
 
 
-/* It makes no sense to put items that have no owning NODE in the cache - they can be allocated on stack
-   and we can't really invalidate them in the cache when they are destroyed. Probably a better idea would be
-   to use a static unique counter in PNS::ITEM constructor to generate the cache keys. */
-    if( aA && aB && aA->Owner() && aB->Owner() )
-    {
-        m_clearanceCache[ key ] = rv;
-    }
+    std::unique_lock<std::shared_mutex> lock( m_clearanceCacheMutex );
+    m_clearanceCache[ key ] = rv;
 
     return rv;
 }
@@ -1054,6 +1132,7 @@ PNS_KICAD_IFACE_BASE::PNS_KICAD_IFACE_BASE()
     m_world = nullptr;
     m_debugDecorator = nullptr;
     m_startLayer = -1;
+    m_fullSyncNeeded = true;
 }
 
 
@@ -1508,105 +1587,304 @@ bool PNS_KICAD_IFACE::IsItemVisible( const PNS::ITEM* aItem ) const
 }
 
 
-void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+void PNS_KICAD_IFACE_BASE::syncFootprint( PNS::NODE* aWorld, FOOTPRINT* aFootprint,
+                                          SHAPE_POLY_SET* aBoardOutline )
 {
-    if( !m_board )
+    SYNCED_FOOTPRINT& synced = m_syncedFootprints[ aFootprint ];
+
+    synced.items.clear();
+    synced.edgeExclusions = false;
+
+    for( PAD* pad : aFootprint->Pads() )
     {
-        wxLogTrace( wxT( "PNS" ), wxT( "No board attached, aborting sync." ) );
-        return;
+        if( std::unique_ptr<PNS::SOLID> solid = syncPad( pad ) )
+            aWorld->Add( std::move( solid ) );
+
+        synced.items.push_back( pad );
+
+        if( pad->GetProperty() == PAD_PROP::CASTELLATED )
+        {
+            std::unique_ptr<SHAPE> hole;
+            hole.reset( pad->GetEffectiveHoleShape()->Clone() );
+            aWorld->AddEdgeExclusion( std::move( hole ) );
+            synced.edgeExclusions = true;
+        }
     }
 
-    int worstClearance = m_board->GetMaxClearanceValue();
+    syncTextItem( aWorld, &aFootprint->Reference(), aFootprint->Reference().GetLayer() );
+    syncTextItem( aWorld, &aFootprint->Value(), aFootprint->Value().GetLayer() );
 
-    m_world = aWorld;
+    synced.items.push_back( &aFootprint->Reference() );
+    synced.items.push_back( &aFootprint->Value() );
 
-    for( BOARD_ITEM* gitem : m_board->Drawings() )
+    for( FP_ZONE* zone : aFootprint->Zones() )
     {
-        if ( gitem->Type() == PCB_SHAPE_T || gitem->Type() == PCB_TEXTBOX_T )
+        syncZone( aWorld, zone, aBoardOutline );
+        synced.items.push_back( zone );
+    }
+
+    for( BOARD_ITEM* mgitem : aFootprint->GraphicalItems() )
+    {
+        if( mgitem->Type() == PCB_FP_SHAPE_T || mgitem->Type() == PCB_FP_TEXTBOX_T )
         {
-            syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( gitem ) );
+            syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( mgitem ) );
         }
-        else if( gitem->Type() == PCB_TEXT_T )
+        else if( mgitem->Type() == PCB_FP_TEXT_T )
         {
-            syncTextItem( aWorld, static_cast<PCB_TEXT*>( gitem ), gitem->GetLayer() );
+            syncTextItem( aWorld, static_cast<FP_TEXT*>( mgitem ), mgitem->GetLayer() );
         }
+
+        synced.items.push_back( mgitem );
+    }
+}
+
+
+void PNS_KICAD_IFACE_BASE::syncBoardItem( PNS::NODE* aWorld, BOARD_ITEM* aItem,
+                                          SHAPE_POLY_SET* aBoardOutline )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_SHAPE_T:
+    case PCB_TEXTBOX_T:
+        syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( aItem ) );
+        break;
+
+    case PCB_TEXT_T:
+        syncTextItem( aWorld, static_cast<PCB_TEXT*>( aItem ), aItem->GetLayer() );
+        break;
+
+    case PCB_ZONE_T:
+        syncZone( aWorld, static_cast<ZONE*>( aItem ), aBoardOutline );
+        break;
+
+    case PCB_FOOTPRINT_T:
+        syncFootprint( aWorld, static_cast<FOOTPRINT*>( aItem ), aBoardOutline );
+        break;
+
+    case PCB_TRACE_T:
+        if( std::unique_ptr<PNS::SEGMENT> segment = syncTrack( static_cast<PCB_TRACK*>( aItem ) ) )
+            aWorld->Add( std::move( segment ) );
+
+        break;
+
+    case PCB_ARC_T:
+        if( std::unique_ptr<PNS::ARC> arc = syncArc( static_cast<PCB_ARC*>( aItem ) ) )
+            aWorld->Add( std::move( arc ) );
+
+        break;
+
+    case PCB_VIA_T:
+        if( std::unique_ptr<PNS::VIA> via = syncVia( static_cast<PCB_VIA*>( aItem ) ) )
+            aWorld->Add( std::move( via ) );
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void PNS_KICAD_IFACE_BASE::SyncWorld( PNS::NODE *aWorld )
+{
+    if( !m_board )
+    {
+        wxLogTrace( wxT( "PNS" ), wxT( "No board attached, aborting sync." ) );
+        return;
     }
 
+    int worstClearance = m_board->GetMaxClearanceValue();
+
+    m_world = aWorld;
+    m_dirtyItems.clear();
+    m_syncedFootprints.clear();
+    m_fullSyncNeeded = false;
+
     SHAPE_POLY_SET  buffer;
     SHAPE_POLY_SET* boardOutline = nullptr;
 
     if( m_board->GetBoardPolygonOutlines( buffer ) )
         boardOutline = &buffer;
 
+    for( BOARD_ITEM* gitem : m_board->Drawings() )
+        syncBoardItem( aWorld, gitem, boardOutline );
+
     for( ZONE* zone : m_board->Zones() )
-    {
-        syncZone( aWorld, zone, boardOutline );
-    }
+        syncBoardItem( aWorld, zone, boardOutline );
 
     for( FOOTPRINT* footprint : m_board->Footprints() )
     {
-        for( PAD* pad : footprint->Pads() )
-        {
-            if( std::unique_ptr<PNS::SOLID> solid = syncPad( pad ) )
-                aWorld->Add( std::move( solid ) );
+        syncFootprint( aWorld, footprint, boardOutline );
 
+        for( PAD* pad : footprint->Pads() )
             worstClearance = std::max( worstClearance, pad->GetLocalClearance() );
+    }
 
-            if( pad->GetProperty() == PAD_PROP::CASTELLATED )
-            {
-                std::unique_ptr<SHAPE> hole;
-                hole.reset( pad->GetEffectiveHoleShape()->Clone() );
-                aWorld->AddEdgeExclusion( std::move( hole ) );
-            }
-        }
+    for( PCB_TRACK* t : m_board->Tracks() )
+        syncBoardItem( aWorld, t, boardOutline );
+
+    delete m_ruleResolver;
+    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, this );
 
-        syncTextItem( aWorld, &footprint->Reference(), footprint->Reference().GetLayer() );
-        syncTextItem( aWorld, &footprint->Value(), footprint->Value().GetLayer() );
+    aWorld->SetRuleResolver( m_ruleResolver );
+    aWorld->SetMaxClearance( worstClearance + m_ruleResolver->ClearanceEpsilon() );
+}
 
-        for( FP_ZONE* zone : footprint->Zones() )
-            syncZone( aWorld, zone, boardOutline );
 
-        for( BOARD_ITEM* mgitem : footprint->GraphicalItems() )
+bool PNS_KICAD_IFACE_BASE::UpdateWorld( PNS::NODE* aWorld )
+{
+    if( !m_board || !m_ruleResolver || aWorld != m_world || m_fullSyncNeeded )
+        return false;
+
+    if( m_dirtyItems.empty() )
+        return true;
+
+    std::unordered_set<const BOARD_ITEM*> staleParents;
+    std::vector<BOARD_ITEM*>              freshItems;
+
+    for( const std::pair<BOARD_ITEM* const, bool>& dirty : m_dirtyItems )
+    {
+        auto synced = m_syncedFootprints.find( dirty.first );
+
+        if( synced != m_syncedFootprints.end() )
         {
-            if( mgitem->Type() == PCB_FP_SHAPE_T || mgitem->Type() == PCB_FP_TEXTBOX_T )
-            {
-                syncGraphicalItem( aWorld, static_cast<PCB_SHAPE*>( mgitem ) );
-            }
-            else if( mgitem->Type() == PCB_FP_TEXT_T )
-            {
-                syncTextItem( aWorld, static_cast<FP_TEXT*>( mgitem ), mgitem->GetLayer() );
-            }
+            // Edge exclusions are not tied to their pads and can't be removed individually
+            if( synced->second.edgeExclusions )
+                return false;
+
+            staleParents.insert( synced->second.items.begin(), synced->second.items.end() );
         }
+
+        staleParents.insert( dirty.first );
+
+        if( dirty.second )
+            freshItems.push_back( dirty.first );
     }
 
-    for( PCB_TRACK* t : m_board->Tracks() )
+    for( BOARD_ITEM* item : freshItems )
     {
-        KICAD_T type = t->Type();
+        if( item->Type() != PCB_FOOTPRINT_T )
+            continue;
 
-        if( type == PCB_TRACE_T )
-        {
-            if( auto segment = syncTrack( t ) )
-                aWorld->Add( std::move( segment ) );
-        }
-        else if( type == PCB_ARC_T )
-        {
-            if( auto arc = syncArc( static_cast<PCB_ARC*>( t ) ) )
-                aWorld->Add( std::move( arc ) );
-        }
-        else if( type == PCB_VIA_T )
+        for( PAD* pad : static_cast<FOOTPRINT*>( item )->Pads() )
         {
-            if( auto via = syncVia( static_cast<PCB_VIA*>( t ) ) )
-                aWorld->Add( std::move( via ) );
+            if( pad->GetProperty() == PAD_PROP::CASTELLATED )
+                return false;
         }
     }
 
-    // NB: if this were ever to become a long-lived object we would need to dirty its
-    // clearance cache here....
-    delete m_ruleResolver;
-    m_ruleResolver = new PNS_PCBNEW_RULE_RESOLVER( m_board, this );
+    wxLogTrace( wxT( "PNS" ), wxT( "Updating world: %d stale, %d fresh board items" ),
+                (int) staleParents.size(), (int) freshItems.size() );
 
-    aWorld->SetRuleResolver( m_ruleResolver );
-    aWorld->SetMaxClearance( worstClearance + m_ruleResolver->ClearanceEpsilon() );
+    aWorld->RemoveByParents( staleParents );
+
+    for( const std::pair<BOARD_ITEM* const, bool>& dirty : m_dirtyItems )
+        m_syncedFootprints.erase( dirty.first );
+
+    m_dirtyItems.clear();
+
+    SHAPE_POLY_SET  buffer;
+    SHAPE_POLY_SET* boardOutline = nullptr;
+
+    // Only zones want the board outline, which isn't free to build
+    bool needsOutline = std::any_of( freshItems.begin(), freshItems.end(),
+                                     []( const BOARD_ITEM* aItem )
+                                     {
+                                         return aItem->Type() == PCB_ZONE_T
+                                                || aItem->Type() == PCB_FOOTPRINT_T;
+                                     } );
+
+    if( needsOutline && m_board->GetBoardPolygonOutlines( buffer ) )
+        boardOutline = &buffer;
+
+    for( BOARD_ITEM* item : freshItems )
+        syncBoardItem( aWorld, item, boardOutline );
+
+    // The clearance cache is keyed by item, some of which are gone now
+    m_ruleResolver->ClearCaches();
+
+    aWorld->SetMaxClearance( m_board->GetMaxClearanceValue()
+                             + m_ruleResolver->ClearanceEpsilon() );
+
+    return true;
+}
+
+
+void PNS_KICAD_IFACE_BASE::markDirty( BOARD_ITEM* aItem, bool aOnBoard )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_NETINFO_T:
+        // Net codes may have been reassigned
+        m_fullSyncNeeded = true;
+        return;
+
+    case PCB_GROUP_T:
+    case PCB_MARKER_T:
+        return;
+
+    default:
+        break;
+    }
+
+    // Footprint children are synced with (and removed along with) their footprint.  Don't
+    // resurrect a footprint whose removal is already pending.
+    if( BOARD_ITEM* footprint = aItem->GetParentFootprint() )
+    {
+        m_dirtyItems.emplace( footprint, true );
+        return;
+    }
+
+    m_dirtyItems[ aItem ] = aOnBoard;
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markDirty( aBoardItem, true );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemsAdded( BOARD& aBoard,
+                                              std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+        markDirty( item, true );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markDirty( aBoardItem, false );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemsRemoved( BOARD& aBoard,
+                                                std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+        markDirty( item, false );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem )
+{
+    markDirty( aBoardItem, true );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardItemsChanged( BOARD& aBoard,
+                                                std::vector<BOARD_ITEM*>& aBoardItems )
+{
+    for( BOARD_ITEM* item : aBoardItems )
+        markDirty( item, true );
+}
+
+
+void PNS_KICAD_IFACE_BASE::OnBoardNetSettingsChanged( BOARD& aBoard )
+{
+    // Net classes feed the clearances and widths of every item
+    m_fullSyncNeeded = true;
 }
 
 
@@ -22,8 +22,11 @@
 #ifndef __PNS_KICAD_IFACE_H
 #define __PNS_KICAD_IFACE_H
 
+#include <unordered_map>
 #include <unordered_set>
 
+#include <board.h>
+
 #include "pns_router.h"
 
 class PNS_PCBNEW_RULE_RESOLVER;
@@ -47,7 +50,7 @@ namespace KIGFX
     class VIEW;
 }
 
-class PNS_KICAD_IFACE_BASE : public PNS::ROUTER_IFACE
+class PNS_KICAD_IFACE_BASE : public PNS::ROUTER_IFACE, public BOARD_LISTENER
 {
 public:
     PNS_KICAD_IFACE_BASE();
@@ -56,6 +59,7 @@ public:
     void EraseView() override {};
     void SetBoard( BOARD* aBoard );
     void SyncWorld( PNS::NODE* aWorld ) override;
+    bool UpdateWorld( PNS::NODE* aWorld ) override;
     bool IsAnyLayerVisible( const LAYER_RANGE& aLayer ) const override { return true; };
     bool IsFlashedOnLayer( const PNS::ITEM* aItem, int aLayer ) const override;
     bool IsFlashedOnLayer( const PNS::ITEM* aItem, const LAYER_RANGE& aLayer ) const override;
@@ -87,6 +91,16 @@ public:
     PNS::RULE_RESOLVER* GetRuleResolver() override;
     PNS::DEBUG_DECORATOR* GetDebugDecorator() override;
 
+    // Board changes are collected while the interface is registered as a listener of its board
+    // and applied to the world by the next UpdateWorld().
+    void OnBoardItemAdded( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsAdded( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+    void OnBoardItemRemoved( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsRemoved( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+    void OnBoardItemChanged( BOARD& aBoard, BOARD_ITEM* aBoardItem ) override;
+    void OnBoardItemsChanged( BOARD& aBoard, std::vector<BOARD_ITEM*>& aBoardItems ) override;
+    void OnBoardNetSettingsChanged( BOARD& aBoard ) override;
+
 protected:
     PNS_PCBNEW_RULE_RESOLVER* m_ruleResolver;
     PNS::DEBUG_DECORATOR* m_debugDecorator;
@@ -98,12 +112,32 @@ protected:
     bool syncTextItem( PNS::NODE* aWorld, EDA_TEXT* aText, PCB_LAYER_ID aLayer );
     bool syncGraphicalItem( PNS::NODE* aWorld, PCB_SHAPE* aItem );
     bool syncZone( PNS::NODE* aWorld, ZONE* aZone, SHAPE_POLY_SET* aBoardOutline );
+    void syncFootprint( PNS::NODE* aWorld, FOOTPRINT* aFootprint, SHAPE_POLY_SET* aBoardOutline );
+    void syncBoardItem( PNS::NODE* aWorld, BOARD_ITEM* aItem, SHAPE_POLY_SET* aBoardOutline );
     bool inheritTrackWidth( PNS::ITEM* aItem, int* aInheritedWidth );
 
+    void markDirty( BOARD_ITEM* aItem, bool aOnBoard );
+
 protected:
     PNS::NODE* m_world;
     BOARD*     m_board;
     int        m_startLayer;
+
+private:
+    struct SYNCED_FOOTPRINT
+    {
+        std::vector<const BOARD_ITEM*> items;       ///< children which may have router items
+        bool                           edgeExclusions;
+    };
+
+    ///< Board items changed since the last sync, mapped to whether they are still on the board.
+    std::unordered_map<BOARD_ITEM*, bool>                   m_dirtyItems;
+
+    ///< The footprint children synced into the world, so that they can be removed again even
+    ///< once the footprint no longer owns them (e.g. after an undo).
+    std::unordered_map<const BOARD_ITEM*, SYNCED_FOOTPRINT> m_syncedFootprints;
+
+    bool                                                    m_fullSyncNeeded;
 };
 
 class PNS_KICAD_IFACE : public PNS_KICAD_IFACE_BASE
@@ -133,6 +167,12 @@ public:
 
     void SetCommitFlags( int aCommitFlags ) { m_commitFlags = aCommitFlags; }
 
+    /**
+     * Drop the board items hidden while routing without showing them again, for when they have
+     * been freed together with their board.
+     */
+    void ForgetHiddenItems() { m_hiddenItems.clear(); }
+
 private:
     struct OFFSET
     {
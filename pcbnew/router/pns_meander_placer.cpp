@@ -41,6 +41,7 @@ MEANDER_PLACER::MEANDER_PLACER( ROUTER* aRouter ) :
     m_lastLength = 0;
     m_lastStatus = TOO_SHORT;
     m_padToDieLength = 0;
+    m_origPathLength = 0;
 }
 
 
@@ -84,6 +85,9 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     if( m_endPad_n )
         m_padToDieLength += m_endPad_n->GetPadToDie();
 
+    // The tuned path doesn't change while moving the meanders
+    m_origPathLength = m_padToDieLength + lineLength( m_tunedPath, m_startPad_n, m_endPad_n );
+
     m_world->Remove( m_originLine );
 
     m_currentWidth = m_originLine.Width();
@@ -95,7 +99,7 @@ bool MEANDER_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 
 long long int MEANDER_PLACER::origPathLength() const
 {
-    return m_padToDieLength + lineLength( m_tunedPath, m_startPad_n, m_endPad_n );
+    return m_origPathLength;
 }
 
 
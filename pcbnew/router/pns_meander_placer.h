@@ -121,6 +121,9 @@ protected:
     ///< Total length added by pad to die size.
     int m_padToDieLength;
 
+    ///< Length of the tuned path (including pad to die) before tuning, computed by Start().
+    long long int m_origPathLength;
+
     long long int m_lastLength;
     TUNING_STATUS m_lastStatus;
 };
@@ -109,27 +109,19 @@ bool MEANDER_SKEW_PLACER::Start( const VECTOR2I& aP, ITEM* aStartItem )
     {
         m_coupledLength = m_padToDieN + lineLength( m_tunedPathN, m_startPad_n, m_endPad_n );
         m_tunedPath = m_tunedPathP;
+        m_origPathLength = m_padToDieP + lineLength( m_tunedPath, m_startPad_p, m_endPad_p );
     }
     else
     {
         m_coupledLength = m_padToDieP + lineLength( m_tunedPathP, m_startPad_p, m_endPad_p );
         m_tunedPath = m_tunedPathN;
+        m_origPathLength = m_padToDieN + lineLength( m_tunedPath, m_startPad_n, m_endPad_n );
     }
 
     return true;
 }
 
 
-long long int MEANDER_SKEW_PLACER::origPathLength() const
-{
-    if ( m_originPair.NetP() == m_originLine.Net() )
-        return m_padToDieP + lineLength( m_tunedPath, m_startPad_p, m_endPad_p );
-
-    return m_padToDieN + lineLength( m_tunedPath, m_startPad_n, m_endPad_n );
-
-}
-
-
 long long int MEANDER_SKEW_PLACER::currentSkew() const
 {
     return m_lastLength - m_coupledLength;
@@ -54,8 +54,6 @@ public:
 private:
     long long int currentSkew() const;
 
-    long long int origPathLength() const override;
-
     DIFF_PAIR m_originPair;
     ITEM_SET  m_tunedPath, m_tunedPathP, m_tunedPathN;
 
@@ -36,6 +36,7 @@
 #include "pns_itemset.h"
 #include "pns_line.h"
 #include "pns_node.h"
+#include "pns_perf_counters.h"
 #include "pns_via.h"
 #include "pns_solid.h"
 #include "pns_joint.h"
@@ -85,7 +86,7 @@ NODE::~NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
+    m_joints.Clear();
 
     std::vector<const ITEM*> toDelete;
 
@@ -143,6 +144,8 @@ int NODE::GetClearance( const ITEM* aA, const ITEM* aB, bool aUseClearanceEpsilo
 
 NODE* NODE::Branch()
 {
+    PNS_PERF_COUNT( nodeBranches )
+
     NODE* child = new NODE;
 
     m_children.insert( child );
@@ -154,24 +157,24 @@ NODE* NODE::Branch()
     child->m_maxClearance = m_maxClearance;
     child->m_collisionQueryScope = m_collisionQueryScope;
 
-    // Immediate offspring of the root branch needs not copy anything. For the rest, deep-copy
-    // joints, overridden item maps and pointers to stored items.
+    // The joints and overridden items are persistent maps: the child shares them with this node
+    // and only copies the parts it changes later on.
+    child->m_joints = m_joints.Branch();
+    child->m_override = m_override.Branch();
+
+    // Immediate offspring of the root branch needs not copy any items.  For the rest, copy the
+    // pointers to the stored items.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
         for( ITEM* item : *m_index )
             child->m_index->Add( item );
-
-        child->m_joints = m_joints;
-        child->m_override = m_override;
     }
 
 #if 0
     wxLogTrace( wxT( "PNS" ), wxT( "%d items, %d joints, %d overrides" ),
                 child->m_index->Size(),
-                (int) child->m_joints.size(),
-                (int) child->m_override.size() );
+                (int) child->m_joints.Size(),
+                (int) child->m_override.Size() );
 #endif
 
     return child;
@@ -244,12 +247,21 @@ struct NODE::DEFAULT_OBSTACLE_VISITOR : public OBSTACLE_VISITOR
 
         return true;
     };
+
+    ///< Batched queries: test the candidate against one of the items searched for.
+    bool operator()( ITEM* aCandidate, const ITEM* aItem )
+    {
+        m_item = aItem;
+        return ( *this )( aCandidate );
+    }
 };
 
 
 int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles,
                           const COLLISION_SEARCH_OPTIONS& aOpts ) const
 {
+    PNS_PERF_COUNT( collisionQueries )
+
     COLLISION_SEARCH_CONTEXT ctx( aObstacles, aOpts );
 
     /// By default, virtual items cannot collide
@@ -278,15 +290,54 @@ int NODE::QueryColliding( const ITEM* aItem, NODE::OBSTACLES& aObstacles,
 }
 
 
+int NODE::QueryColliding( const std::vector<const ITEM*>& aItems, NODE::OBSTACLES& aObstacles,
+                          const COLLISION_SEARCH_OPTIONS& aOpts ) const
+{
+    PNS_PERF_COUNT( collisionQueries )
+
+    COLLISION_SEARCH_CONTEXT ctx( aObstacles, aOpts );
+    std::vector<const ITEM*> items;
+
+    items.reserve( aItems.size() );
+
+    /// By default, virtual items cannot collide
+    for( const ITEM* item : aItems )
+    {
+        if( !item->IsVirtual() )
+            items.push_back( item );
+    }
+
+    if( items.empty() )
+        return 0;
+
+    DEFAULT_OBSTACLE_VISITOR visitor( &ctx, nullptr );
+
+    visitor.SetWorld( this, nullptr );
+
+    // first, look for colliding items in the local index
+    m_index->Query( items, m_maxClearance, visitor );
+
+    // if we haven't found enough items, look in the root branch as well.
+    if( !isRoot() && ( ctx.obstacles.size() < aOpts.m_limitCount || aOpts.m_limitCount < 0 ) )
+    {
+        visitor.SetWorld( m_root, this );
+        m_root->m_index->Query( items, m_maxClearance, visitor );
+    }
+
+    return aObstacles.size();
+}
+
+
 NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine,
                                           const COLLISION_SEARCH_OPTIONS& aOpts )
 {
     const int            clearanceEpsilon = GetRuleResolver()->ClearanceEpsilon();
     OBSTACLES            obstacleList;
     std::vector<SEGMENT> tmpSegs;
+    std::vector<const ITEM*> queryItems;
 
     tmpSegs.reserve( aLine->CLine().SegmentCount() );
-
+    queryItems.reserve( aLine->CLine().SegmentCount() + 1 );
 
     for( int i = 0; i < aLine->CLine().SegmentCount(); i++ )
     {
@@ -295,11 +346,13 @@ NODE::OPT_OBSTACLE NODE::NearestObstacle( const LINE* aLine,
         // Disabling the cache will lead to slowness.
 
         tmpSegs.emplace_back( *aLine, aLine->CLine().CSegment( i ) );
-        QueryColliding( &tmpSegs.back(), obstacleList, aOpts );
+        queryItems.push_back( &tmpSegs.back() );
     }
 
     if( aLine->EndsWithVia() )
-        QueryColliding( &aLine->Via(), obstacleList, aOpts );
+        queryItems.push_back( &aLine->Via() );
+
+    QueryColliding( queryItems, obstacleList, aOpts );
 
     if( obstacleList.empty() )
         return OPT_OBSTACLE();
@@ -398,30 +451,29 @@ NODE::OPT_OBSTACLE NODE::CheckColliding( const ITEM* aItemA, int aKindMask )
 
     if( aItemA->Kind() == ITEM::LINE_T )
     {
-        int n = 0;
         const LINE* line = static_cast<const LINE*>( aItemA );
         const SHAPE_LINE_CHAIN& l = line->CLine();
+        std::vector<SEGMENT> segs;
+        std::vector<const ITEM*> queryItems;
+
+        segs.reserve( l.SegmentCount() );
+        queryItems.reserve( l.SegmentCount() + 1 );
 
         for( int i = 0; i < l.SegmentCount(); i++ )
         {
-            // Note: Clearances between &s and other items are cached,
+            // Note: Clearances between the segments and other items are cached,
             // which means they'll be the same for all segments in the line.
             // Disabling the cache will lead to slowness.
 
-            const SEGMENT s( *line, l.CSegment( i ) );
-            n += QueryColliding( &s, obs, opts );
-
-            if( n )
-                return OPT_OBSTACLE( *obs.begin() );
+            segs.emplace_back( *line, l.CSegment( i ) );
+            queryItems.push_back( &segs.back() );
         }
 
         if( line->EndsWithVia() )
-        {
-            n += QueryColliding( &line->Via(), obs, opts );
+            queryItems.push_back( &line->Via() );
 
-            if( n )
-                return OPT_OBSTACLE( *obs.begin() );
-        }
+        if( QueryColliding( queryItems, obs, opts ) > 0 )
+            return OPT_OBSTACLE( *obs.begin() );
     }
     else if( QueryColliding( aItemA, obs, opts ) > 0 )
     {
@@ -702,10 +754,10 @@ void NODE::doRemove( ITEM* aItem )
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
     {
-        m_override.insert( aItem );
-    
+        m_override.Touch( aItem ) = true;
+
         if( aItem->HasHole() )
-            m_override.insert( aItem->Hole() );
+            m_override.Touch( aItem->Hole() ) = true;
     }
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
@@ -763,28 +815,22 @@ void NODE::rebuildJoint( const JOINT* aJoint, const ITEM* aItem )
     tag.net = net;
     tag.pos = aJoint->Pos();
 
-    bool split;
-
-    do
-    {
-        split = false;
-        auto range = m_joints.equal_range( tag );
+    if( !m_joints.Find( tag ) )
+        return;
 
-        if( range.first == m_joints.end() )
-            break;
+    // find and remove all joints containing the via to be removed
+    JOINT_LIST& joints = m_joints.Touch( tag );
 
-        // find and remove all joints containing the via to be removed
+    for( auto f = joints.begin(); f != joints.end(); )
+    {
+        if( aItem->LayersOverlap( &*f ) )
+            f = joints.erase( f );
+        else
+            ++f;
+    }
 
-        for( auto f = range.first; f != range.second; ++f )
-        {
-            if( aItem->LayersOverlap( &f->second ) )
-            {
-                m_joints.erase( f );
-                split = true;
-                break;
-            }
-        }
-    } while( split );
+    if( joints.empty() )
+        m_joints.Erase( tag );
 
     // and re-link them, using the former via's link list
     for( ITEM* link : links )
@@ -1116,10 +1162,30 @@ void NODE::FixupVirtualVias()
 {
     const SEGMENT* locked_seg = nullptr;
     std::vector<VVIA*> vvias;
+    std::vector<ITEM*> staleVvias;
+
+    // Drop the virtual vias of a previous fixup, e.g. after the node was updated in place
+    for( ITEM* item : *m_index )
+    {
+        if( item->OfKind( ITEM::VIA_T ) && item->IsVirtual() )
+            staleVvias.push_back( item );
+    }
 
-    for( auto& jointPair : m_joints )
+    for( ITEM* item : staleVvias )
+        Remove( item );
+
+    std::vector<const JOINT*> joints;
+
+    m_joints.ForEach(
+            [&]( const JOINT::HASH_TAG& aTag, const JOINT_LIST& aJoints )
+            {
+                for( const JOINT& joint : aJoints )
+                    joints.push_back( &joint );
+            } );
+
+    for( const JOINT* jointPtr : joints )
     {
-        JOINT joint = jointPair.second;
+        const JOINT& joint = *jointPtr;
 
         if( joint.Layers().IsMultilayer() )
             continue;
@@ -1190,23 +1256,16 @@ const JOINT* NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet ) const
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::const_iterator f = m_joints.find( tag ), end = m_joints.end();
-
-    if( f == end && !isRoot() )
-    {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
-    }
+    // Branches share the joints of their parents, there is no need to look in the root
+    const JOINT_LIST* joints = m_joints.Find( tag );
 
-    if( f == end )
+    if( !joints )
         return nullptr;
 
-    while( f != end )
+    for( const JOINT& joint : *joints )
     {
-        if( f->second.Layers().Overlaps( aLayer ) )
-            return &f->second;
-
-        ++f;
+        if( joint.Layers().Overlaps( aLayer ) )
+            return &joint;
     }
 
     return nullptr;
@@ -1227,46 +1286,27 @@ JOINT& NODE::touchJoint( const VECTOR2I& aPos, const LAYER_RANGE& aLayers, int a
     tag.pos = aPos;
     tag.net = aNet;
 
-    // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
-
-    std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
-
-    // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
-    {
-        range = m_root->m_joints.equal_range( tag );
-
-        for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
-    }
+    // find the joints at this location, copying them from the parent node if they are shared.
+    JOINT_LIST& joints = m_joints.Touch( tag );
 
     // now insert and combine overlapping joints
     JOINT jt( aPos, aLayers, aNet );
 
-    bool merged;
-
-    do
+    for( auto f = joints.begin(); f != joints.end(); )
     {
-        merged  = false;
-        range   = m_joints.equal_range( tag );
-
-        if( range.first == m_joints.end() )
-            break;
-
-        for( f = range.first; f != range.second; ++f )
+        if( aLayers.Overlaps( f->Layers() ) )
         {
-            if( aLayers.Overlaps( f->second.Layers() ) )
-            {
-                jt.Merge( f->second );
-                m_joints.erase( f );
-                merged = true;
-                break;
-            }
+            jt.Merge( *f );
+            f = joints.erase( f );
+        }
+        else
+        {
+            ++f;
         }
-    } while( merged );
+    }
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    joints.push_back( jt );
+    return joints.back();
 }
 
 
@@ -1390,14 +1430,17 @@ void NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
     if( isRoot() )
         return;
 
-    if( m_override.size() )
-        aRemoved.reserve( m_override.size() );
+    if( m_override.Size() )
+        aRemoved.reserve( m_override.Size() );
 
     if( m_index->Size() )
         aAdded.reserve( m_index->Size() );
 
-    for( ITEM* item : m_override )
-        aRemoved.push_back( item );
+    m_override.ForEach(
+            [&]( ITEM* aItem, bool )
+            {
+                aRemoved.push_back( aItem );
+            } );
 
     for( INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
         aAdded.push_back( *i );
@@ -1445,8 +1488,11 @@ void NODE::Commit( NODE* aNode )
     if( aNode->isRoot() )
         return;
 
-    for( ITEM* item : aNode->m_override )
-        Remove( item );
+    aNode->m_override.ForEach(
+            [&]( ITEM* aItem, bool )
+            {
+                Remove( aItem );
+            } );
 
     for( ITEM* item : *aNode->m_index )
     {
@@ -1525,6 +1571,26 @@ void NODE::RemoveByMarker( int aMarker )
 }
 
 
+void NODE::RemoveByParents( const std::unordered_set<const BOARD_ITEM*>& aParents )
+{
+    assert( isRoot() );
+
+    std::vector<ITEM*> found;
+
+    for( const BOARD_ITEM* parent : aParents )
+        m_index->GetItemsForParent( parent, found );
+
+    for( ITEM* item : found )
+    {
+        // holes are removed along with the pad or via owning them
+        if( !item->OfKind( ITEM::HOLE_T ) )
+            Remove( item );
+    }
+
+    releaseGarbage();
+}
+
+
 SEGMENT* NODE::findRedundantSegment( const VECTOR2I& A, const VECTOR2I& B, const LAYER_RANGE& lr,
                                      int aNet )
 {
@@ -1595,39 +1661,29 @@ ARC* NODE::findRedundantArc( ARC* aArc )
 }
 
 
-int NODE::QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints, LAYER_RANGE aLayerMask,
-                       int aKindMask )
+int NODE::QueryJoints( const BOX2I& aBox, std::vector<const JOINT*>& aJoints,
+                       LAYER_RANGE aLayerMask, int aKindMask )
 {
     int n = 0;
 
     aJoints.clear();
 
-    for( JOINT_MAP::value_type& j : m_joints )
-    {
-        if( !j.second.Layers().Overlaps( aLayerMask ) )
-            continue;
-
-        if( aBox.Contains( j.second.Pos() ) && j.second.LinkCount( aKindMask ) )
-        {
-            aJoints.push_back( &j.second );
-            n++;
-        }
-    }
-
-    if( isRoot() )
-        return n;
-
-    for( JOINT_MAP::value_type& j : m_root->m_joints )
-    {
-        if( !Overrides( &j.second ) && j.second.Layers().Overlaps( aLayerMask ) )
-        {
-            if( aBox.Contains( j.second.Pos() ) && j.second.LinkCount( aKindMask ) )
+    // The joints of the root are shared with the branches, so this covers them too
+    m_joints.ForEach(
+            [&]( const JOINT::HASH_TAG& aTag, const JOINT_LIST& aJointsAtTag )
             {
-                aJoints.push_back( &j.second );
-                n++;
-            }
-        }
-    }
+                for( const JOINT& joint : aJointsAtTag )
+                {
+                    if( !joint.Layers().Overlaps( aLayerMask ) )
+                        continue;
+
+                    if( aBox.Contains( joint.Pos() ) && joint.LinkCount( aKindMask ) )
+                    {
+                        aJoints.push_back( &joint );
+                        n++;
+                    }
+                }
+            } );
 
     return n;
 }
@@ -26,6 +26,7 @@
 #include <vector>
 #include <list>
 #include <set>
+#include <unordered_set>
 #include <core/minoptmax.h>
 
 #include <geometry/shape_line_chain.h>
@@ -34,6 +35,7 @@
 #include "pns_item.h"
 #include "pns_joint.h"
 #include "pns_itemset.h"
+#include "pns_persistent_map.h"
 
 namespace PNS {
 
@@ -237,10 +239,10 @@ public:
         return m_ruleResolver;
     }
 
-    ///< Return the number of joints.
+    ///< Return the number of joint locations (position and net).
     int JointCount() const
     {
-        return m_joints.size();
+        return m_joints.Size();
     }
 
     ///< Return the number of nodes in the inheritance chain (wrs to the root node).
@@ -261,7 +263,20 @@ public:
     int QueryColliding( const ITEM* aItem, OBSTACLES& aObstacles,
                         const COLLISION_SEARCH_OPTIONS& aOpts = COLLISION_SEARCH_OPTIONS() ) const;
 
-    int QueryJoints( const BOX2I& aBox, std::vector<JOINT*>& aJoints,
+    /**
+     * Find items colliding (closer than clearance) with any of \a aItems, typically the
+     * segments and the via of a line.  Items close to each other share a single search of the
+     * spatial index.
+     *
+     * @param aItems items to check collisions against
+     * @param aObstacles set of colliding objects found
+     * @param aOpts collision search options
+     * @return number of obstacles found
+     */
+    int QueryColliding( const std::vector<const ITEM*>& aItems, OBSTACLES& aObstacles,
+                        const COLLISION_SEARCH_OPTIONS& aOpts = COLLISION_SEARCH_OPTIONS() ) const;
+
+    int QueryJoints( const BOX2I& aBox, std::vector<const JOINT*>& aJoints,
                      LAYER_RANGE aLayerMask = LAYER_RANGE::All(), int aKindMask = ITEM::ANY_T );
 
     /**
@@ -352,6 +367,14 @@ public:
      * Create a lightweight copy (called branch) of self that tracks the changes (added/removed
      * items) wrs to the root.
      *
+     * The joints and overridden items are shared with this node rather than copied, so neither
+     * this node nor the branch should be expected to see the changes later made to the other.
+     *
+     * @note A branch of the root snapshots the root's joints, but searches the root's item index
+     *       live.  The root must thus not be modified while it has branches, or they would find
+     *       the new items without their joints.  Commit() releases all the branches for this
+     *       reason; anything else changing the root must call KillChildren() first.
+     *
      * @note If there are any branches in use, their parents must **not** be deleted.
      *
      * @return the new branch.
@@ -428,6 +451,12 @@ public:
 
     void RemoveByMarker( int aMarker );
 
+    /**
+     * Remove (and free) all items created from one of the board items in \a aParents.  Used to
+     * update the root node in place when the board changes, applicable only to the root node.
+     */
+    void RemoveByParents( const std::unordered_set<const BOARD_ITEM*>& aParents );
+
     ITEM* FindItemByParent( const BOARD_ITEM* aParent );
 
     bool HasChildren() const
@@ -443,9 +472,10 @@ public:
     ///< Check if this branch contains an updated version of the m_item from the root branch.
     bool Overrides( ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override.Find( aItem ) != nullptr;
     }
 
+    ///< Replace the virtual vias of the node with ones matching its current joints.
     void FixupVirtualVias();
 
     void SetCollisionQueryScope( COLLISION_QUERY_SCOPE aScope )
@@ -516,18 +546,17 @@ private:
 
 private:
     struct DEFAULT_OBSTACLE_VISITOR;
-    typedef std::unordered_multimap<JOINT::HASH_TAG, JOINT, JOINT::JOINT_TAG_HASH> JOINT_MAP;
-    typedef JOINT_MAP::value_type TagJointPair;
+    typedef std::list<JOINT>                                                  JOINT_LIST;
+    typedef PERSISTENT_MAP<JOINT::HASH_TAG, JOINT_LIST, JOINT::JOINT_TAG_HASH> JOINT_MAP;
 
-    JOINT_MAP       m_joints;           ///< hash table with the joints, linking the items. Joints
-                                        ///< are hashed by their position, layer set and net.
+    JOINT_MAP       m_joints;           ///< the joints linking the items, hashed by their
+                                        ///< position and net, shared with the parent node.
 
     NODE*           m_parent;           ///< node this node was branched from
     NODE*           m_root;             ///< root node of the whole hierarchy
     std::set<NODE*> m_children;         ///< list of nodes branched from this one
 
-    std::unordered_set<ITEM*> m_override;   ///< hash of root's items that have been changed
-                                            ///< in this node
+    PERSISTENT_MAP<ITEM*, bool> m_override; ///< root's items that have been changed in this node
 
     int             m_maxClearance;     ///< worst case item-item clearance
     RULE_RESOLVER*  m_ruleResolver;     ///< Design rules resolver
@@ -24,6 +24,9 @@
 #include <geometry/shape_simple.h>
 
 #include <cmath>
+#include <future>
+
+#include <thread_pool.h>
 
 #include "pns_arc.h"
 #include "pns_line.h"
@@ -372,14 +375,14 @@ bool KEEP_TOPOLOGY_CONSTRAINT::Check( int aVertex1, int aVertex2, const LINE* aO
     encPoly.SetClosed( true );
 
     BOX2I bb = encPoly.BBox();
-    std::vector<JOINT*> joints;
+    std::vector<const JOINT*> joints;
 
     int cnt = m_world->QueryJoints( bb, joints, aOriginLine->Layers(), ITEM::SOLID_T );
 
     if( !cnt )
         return true;
 
-    for( JOINT* j : joints )
+    for( const JOINT* j : joints )
     {
         if( j->Net() == aOriginLine->Net() )
             continue;
@@ -1092,6 +1095,128 @@ bool OPTIMIZER::runSmartPads( LINE* aLine )
 }
 
 
+BOX2I OPTIMIZER::lineRegion( const LINE& aLine ) const
+{
+    BOX2I region = aLine.CLine().BBox();
+
+    if( aLine.EndsWithVia() )
+        region.Merge( aLine.Via().Shape()->BBox() );
+
+    // Smart pads may reroute the line's exits from the pads or vias it ends on
+    if( ( m_effortLevel & SMART_PADS ) && aLine.PointCount() > 0 )
+    {
+        for( const VECTOR2I& p : { aLine.CPoint( 0 ), aLine.CPoint( -1 ) } )
+        {
+            if( ITEM* padOrVia = findPadOrVia( aLine.Layer(), aLine.Net(), p ) )
+            {
+                BOX2I bbox = padOrVia->Shape()->BBox();
+                bbox.Inflate( std::max( bbox.GetWidth(), bbox.GetHeight() ) );
+                region.Merge( bbox );
+            }
+        }
+    }
+
+    // Covers the clearance checks of the optimized line against its neighbours
+    region.Inflate( aLine.Width() + m_world->GetMaxClearance() );
+
+    return region;
+}
+
+
+void OPTIMIZER::OptimizeBatch( const std::vector<LINE*>& aLines, const std::vector<LINE*>& aRoots,
+                               const std::function<void( size_t, LINE& )>& aCommit )
+{
+    DEBUG_DECORATOR* dbg = ROUTER::GetInstance()->GetInterface()->GetDebugDecorator();
+
+    // A line must wait for the results of all the lines before it that it comes close to, so
+    // sort the lines into levels where all the lines of a level only depend on earlier levels.
+    std::vector<BOX2I> regions;
+    std::vector<int>   levels;
+    int                levelCount = 0;
+
+    regions.reserve( aLines.size() );
+    levels.reserve( aLines.size() );
+
+    for( size_t i = 0; i < aLines.size(); i++ )
+    {
+        int level = 0;
+
+        regions.push_back( lineRegion( *aLines[i] ) );
+
+        for( size_t j = 0; j < i; j++ )
+        {
+            if( levels[j] >= level && regions[j].Intersects( regions[i] ) )
+                level = levels[j] + 1;
+        }
+
+        levels.push_back( level );
+        levelCount = std::max( levelCount, level + 1 );
+    }
+
+    std::vector<LINE> results( aLines.size() );
+    std::vector<char> optimized( aLines.size(), 0 );
+
+    auto optimizeLine =
+            [&]( size_t aIndex )
+            {
+                OPTIMIZER opt( m_world );
+
+                opt.m_collisionKindMask = m_collisionKindMask;
+                opt.m_effortLevel = m_effortLevel;
+                opt.m_preservedVertex = m_preservedVertex;
+                opt.m_restrictedVertexRange = m_restrictedVertexRange;
+                opt.m_restrictArea = m_restrictArea;
+                opt.m_restrictAreaIsStrict = m_restrictAreaIsStrict;
+
+                LINE* root = aRoots.empty() ? nullptr : aRoots[aIndex];
+
+                optimized[aIndex] = opt.Optimize( aLines[aIndex], &results[aIndex], root );
+                opt.ClearConstraints();
+            };
+
+    // The debug decorator can only record from a single thread
+    bool         concurrent = !( dbg && dbg->IsDebugEnabled() );
+    thread_pool& tp = GetKiCadThreadPool();
+
+    for( int level = 0; level < levelCount; level++ )
+    {
+        std::vector<size_t> batch;
+
+        for( size_t i = 0; i < aLines.size(); i++ )
+        {
+            if( levels[i] == level )
+                batch.push_back( i );
+        }
+
+        if( concurrent && batch.size() > 1 )
+        {
+            std::vector<std::future<void>> returns;
+
+            returns.reserve( batch.size() - 1 );
+
+            for( size_t k = 1; k < batch.size(); k++ )
+                returns.push_back( tp.submit( optimizeLine, batch[k] ) );
+
+            optimizeLine( batch[0] );
+
+            for( std::future<void>& ret : returns )
+                ret.wait();
+        }
+        else
+        {
+            for( size_t i : batch )
+                optimizeLine( i );
+        }
+
+        for( size_t i : batch )
+        {
+            if( optimized[i] )
+                aCommit( i, results[i] );
+        }
+    }
+}
+
+
 bool OPTIMIZER::Optimize( LINE* aLine, int aEffortLevel, NODE* aWorld, const VECTOR2I& aV )
 {
     OPTIMIZER opt( aWorld );
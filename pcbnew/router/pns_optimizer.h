@@ -23,8 +23,10 @@
 #ifndef __PNS_OPTIMIZER_H
 #define __PNS_OPTIMIZER_H
 
+#include <functional>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 #include <geometry/shape_index_list.h>
 #include <geometry/shape_line_chain.h>
@@ -119,6 +121,25 @@ public:
     bool Optimize( LINE* aLine, LINE* aResult = nullptr, LINE* aRoot = nullptr );
     bool Optimize( DIFF_PAIR* aPair );
 
+    /**
+     * Optimize many lines with the settings of this optimizer, with the same results as
+     * optimizing them one after the other and committing each result to the world in turn.
+     *
+     * Each line is optimized against the world by a private optimizer, so the constraints
+     * added for one line don't apply to the others.  Lines which don't come close to any line
+     * before them in \a aLines are independent of them and are optimized concurrently on the
+     * thread pool, with the world left untouched.  Their results are then committed in the
+     * order of \a aLines, which may update the world before the lines depending on them are
+     * optimized.
+     *
+     * @param aLines lines to optimize.
+     * @param aRoots optional root line of each line (see Optimize()), may be left empty.
+     * @param aCommit called on the calling thread with the index of each line that got
+     *                optimized and the optimized line.
+     */
+    void OptimizeBatch( const std::vector<LINE*>& aLines, const std::vector<LINE*>& aRoots,
+                        const std::function<void( size_t, LINE& )>& aCommit );
+
 
     void SetWorld( NODE* aNode ) { m_world = aNode; }
     void CacheRemove( ITEM* aItem );
@@ -197,6 +218,9 @@ private:
 
     ITEM* findPadOrVia( int aLayer, int aNet, const VECTOR2I& aP ) const;
 
+    ///< Return the area the optimization of \a aLine may depend on or change.
+    BOX2I lineRegion( const LINE& aLine ) const;
+
 private:
     SHAPE_INDEX_LIST<ITEM*>                m_cache;
     std::vector<OPT_CONSTRAINT*>           m_constraints;
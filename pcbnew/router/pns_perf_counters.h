@@ -0,0 +1,82 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_PERF_COUNTERS_H
+#define __PNS_PERF_COUNTERS_H
+
+#include <atomic>
+
+#include <profile.h>
+
+namespace PNS {
+
+/**
+ * Process-wide counts of the router's most frequent operations, read by the log replay
+ * benchmark.  The counters are atomic as the walkaround explores both directions concurrently.
+ *
+ * Counting is off unless a tool calls Enable(), so the interactive router only pays for a
+ * relaxed load of the flag.  Use PNS_PERF_COUNT() to bump a counter.
+ */
+struct PERF_COUNTERS
+{
+    PERF_COUNTERS() :
+            collisionQueries( "collision queries" ),
+            nodeBranches( "node branches" ),
+            shoveIterations( "shove iterations" )
+    {}
+
+    void Reset()
+    {
+        collisionQueries.Reset();
+        nodeBranches.Reset();
+        shoveIterations.Reset();
+    }
+
+    static PERF_COUNTERS& Get()
+    {
+        static PERF_COUNTERS s_counters;
+        return s_counters;
+    }
+
+    static void Enable( bool aEnabled )
+    {
+        enabledFlag().store( aEnabled, std::memory_order_relaxed );
+    }
+
+    static bool Enabled() { return enabledFlag().load( std::memory_order_relaxed ); }
+
+    PROF_COUNTER collisionQueries;      ///< calls to NODE::QueryColliding()
+    PROF_COUNTER nodeBranches;          ///< calls to NODE::Branch()
+    PROF_COUNTER shoveIterations;       ///< iterations of the shove main loop
+
+private:
+    static std::atomic<bool>& enabledFlag()
+    {
+        static std::atomic<bool> s_enabled( false );
+        return s_enabled;
+    }
+};
+
+}
+
+#define PNS_PERF_COUNT( counter )                                                                  \
+    if( PNS::PERF_COUNTERS::Enabled() )                                                            \
+        PNS::PERF_COUNTERS::Get().counter++;
+
+#endif    // __PNS_PERF_COUNTERS_H
@@ -0,0 +1,364 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_PERSISTENT_MAP_H
+#define __PNS_PERSISTENT_MAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace PNS {
+
+/**
+ * A hash map whose copies share their structure (a hash array mapped trie), so that copying
+ * one is O(1) and lookups and updates are O(log n).
+ *
+ * Each map only modifies in place the trie nodes and values it created since it was last
+ * branched; anything shared with another map is cloned on its first modification.  Branching
+ * therefore snapshots both the source and the branch: later changes to either one are never seen
+ * by the other.
+ *
+ * Maps can't be copied, only branched, as branching gives up the source's ownership of its trie
+ * and thus modifies it.  Branching a map that other threads are reading is fine, modifying it is
+ * not.
+ *
+ * References to values stay valid until the value is erased or the map is modified after
+ * having been branched.
+ */
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>,
+          typename EQUAL = std::equal_to<KEY>>
+class PERSISTENT_MAP
+{
+public:
+    PERSISTENT_MAP() :
+            m_size( 0 ),
+            m_owner( newOwner() )
+    {}
+
+    PERSISTENT_MAP( const PERSISTENT_MAP& aOther ) = delete;
+    PERSISTENT_MAP& operator=( const PERSISTENT_MAP& aOther ) = delete;
+
+    PERSISTENT_MAP( PERSISTENT_MAP&& aOther ) noexcept :
+            m_root( std::move( aOther.m_root ) ),
+            m_size( aOther.m_size ),
+            m_owner( aOther.m_owner )
+    {
+        aOther.m_size = 0;
+        aOther.m_owner = newOwner();
+    }
+
+    PERSISTENT_MAP& operator=( PERSISTENT_MAP&& aOther ) noexcept
+    {
+        if( this != &aOther )
+        {
+            m_root = std::move( aOther.m_root );
+            m_size = aOther.m_size;
+            m_owner = aOther.m_owner;
+            aOther.m_size = 0;
+            aOther.m_owner = newOwner();
+        }
+
+        return *this;
+    }
+
+    /**
+     * Return a map with the same contents, sharing the whole trie with this one.
+     *
+     * Neither map owns the shared trie afterwards, so both clone what they modify from then on.
+     */
+    PERSISTENT_MAP Branch()
+    {
+        PERSISTENT_MAP branch;
+
+        branch.m_root = m_root;
+        branch.m_size = m_size;
+        m_owner = newOwner();
+
+        return branch;
+    }
+
+    size_t Size() const { return m_size; }
+
+    bool Empty() const { return m_size == 0; }
+
+    void Clear()
+    {
+        m_root.reset();
+        m_size = 0;
+    }
+
+    /**
+     * @return the value stored for \a aKey or nullptr if there is none.
+     */
+    const VALUE* Find( const KEY& aKey ) const
+    {
+        size_t           hash = hashOf( aKey );
+        const TRIE_NODE* node = m_root.get();
+
+        for( int shift = 0; node; shift += BITS )
+        {
+            if( node->m_leaf )
+            {
+                for( const ENTRY& entry : node->m_entries )
+                {
+                    if( entry.m_hash == hash && EQUAL()( entry.m_key, aKey ) )
+                        return entry.m_value.get();
+                }
+
+                return nullptr;
+            }
+
+            uint32_t bit = 1u << ( ( hash >> shift ) & MASK );
+
+            if( !( node->m_bitmap & bit ) )
+                return nullptr;
+
+            node = node->m_children[childIndex( node->m_bitmap, bit )].get();
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * Return the value stored for \a aKey, owned by this map and thus safe to modify, adding a
+     * default-constructed one if there is none.
+     */
+    VALUE& Touch( const KEY& aKey )
+    {
+        size_t                      hash = hashOf( aKey );
+        std::shared_ptr<TRIE_NODE>* slot = &m_root;
+
+        for( int shift = 0; ; )
+        {
+            if( !*slot )
+                *slot = std::make_shared<TRIE_NODE>( m_owner, true );
+
+            TRIE_NODE* node = own( *slot );
+
+            if( node->m_leaf )
+            {
+                for( ENTRY& entry : node->m_entries )
+                {
+                    if( entry.m_hash == hash && EQUAL()( entry.m_key, aKey ) )
+                        return own( entry );
+                }
+
+                // Leaves at the bottom of the trie have used up all the hash bits and simply
+                // collect the collisions
+                if( node->m_entries.size() < LEAF_CAPACITY || shift >= HASH_BITS )
+                {
+                    node->m_entries.push_back( { hash, aKey, std::make_shared<VALUE>(), m_owner } );
+                    m_size++;
+                    return *node->m_entries.back().m_value;
+                }
+
+                split( node, shift );
+            }
+
+            uint32_t bit = 1u << ( ( hash >> shift ) & MASK );
+
+            if( !( node->m_bitmap & bit ) )
+            {
+                node->m_bitmap |= bit;
+                node->m_children.emplace( node->m_children.begin()
+                                                  + childIndex( node->m_bitmap, bit ),
+                                          nullptr );
+            }
+
+            slot = &node->m_children[childIndex( node->m_bitmap, bit )];
+            shift += BITS;
+        }
+    }
+
+    /**
+     * Remove \a aKey and its value from the map.
+     *
+     * @return false if there was no such key.
+     */
+    bool Erase( const KEY& aKey )
+    {
+        // Don't clone the path to a key that isn't there
+        if( !Find( aKey ) )
+            return false;
+
+        size_t                      hash = hashOf( aKey );
+        std::shared_ptr<TRIE_NODE>* slot = &m_root;
+
+        for( int shift = 0; ; shift += BITS )
+        {
+            TRIE_NODE* node = own( *slot );
+
+            if( node->m_leaf )
+            {
+                for( auto it = node->m_entries.begin(); it != node->m_entries.end(); ++it )
+                {
+                    if( it->m_hash == hash && EQUAL()( it->m_key, aKey ) )
+                    {
+                        node->m_entries.erase( it );
+                        m_size--;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            uint32_t bit = 1u << ( ( hash >> shift ) & MASK );
+            slot = &node->m_children[childIndex( node->m_bitmap, bit )];
+        }
+    }
+
+    /**
+     * Call \a aFunc( const KEY&, const VALUE& ) for every entry, in no particular order.
+     */
+    template <typename FUNC>
+    void ForEach( FUNC&& aFunc ) const
+    {
+        if( m_root )
+            forEach( m_root.get(), aFunc );
+    }
+
+private:
+    static constexpr int    BITS = 5;
+    static constexpr size_t MASK = ( 1 << BITS ) - 1;
+    static constexpr int    HASH_BITS = sizeof( size_t ) * 8;
+    static constexpr size_t LEAF_CAPACITY = 8;
+
+    struct ENTRY
+    {
+        size_t                 m_hash;
+        KEY                    m_key;
+        std::shared_ptr<VALUE> m_value;
+        uint64_t               m_owner;
+    };
+
+    struct TRIE_NODE
+    {
+        TRIE_NODE( uint64_t aOwner, bool aLeaf ) :
+                m_owner( aOwner ),
+                m_leaf( aLeaf ),
+                m_bitmap( 0 )
+        {}
+
+        uint64_t                                m_owner;
+        bool                                    m_leaf;
+        uint32_t                                m_bitmap;   ///< occupied child slots
+        std::vector<std::shared_ptr<TRIE_NODE>> m_children;
+        std::vector<ENTRY>                      m_entries;
+    };
+
+    static uint64_t newOwner()
+    {
+        static std::atomic<uint64_t> s_lastOwner( 0 );
+        return ++s_lastOwner;
+    }
+
+    static size_t hashOf( const KEY& aKey )
+    {
+        // The trie consumes the hash a few bits at a time, so spread weak hashes over all of them
+        uint64_t h = HASH()( aKey );
+
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+
+        return static_cast<size_t>( h );
+    }
+
+    static int childIndex( uint32_t aBitmap, uint32_t aBit )
+    {
+        uint32_t below = aBitmap & ( aBit - 1 );
+        int      count = 0;
+
+        for( ; below; below &= below - 1 )
+            count++;
+
+        return count;
+    }
+
+    TRIE_NODE* own( std::shared_ptr<TRIE_NODE>& aNode )
+    {
+        if( aNode->m_owner != m_owner )
+        {
+            aNode = std::make_shared<TRIE_NODE>( *aNode );
+            aNode->m_owner = m_owner;
+        }
+
+        return aNode.get();
+    }
+
+    VALUE& own( ENTRY& aEntry )
+    {
+        if( aEntry.m_owner != m_owner )
+        {
+            aEntry.m_value = std::make_shared<VALUE>( *aEntry.m_value );
+            aEntry.m_owner = m_owner;
+        }
+
+        return *aEntry.m_value;
+    }
+
+    ///< Turn a full leaf into an inner node with its entries distributed over new leaves.
+    void split( TRIE_NODE* aNode, int aShift )
+    {
+        std::vector<ENTRY> entries;
+
+        entries.swap( aNode->m_entries );
+        aNode->m_leaf = false;
+
+        for( ENTRY& entry : entries )
+        {
+            uint32_t bit = 1u << ( ( entry.m_hash >> aShift ) & MASK );
+
+            if( !( aNode->m_bitmap & bit ) )
+            {
+                aNode->m_bitmap |= bit;
+                aNode->m_children.emplace( aNode->m_children.begin()
+                                                   + childIndex( aNode->m_bitmap, bit ),
+                                           std::make_shared<TRIE_NODE>( m_owner, true ) );
+            }
+
+            TRIE_NODE* leaf = aNode->m_children[childIndex( aNode->m_bitmap, bit )].get();
+            leaf->m_entries.push_back( std::move( entry ) );
+        }
+    }
+
+    template <typename FUNC>
+    static void forEach( const TRIE_NODE* aNode, FUNC& aFunc )
+    {
+        for( const ENTRY& entry : aNode->m_entries )
+            aFunc( entry.m_key, *entry.m_value );
+
+        for( const std::shared_ptr<TRIE_NODE>& child : aNode->m_children )
+            forEach( child.get(), aFunc );
+    }
+
+    std::shared_ptr<TRIE_NODE> m_root;
+    size_t                     m_size;
+    uint64_t                   m_owner;    ///< tags the trie nodes and values this map may modify
+};
+
+}
+
+#endif    // __PNS_PERSISTENT_MAP_H
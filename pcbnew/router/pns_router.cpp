@@ -81,6 +81,12 @@ ROUTER* ROUTER::GetInstance()
 }
 
 
+void ROUTER::SetInstance( ROUTER* aRouter )
+{
+    theRouter = aRouter;
+}
+
+
 ROUTER::~ROUTER()
 {
     ClearWorld();
@@ -91,6 +97,20 @@ ROUTER::~ROUTER()
 
 void ROUTER::SyncWorld()
 {
+    // Update the world in place when the interface has been tracking the board changes, it is
+    // much cheaper than rebuilding it from the whole board.
+    if( m_world )
+    {
+        m_world->KillChildren();
+        m_placer.reset();
+
+        if( m_iface->UpdateWorld( m_world.get() ) )
+        {
+            m_world->FixupVirtualVias();
+            return;
+        }
+    }
+
     ClearWorld();
 
     m_world = std::make_unique<NODE>( );
@@ -875,6 +895,9 @@ void ROUTER::CommitRouting( NODE* aNode )
 
     m_iface->Commit();
     m_world->Commit( aNode );
+
+    // The committed board items may reuse the addresses of the ones just deleted
+    GetRuleResolver()->ClearCaches();
 }
 
 
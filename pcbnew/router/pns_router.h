@@ -90,6 +90,14 @@ enum DRAG_MODE
     virtual ~ROUTER_IFACE() {};
 
     virtual void SyncWorld( NODE* aNode ) = 0;
+
+    /**
+     * Bring \a aNode, last filled by SyncWorld(), up to date with the board changes made since.
+     *
+     * @return false if the changes cannot be applied in place and a full SyncWorld() is needed.
+     */
+    virtual bool UpdateWorld( NODE* aNode ) { return false; }
+
     virtual void AddItem( ITEM* aItem ) = 0;
     virtual void UpdateItem( ITEM* aItem ) = 0;
     virtual void RemoveItem( ITEM* aItem ) = 0;
@@ -138,6 +146,9 @@ public:
 
     static ROUTER* GetInstance();
 
+    ///< Make \a aRouter the one returned by GetInstance(), e.g. when the tool owning it starts.
+    static void SetInstance( ROUTER* aRouter );
+
     void ClearWorld();
     void SyncWorld();
 
@@ -33,6 +33,7 @@
 #include "pns_shove.h"
 #include "pns_solid.h"
 #include "pns_optimizer.h"
+#include "pns_perf_counters.h"
 #include "pns_via.h"
 #include "pns_utils.h"
 #include "pns_router.h"
@@ -1515,6 +1516,7 @@ SHOVE::SHOVE_STATUS SHOVE::shoveMainLoop()
         st = shoveIteration( m_iter );
 
         m_iter++;
+        PNS_PERF_COUNT( shoveIterations )
 
         if( st == SH_INCOMPLETE || timeLimit.Expired() || m_iter >= iterLimit )
         {
@@ -1915,27 +1917,33 @@ void SHOVE::runOptimizer( NODE* aNode )
 
         PNS_DBG( Dbg(), Message, wxString::Format( wxT( "optimize %d lines, pass %d"), (int)m_optimizerQueue.size(), (int)pass ) );
 
-        for( LINE& line : m_optimizerQueue)
+        std::vector<LINE*> lines;
+        std::vector<LINE*> roots;
+
+        for( LINE& line : m_optimizerQueue )
         {
             if( !( line.Marker() & MK_HEAD ) )
             {
-                LINE optimized;
-                LINE* root = findRootLine( &line );
+                lines.push_back( &line );
+                roots.push_back( findRootLine( &line ) );
+            }
+        }
 
-                if( optimizer.Optimize( &line, &optimized, root ) )
+        optimizer.OptimizeBatch( lines, roots,
+                [&]( size_t aIndex, LINE& aOptimized )
                 {
+                    LINE& line = *lines[aIndex];
+
                     PNS_DBG( Dbg(), AddShape, &line.CLine(), BLUE, 0, wxT( "shove-pre-opt" ) );
 
-                    if( root )
-                        PNS_DBG( Dbg(), AddItem, root, RED, 0, wxT( "shove-root-opt" ) );
+                    if( roots[aIndex] )
+                        PNS_DBG( Dbg(), AddItem, roots[aIndex], RED, 0, wxT( "shove-root-opt" ) );
 
-                    replaceLine( line, optimized, false, aNode );
-                    line = optimized; // keep links in the lines in the queue up to date
+                    replaceLine( line, aOptimized, false, aNode );
+                    line = aOptimized; // keep links in the lines in the queue up to date
 
                     PNS_DBG( Dbg(), AddShape, &line.CLine(), GREEN, 0, wxT( "shove-post-opt" ) );
-                }
-            }
-        }
+                } );
     }
 }
 
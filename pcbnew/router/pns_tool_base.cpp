@@ -60,6 +60,11 @@ TOOL_BASE::TOOL_BASE( const std::string& aToolName ) :
 
 TOOL_BASE::~TOOL_BASE()
 {
+    // Frames clear the tool manager's model before freeing the board, so the board is only
+    // touched here if it is still alive
+    if( m_iface && m_toolMgr && m_toolMgr->GetModel() == m_iface->GetBoard() )
+        m_iface->GetBoard()->RemoveListener( m_iface );
+
     delete m_gridHelper;
     delete m_iface;
     delete m_router;
@@ -68,18 +73,47 @@ TOOL_BASE::~TOOL_BASE()
 
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
+    if( aReason != RUN )
+    {
+        if( !m_router )
+            return;
+
+        // The board may have been replaced or its rules changed: rebuild the world from scratch
+        // the next time it is synced.  A replaced board has already been freed, together with
+        // its items and its listener list, so only the new one is touched here.
+        if( m_iface->GetBoard() != board() )
+            m_iface->ForgetHiddenItems();
+
+        m_iface->SetBoard( board() );
+
+        // Routing can't go on in a world which is about to be cleared
+        m_router->StopRouting();
+        m_router->ClearWorld();
+
+        m_iface->SetView( getView() );
+        board()->AddListener( m_iface );
+
+        return;
+    }
+
     delete m_gridHelper;
-    delete m_iface;
-    delete m_router;
 
-    m_iface = new PNS_KICAD_IFACE;
-    m_iface->SetBoard( board() );
-    m_iface->SetView( getView() );
-    m_iface->SetHostTool( this );
+    // The router and its world are kept between invocations of the tool; the interface listens
+    // to the board so that SyncWorld() only has to update the items changed in the meantime.
+    if( !m_router )
+    {
+        m_iface = new PNS_KICAD_IFACE;
+        m_iface->SetBoard( board() );
+        m_iface->SetView( getView() );
+        m_iface->SetHostTool( this );
+        board()->AddListener( m_iface );
+
+        m_router = new ROUTER;
+        m_router->SetInterface( m_iface );
+    }
 
-    m_router = new ROUTER;
-    m_router->SetInterface( m_iface );
-    m_router->ClearWorld();
+    // The router tool and the length tuner each have their own router
+    ROUTER::SetInstance( m_router );
     m_router->SyncWorld();
 
     m_router->UpdateSizes( m_savedSizes );
@@ -19,9 +19,13 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <future>
+#include <memory>
 #include <optional>
 
 #include <geometry/shape_line_chain.h>
+#include <thread_pool.h>
 
 #include "pns_walkaround.h"
 #include "pns_optimizer.h"
@@ -81,7 +85,8 @@ void WALKAROUND::RestrictToSet( bool aEnabled, const std::set<ITEM*>& aSet )
 }
 
 
-WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath, bool aWindingDirection )
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath, bool aWindingDirection,
+                                                     int aIteration )
 {
     std::optional<OBSTACLE>& current_obs =
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
@@ -99,9 +104,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath, bool aWinding
     bool s_cw = aPath.Walkaround( hull, path_walk, aWindingDirection );
 
     PNS_DBG( Dbg(), BeginGroup, "hull/walk", 1 );
-    PNS_DBG( Dbg(), AddShape, &hull, RED, 0, wxString::Format( "hull-%s-%d-cl %d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), m_iteration, current_obs->m_clearance ) );
-    PNS_DBG( Dbg(), AddShape, &aPath.CLine(), GREEN, 0, wxString::Format( "path-%s-%d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), m_iteration ) );
-    PNS_DBG( Dbg(), AddShape, &path_walk, BLUE, 0, wxString::Format( "result-%s-%d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), m_iteration ) );
+    PNS_DBG( Dbg(), AddShape, &hull, RED, 0, wxString::Format( "hull-%s-%d-cl %d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), aIteration, current_obs->m_clearance ) );
+    PNS_DBG( Dbg(), AddShape, &aPath.CLine(), GREEN, 0, wxString::Format( "path-%s-%d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), aIteration ) );
+    PNS_DBG( Dbg(), AddShape, &path_walk, BLUE, 0, wxString::Format( "result-%s-%d", aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ), aIteration ) );
     PNS_DBG( Dbg(), Message, wxString::Format( wxT( "Stat cw %d" ), !!s_cw ) );
     PNS_DBGN( Dbg(), EndGroup );
 
@@ -121,11 +126,35 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath, bool aWinding
 }
 
 
+WALKAROUND::WALKAROUND_STATUS WALKAROUND::walkDirection( LINE& aPath, bool aWindingDirection,
+                                                        long long aLengthLimit )
+{
+    WALKAROUND_STATUS st = IN_PROGRESS;
+
+    for( int iteration = 0; iteration < m_iterationLimit; iteration++ )
+    {
+        st = singleStep( aPath, aWindingDirection, iteration );
+
+        if( st != IN_PROGRESS )
+            break;
+
+        PNS_DBG( Dbg(), Message, wxString::Format( wxT( "l%s %lld (limit %lld)" ),
+                                                   aWindingDirection ? wxT( "cw" ) : wxT( "ccw" ),
+                                                   aPath.CLine().Length(), aLengthLimit ) );
+
+        // Safety valve
+        if( m_lengthLimitOn && aPath.CLine().Length() > aLengthLimit )
+            break;
+    }
+
+    return st;
+}
+
+
 const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 {
     LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
     WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
-    SHAPE_LINE_CHAIN best_path;
     RESULT result;
 
     // special case for via-in-the-middle-of-track placement
@@ -142,9 +171,6 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
 
-    result.lineCw = aInitialPath;
-    result.lineCcw = aInitialPath;
-
     if( m_forceWinding )
     {
         s_cw = m_forceCw ? IN_PROGRESS : STUCK;
@@ -158,54 +184,49 @@ const WALKAROUND::RESULT WALKAROUND::Route( const LINE& aInitialPath )
     const int maxWalkDistFactor = 10;
     long long lengthLimit       = aInitialPath.CLine().Length() * maxWalkDistFactor;
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK && s_cw != ALMOST_DONE )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK && s_ccw != ALMOST_DONE )
-            s_ccw = singleStep( path_ccw, false );
-
-        if( s_cw != IN_PROGRESS )
-        {
-            result.lineCw = path_cw;
-            result.statusCw = s_cw;
-        }
-
-        if( s_ccw != IN_PROGRESS )
-        {
-            result.lineCcw = path_ccw;
-            result.statusCcw = s_ccw;
-        }
-
-        if( s_cw != IN_PROGRESS && s_ccw != IN_PROGRESS )
-            break;
-
-        double lcw = path_cw.Line().Length() / (double)aInitialPath.CLine().Length();
-        double lccw = path_ccw.Line().Length() / (double)aInitialPath.CLine().Length();
-
-        PNS_DBG( Dbg(), Message, wxString::Format( wxT( "lcw %.1f lccw %.1f" ), lcw, lccw ) );
-
-
-        // Safety valve
-        if( m_lengthLimitOn && path_cw.Line().Length() > lengthLimit && path_ccw.Line().Length() > lengthLimit )
-            break;
-
-        m_iteration++;
-    }
+    // The two directions only read the world, so offer the counter-clockwise one to the thread
+    // pool while this thread takes the clockwise one.  Whoever gets to it first walks it: this
+    // thread never waits for a task which hasn't started, so there is no deadlock when called
+    // from a pool thread itself.  The debug decorator isn't thread-safe, so stay on this thread
+    // while it is recording.
+    bool concurrent = s_cw == IN_PROGRESS && s_ccw == IN_PROGRESS
+                      && !( Dbg() && Dbg()->IsDebugEnabled() );
 
-    if( s_cw == IN_PROGRESS )
+    if( concurrent )
     {
-        result.lineCw = path_cw;
-        result.statusCw = ALMOST_DONE;
+        thread_pool&                       tp = GetKiCadThreadPool();
+        std::shared_ptr<std::atomic<bool>> claimed = std::make_shared<std::atomic<bool>>( false );
+
+        // The task may only run after this function has returned, when it has been claimed
+        // here: it must not touch anything but the flag then
+        std::future<void> ccw = tp.submit(
+                [this, claimed, &path_ccw, &s_ccw, lengthLimit]()
+                {
+                    if( !claimed->exchange( true ) )
+                        s_ccw = walkDirection( path_ccw, false, lengthLimit );
+                } );
+
+        s_cw = walkDirection( path_cw, true, lengthLimit );
+
+        if( !claimed->exchange( true ) )
+            s_ccw = walkDirection( path_ccw, false, lengthLimit );
+        else
+            ccw.wait();
     }
-
-    if( s_ccw == IN_PROGRESS )
+    else
     {
-        result.lineCcw = path_ccw;
-        result.statusCcw = ALMOST_DONE;
+        if( s_cw == IN_PROGRESS )
+            s_cw = walkDirection( path_cw, true, lengthLimit );
+
+        if( s_ccw == IN_PROGRESS )
+            s_ccw = walkDirection( path_ccw, false, lengthLimit );
     }
 
+    result.lineCw = path_cw;
+    result.statusCw = s_cw == IN_PROGRESS ? ALMOST_DONE : s_cw;
+    result.lineCcw = path_ccw;
+    result.statusCcw = s_ccw == IN_PROGRESS ? ALMOST_DONE : s_ccw;
+
     if( result.lineCw.SegmentCount() < 1 || result.lineCw.CPoint( 0 ) != aInitialPath.CPoint( 0 ) )
     {
         result.statusCw = STUCK;
@@ -273,10 +294,10 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath, LINE&
             s_ccw = STUCK; // ccw path is empty, can't continue
 
         if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+            s_cw = singleStep( path_cw, true, m_iteration );
 
         if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+            s_ccw = singleStep( path_ccw, false, m_iteration );
 
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
@@ -120,7 +120,14 @@ public:
 private:
     void start( const LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection, int aIteration );
+
+    /**
+     * Walk \a aPath around the obstacles in a single winding direction until it is done, stuck
+     * or over one of the limits (in which case IN_PROGRESS is returned).  Only reads the world
+     * and the obstacle slot of its own direction, so both directions may be walked concurrently.
+     */
+    WALKAROUND_STATUS walkDirection( LINE& aPath, bool aWindingDirection, long long aLengthLimit );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
     NODE* m_world;
@@ -25,6 +25,8 @@
 
 #include <functional>
 #include <iomanip>
+#include <map>
+#include <set>
 #include <utility>
 #include <sstream>
 
@@ -45,6 +47,7 @@ using namespace std::placeholders;
 #include <widgets/appearance_controls.h>
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
+#include <dialogs/html_message_box.h>
 #include <confirm.h>
 #include <bitmaps.h>
 #include <string_utils.h>
@@ -57,13 +60,16 @@ using namespace std::placeholders;
 #include <tools/pcb_grid_helper.h>
 #include <tools/drc_tool.h>
 #include <tools/zone_filler_tool.h>
+#include <widgets/wx_progress_reporters.h>
 #include <drc/drc_interactive_courtyard_clearance.h>
 
+#include <profile.h>
 #include <project.h>
 #include <project/project_file.h>
 
 #include "router_tool.h"
 #include "pns_segment.h"
+#include "pns_batch_router.h"
 #include "pns_router.h"
 #include "pns_itemset.h"
 #include "pns_logger.h"
@@ -538,8 +544,7 @@ void ROUTER_TOOL::Reset( RESET_REASON aReason )
 {
     m_lastTargetLayer = UNDEFINED_LAYER;
 
-    if( aReason == RUN )
-        TOOL_BASE::Reset( aReason );
+    TOOL_BASE::Reset( aReason );
 }
 
 // Saves the complete event log and the dump of the PCB, allowing us to
@@ -1665,6 +1670,161 @@ int ROUTER_TOOL::RouteSelected( const TOOL_EVENT& aEvent )
 }
 
 
+int ROUTER_TOOL::AutorouteUnconnected( const TOOL_EVENT& aEvent )
+{
+    PCB_EDIT_FRAME* frame = getEditFrame<PCB_EDIT_FRAME>();
+
+    if( m_router->RoutingInProgress() )
+        return 0;
+
+    // Restrict the routing to the nets of the selection, if any
+    PCB_SELECTION& selection = m_toolMgr->GetTool<PCB_SELECTION_TOOL>()->GetSelection();
+    std::set<int>  nets;
+
+    for( EDA_ITEM* item : selection )
+    {
+        if( item->Type() == PCB_FOOTPRINT_T )
+        {
+            for( PAD* pad : static_cast<FOOTPRINT*>( item )->Pads() )
+                nets.insert( pad->GetNetCode() );
+        }
+        else if( BOARD_CONNECTED_ITEM* citem = dynamic_cast<BOARD_CONNECTED_ITEM*>( item ) )
+        {
+            nets.insert( citem->GetNetCode() );
+        }
+    }
+
+    std::shared_ptr<CONNECTIVITY_DATA>         connectivity = board()->GetConnectivity();
+    std::vector<PNS::BATCH_ROUTER::CONNECTION> connections;
+
+    connectivity->RunOnUnconnectedEdges(
+            [&]( CN_EDGE& aEdge )
+            {
+                std::shared_ptr<const CN_ANCHOR> source = aEdge.GetSourceNode();
+                std::shared_ptr<const CN_ANCHOR> target = aEdge.GetTargetNode();
+                int                              net = source->Parent()->GetNetCode();
+
+                if( nets.empty() || nets.count( net ) )
+                {
+                    connections.push_back( { source->Parent(), target->Parent(), source->Pos(),
+                                             target->Pos(), net, frame->GetActiveLayer() } );
+                }
+
+                return true;
+            } );
+
+    if( connections.empty() )
+    {
+        frame->ShowInfoBarMsg( _( "No unconnected items to route." ) );
+        return 0;
+    }
+
+    m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+    frame->PushTool( aEvent );
+    Activate();
+
+    PNS::BATCH_ROUTER      batchRouter( m_router );
+    PNS::ROUTING_SETTINGS& settings = m_router->Settings();
+    PNS::PNS_MODE          originalMode = settings.Mode();
+
+    // Connections the parallel pass couldn't route are retried interactively; don't let them
+    // be committed with collisions
+    if( originalMode == PNS::RM_MarkObstacles )
+        settings.SetMode( PNS::RM_Shove );
+
+    // A connection is made once its edge has left the ratsnest of its net
+    batchRouter.SetConnectedCheck(
+            [&]( const PNS::BATCH_ROUTER::CONNECTION& aConnection )
+            {
+                RN_NET* net = connectivity->GetRatsnestForNet( aConnection.net );
+
+                if( !net )
+                    return true;
+
+                for( const CN_EDGE& edge : net->GetEdges() )
+                {
+                    const BOARD_ITEM* source = edge.GetSourceNode()->Parent();
+                    const BOARD_ITEM* target = edge.GetTargetNode()->Parent();
+
+                    if( ( source == aConnection.startParent && target == aConnection.endParent )
+                            || ( source == aConnection.endParent
+                                 && target == aConnection.startParent ) )
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            } );
+
+    // Put everything in one undo step
+    batchRouter.SetCommitCallback(
+            [&]()
+            {
+                m_iface->SetCommitFlags( APPEND_UNDO );
+            } );
+
+    std::vector<PNS::BATCH_ROUTER::RESULT> results;
+    PROF_TIMER                             timer;
+
+    {
+        WX_PROGRESS_REPORTER reporter( frame, _( "Autoroute Unconnected Items" ), 2 );
+
+        batchRouter.SetProgressReporter( &reporter );
+        results = batchRouter.Route( connections );
+        batchRouter.SetProgressReporter( nullptr );
+    }
+
+    timer.Stop();
+
+    settings.SetMode( originalMode );
+    m_iface->SetCommitFlags( 0 );
+
+    // Report the success rate and the time spent on each net
+    std::map<int, std::pair<int, int>> netCounts;
+    std::map<int, double>              netTimes;
+    int                                routed = 0;
+
+    for( const PNS::BATCH_ROUTER::RESULT& result : results )
+    {
+        std::pair<int, int>& counts = netCounts[result.net];
+
+        if( result.status != PNS::BATCH_ROUTER::FAILED )
+        {
+            counts.first++;
+            routed++;
+        }
+
+        counts.second++;
+        netTimes[result.net] += result.timeMs;
+    }
+
+    HTML_MESSAGE_BOX dlg( frame, _( "Autoroute Unconnected Items" ) );
+    wxArrayString    lines;
+
+    dlg.MessageSet( wxString::Format( _( "Routed %d of %d connections (%.0f%%) in %.1f s." ),
+                                      routed, (int) results.size(),
+                                      100.0 * routed / results.size(), timer.msecs() / 1000.0 ) );
+
+    for( const auto& [ net, counts ] : netCounts )
+    {
+        NETINFO_ITEM* netinfo = board()->FindNet( net );
+
+        lines.Add( wxString::Format( _( "%s: %d of %d routed, %.1f ms" ),
+                                     netinfo ? UnescapeString( netinfo->GetNetname() )
+                                             : wxString( wxT( "?" ) ),
+                                     counts.first, counts.second, netTimes[net] ) );
+    }
+
+    dlg.ListSet( lines );
+    dlg.ShowModal();
+
+    frame->PopTool( aEvent );
+    return 0;
+}
+
+
 int ROUTER_TOOL::MainLoop( const TOOL_EVENT& aEvent )
 {
     if( m_inRouterTool )
@@ -2591,6 +2751,7 @@ void ROUTER_TOOL::setTransitions()
     Go( &ROUTER_TOOL::RouteSelected,          PCB_ACTIONS::routerRouteSelected.MakeEvent() );
     Go( &ROUTER_TOOL::RouteSelected,          PCB_ACTIONS::routerRouteSelectedFromEnd.MakeEvent() );
     Go( &ROUTER_TOOL::RouteSelected,          PCB_ACTIONS::routerAutorouteSelected.MakeEvent() );
+    Go( &ROUTER_TOOL::AutorouteUnconnected,   PCB_ACTIONS::routerAutorouteUnconnected.MakeEvent() );
     Go( &ROUTER_TOOL::DpDimensionsDialog,     PCB_ACTIONS::routerDiffPairDialog.MakeEvent() );
     Go( &ROUTER_TOOL::SettingsDialog,         PCB_ACTIONS::routerSettingsDialog.MakeEvent() );
     Go( &ROUTER_TOOL::ChangeRouterMode,       PCB_ACTIONS::routerHighlightMode.MakeEvent() );
@@ -1534,6 +1534,13 @@ TOOL_ACTION PCB_ACTIONS::routerAutorouteSelected( "pcbnew.InteractiveRouter.Auto
         _( "Sequentially attempt to automatically route all selected pads." ),
         BITMAPS::INVALID_BITMAP, AF_ACTIVATE, (void *) PNS::PNS_MODE_ROUTE_SINGLE);
 
+TOOL_ACTION PCB_ACTIONS::routerAutorouteUnconnected( "pcbnew.InteractiveRouter.AutorouteUnconnected",
+        AS_GLOBAL, 0, "",
+        _( "Autoroute Unconnected Items" ),
+        _( "Route the unconnected items of the selected nets, or of the whole board if nothing "
+           "is selected, and report the result." ),
+        BITMAPS::INVALID_BITMAP, AF_ACTIVATE );
+
 TOOL_ACTION PCB_ACTIONS::breakTrack( "pcbnew.InteractiveRouter.BreakTrack",
         AS_GLOBAL, 0, "",
         _( "Break Track" ),
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2022 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Microbenchmark of the stroke font text paths over the bundled newstroke font.
+ *
+ * Compares laying out text glyph by glyph, drawing it segment by segment through a callback GAL
+ * (as the plotters used to) and converting it in one batch with
+ * STROKE_FONT::GetLinesAsPolylines().
+ */
+
+#include <wx/string.h>
+
+#include <callback_gal.h>
+#include <font/stroke_font.h>
+#include <font/text_attributes.h>
+#include <gal/gal_display_options.h>
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <iostream>
+
+
+/**
+ * Build a set of multi-line strings covering the printable ASCII range and the Latin, Greek
+ * and Cyrillic blocks of newstroke, in a mix of sizes and rotations.
+ */
+static std::vector<wxString> buildSamples( int aCount )
+{
+    std::vector<wxString> samples;
+    wxString              charset;
+
+    for( wxUniChar c = ' ' + 1; c <= '~'; c = c + 1 )
+        charset += c;
+
+    for( int c = 0x00C0; c < 0x0500; c += 7 )
+        charset += wxUniChar( c );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        size_t   start = ( ii * 13 ) % charset.length();
+        wxString text = charset.Mid( start, 16 );
+
+        // Reference designator style labels, with the occasional second line and markup
+        if( ii % 5 == 0 )
+            text += wxT( "\nR" ) + wxString::Format( wxT( "%d" ), ii );
+
+        if( ii % 7 == 0 )
+            text = wxT( "~{" ) + text + wxT( "}" );
+
+        samples.push_back( text );
+    }
+
+    return samples;
+}
+
+
+static TEXT_ATTRIBUTES sampleAttributes( int aIndex )
+{
+    TEXT_ATTRIBUTES attrs;
+
+    attrs.m_Size = VECTOR2I( 1000000 + ( aIndex % 4 ) * 250000, 1000000 );
+    attrs.m_StrokeWidth = 150000;
+    attrs.m_Angle = ( aIndex % 2 ) ? ANGLE_90 : ANGLE_0;
+    attrs.m_Italic = ( aIndex % 3 ) == 0;
+
+    return attrs;
+}
+
+
+int stroke_font_benchmark_func( int argc, char* argv[] )
+{
+    long count = 50000;
+
+    if( argc > 1 && !wxString( argv[1] ).ToLong( &count ) )
+    {
+        std::cerr << "Usage: " << argv[0] << " [TEXT_COUNT]\n";
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const KIFONT::STROKE_FONT* font = static_cast<KIFONT::STROKE_FONT*>( KIFONT::FONT::GetFont() );
+    std::vector<wxString>      samples = buildSamples( count );
+
+    // Glyph by glyph, as the GAL painters receive the text
+    PROF_TIMER glyphTimer;
+    size_t     glyphCount = 0;
+
+    for( size_t ii = 0; ii < samples.size(); ++ii )
+    {
+        TEXT_ATTRIBUTES attrs = sampleAttributes( ii );
+        std::vector<std::unique_ptr<KIFONT::GLYPH>> glyphs;
+
+        font->GetTextAsGlyphs( nullptr, &glyphs, samples[ii], attrs.m_Size, VECTOR2I( 0, 0 ),
+                               attrs.m_Angle, false, VECTOR2I( 0, 0 ), 0 );
+        glyphCount += glyphs.size();
+    }
+
+    glyphTimer.Stop();
+
+    // Segment by segment through a callback GAL
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    size_t                     segmentCount = 0;
+
+    CALLBACK_GAL callbackGal( options,
+            [&]( const VECTOR2I& aPt1, const VECTOR2I& aPt2 )
+            {
+                segmentCount++;
+            },
+            [&]( const SHAPE_LINE_CHAIN& aPoly )
+            {
+            } );
+
+    PROF_TIMER segmentTimer;
+
+    for( size_t ii = 0; ii < samples.size(); ++ii )
+        font->Draw( &callbackGal, samples[ii], VECTOR2I( 0, 0 ), sampleAttributes( ii ) );
+
+    segmentTimer.Stop();
+
+    // One batch for all the texts, as for a whole layer
+    std::vector<std::vector<VECTOR2D>> polylines;
+    size_t                             batchedSegments = 0;
+    PROF_TIMER                         batchTimer;
+
+    for( size_t ii = 0; ii < samples.size(); ++ii )
+    {
+        font->GetLinesAsPolylines( &polylines, samples[ii], VECTOR2I( 0, 0 ),
+                                   sampleAttributes( ii ) );
+    }
+
+    for( const std::vector<VECTOR2D>& polyline : polylines )
+        batchedSegments += polyline.size() - 1;
+
+    batchTimer.Stop();
+
+    std::cout << "Texts:              " << samples.size() << "\n";
+    std::cout << "Glyph by glyph:     " << glyphTimer.msecs() << " ms, " << glyphCount
+              << " glyphs\n";
+    std::cout << "Segment callbacks:  " << segmentTimer.msecs() << " ms, " << segmentCount
+              << " segments\n";
+    std::cout << "Batched polylines:  " << batchTimer.msecs() << " ms, " << polylines.size()
+              << " polylines, " << batchedSegments << " segments\n";
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "stroke_font_benchmark",
+        "Benchmark batched stroke font text conversion",
+        stroke_font_benchmark_func,
+} );
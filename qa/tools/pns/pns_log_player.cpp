@@ -27,11 +27,16 @@
 
 #include <pcbnew_utils/board_test_utils.h>
 
+#include <profile.h>
+
 #define PNSLOGINFO PNS::DEBUG_DECORATOR::SRC_LOCATION_INFO( __FILE__, __FUNCTION__, __LINE__ )
 
 using namespace PNS;
 
-PNS_LOG_PLAYER::PNS_LOG_PLAYER()
+PNS_LOG_PLAYER::PNS_LOG_PLAYER() :
+        m_debugDecorator( nullptr ),
+        m_timeLimitUs( 0 ),
+        m_debugEnabled( true )
 {
     SetReporter( &NULL_REPORTER::GetInstance() );
 }
@@ -58,8 +63,11 @@ void PNS_LOG_PLAYER::createRouter()
 
     //m_router->Settings().SetOptimizeDraggedTrack( true );
 
+    delete m_debugDecorator;
+
     m_debugDecorator = new PNS_TEST_DEBUG_DECORATOR;
     m_debugDecorator->Clear();
+    m_debugDecorator->SetDebugEnabled( m_debugEnabled );
     m_iface->SetDebugDecorator( m_debugDecorator );
 }
 
@@ -97,6 +105,8 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
     int eventIdx = 0;
     int totalEvents = aLog->Events().size();
 
+    m_eventTimings.clear();
+
     for( auto evt : aLog->Events() )
     {
         if( eventIdx < aFrom || ( aTo >= 0 && eventIdx > aTo ) )
@@ -107,6 +117,8 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
 
         eventIdx++;
 
+        PROF_TIMER timer( "", false );
+
         switch( evt.type )
         {
         case LOGGER::EVT_START_ROUTE:
@@ -119,7 +131,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             m_router->StartRouting( evt.p, ritem, ritem ? ritem->Layers().Start() : F_Cu );
+            timer.Stop();
             break;
         }
 
@@ -133,7 +147,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool rv = m_router->StartDragging( evt.p, ritem, 0 );
+            timer.Stop();
             break;
         }
 
@@ -142,7 +158,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->NewStage( "fix", 0, PNSLOGINFO );
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "fix (%d, %d)", evt.p.x, evt.p.y ) );
+            timer.Start();
             bool rv = m_router->FixRoute( evt.p, ritem );
+            timer.Stop();
             printf( "  fix -> (%d, %d) ret %d\n", evt.p.x, evt.p.y, rv ? 1 : 0 );
             break;
         }
@@ -153,7 +171,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
             m_debugDecorator->Message( wxString::Format( "unfix (%d, %d)", evt.p.x, evt.p.y ) );
             printf( "  unfix\n" );
+            timer.Start();
             m_router->UndoLastSegment();
+            timer.Stop();
             break;
         }
 
@@ -167,7 +187,9 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_debugDecorator->Message( msg );
             m_reporter->Report( msg );
 
+            timer.Start();
             bool ret = m_router->Move( evt.p, ritem );
+            timer.Stop();
             m_debugDecorator->SetCurrentStageStatus( ret );
             break;
         }
@@ -182,13 +204,17 @@ void PNS_LOG_PLAYER::ReplayLog( PNS_LOG_FILE* aLog, int aStartEventIndex, int aF
             m_reporter->Report( msg );
 
             m_viewTracker->SetStage( m_debugDecorator->GetStageCount() - 1 );
+            timer.Start();
             m_router->ToggleViaPlacement();
+            timer.Stop();
             break;
         }
 
-        default: break;
+        default: continue;
         }
 
+        m_eventTimings[evt.type].push_back( timer.msecs() );
+
         PNS::NODE* node = nullptr;
 
 #if 0
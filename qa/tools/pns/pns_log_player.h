@@ -24,6 +24,7 @@
 #define __PNS_LOG_PLAYER_H
 
 #include <map>
+#include <vector>
 #include <pcbnew/board.h>
 
 #include <router/pns_routing_settings.h>
@@ -79,6 +80,9 @@ private:
 class PNS_LOG_PLAYER
 {
 public:
+    ///< Time (in milliseconds) the router spent on each replayed event, grouped by event type
+    typedef std::map<PNS::LOGGER::EVENT_TYPE, std::vector<double>> EVENT_TIMINGS;
+
     PNS_LOG_PLAYER();
     ~PNS_LOG_PLAYER();
 
@@ -91,6 +95,14 @@ public:
 
     void SetTimeLimit( uint64_t microseconds ) { m_timeLimitUs = microseconds; }
 
+    /**
+     * Enable or disable the router's debug output (on by default).  Disabling it keeps the
+     * replay close to interactive routing, e.g. for benchmarking.
+     */
+    void SetDebugEnabled( bool aEnabled ) { m_debugEnabled = aEnabled; }
+
+    const EVENT_TIMINGS& GetEventTimings() const { return m_eventTimings; }
+
     bool CompareResults( PNS_LOG_FILE* aLog );
     const PNS_LOG_FILE::COMMIT_STATE GetRouterUpdatedItems();
 
@@ -104,6 +116,8 @@ private:
     std::unique_ptr<PNS::ROUTER>          m_router;
     uint64_t m_timeLimitUs;
     REPORTER* m_reporter;
+    bool      m_debugEnabled;
+    EVENT_TIMINGS m_eventTimings;
 };
 
 #endif
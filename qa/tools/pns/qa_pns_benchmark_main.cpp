@@ -0,0 +1,263 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Headless P&S router benchmark: replays every PNS_LOGGER session found in a directory (each
+ * session is a subdirectory holding a "pns" log and its board) and reports the router latency
+ * percentiles per event type, together with the number of collision queries, node branches and
+ * shove iterations the replay took.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <wx/cmdline.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <qa_utils/utility_registry.h>
+#include <pcbnew_utils/board_test_utils.h>
+
+#include <router/pns_perf_counters.h>
+
+#include "pns_log_file.h"
+#include "pns_log_player.h"
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            "replay each session this many times (default 1)",
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "d",
+            "debug",
+            "keep the router debug output enabled while replaying",
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            "directory",
+            "directory",
+            "directory containing the recorded sessions",
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_OPTION_MANDATORY,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+struct BENCHMARK_STATS
+{
+    BENCHMARK_STATS() :
+            collisionQueries( 0 ),
+            nodeBranches( 0 ),
+            shoveIterations( 0 )
+    {}
+
+    void Add( const BENCHMARK_STATS& aOther )
+    {
+        for( const auto& [type, times] : aOther.timings )
+            timings[type].insert( timings[type].end(), times.begin(), times.end() );
+
+        collisionQueries += aOther.collisionQueries;
+        nodeBranches += aOther.nodeBranches;
+        shoveIterations += aOther.shoveIterations;
+    }
+
+    PNS_LOG_PLAYER::EVENT_TIMINGS timings;
+    unsigned long long            collisionQueries;
+    unsigned long long            nodeBranches;
+    unsigned long long            shoveIterations;
+};
+
+
+static const char* eventName( PNS::LOGGER::EVENT_TYPE aType )
+{
+    switch( aType )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE: return "route-start";
+    case PNS::LOGGER::EVT_START_DRAG:  return "drag-start";
+    case PNS::LOGGER::EVT_FIX:         return "fix";
+    case PNS::LOGGER::EVT_MOVE:        return "move";
+    case PNS::LOGGER::EVT_ABORT:       return "abort";
+    case PNS::LOGGER::EVT_TOGGLE_VIA:  return "toggle-via";
+    case PNS::LOGGER::EVT_UNFIX:       return "unfix";
+    default:                           return "unknown";
+    }
+}
+
+
+/**
+ * Nearest-rank percentile of a sorted sample.
+ */
+static double percentile( const std::vector<double>& aSorted, double aPercent )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    size_t rank = (size_t) std::ceil( aPercent / 100.0 * aSorted.size() );
+
+    return aSorted[std::clamp<size_t>( rank, 1, aSorted.size() ) - 1];
+}
+
+
+static void printStats( const wxString& aTitle, const BENCHMARK_STATS& aStats )
+{
+    printf( "%s\n", aTitle.c_str().AsChar() );
+    printf( "  %-12s %8s %10s %10s %10s %10s\n", "event", "count", "p50 [ms]", "p95 [ms]",
+            "p99 [ms]", "max [ms]" );
+
+    for( auto [type, times] : aStats.timings )
+    {
+        std::sort( times.begin(), times.end() );
+
+        printf( "  %-12s %8d %10.3f %10.3f %10.3f %10.3f\n", eventName( type ),
+                (int) times.size(), percentile( times, 50 ), percentile( times, 95 ),
+                percentile( times, 99 ), times.empty() ? 0.0 : times.back() );
+    }
+
+    printf( "  collision queries: %llu, node branches: %llu, shove iterations: %llu\n\n",
+            aStats.collisionQueries, aStats.nodeBranches, aStats.shoveIterations );
+}
+
+
+static std::vector<wxString> findSessions( const wxString& aPath )
+{
+    std::vector<wxString> sessions;
+    wxDir                 dir( aPath );
+    wxString              name;
+
+    if( !dir.IsOpened() )
+        return sessions;
+
+    for( bool cont = dir.GetFirst( &name, wxEmptyString, wxDIR_DIRS ); cont;
+         cont = dir.GetNext( &name ) )
+    {
+        wxFileName fn( aPath, wxT( "pns" ) );
+        fn.AppendDir( name );
+
+        if( fn.FileExists() )
+            sessions.push_back( name );
+    }
+
+    std::sort( sessions.begin(), sessions.end() );
+
+    return sessions;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "P&S router benchmark. Replays the PNS_LOGGER sessions found in the "
+                            "subdirectories of the given directory without a GUI and reports "
+                            "the per-event router latency." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    bool     debug = cl_parser.Found( "debug" );
+    wxString path = cl_parser.GetParam( 0 );
+
+    std::vector<wxString> sessions = findSessions( path );
+
+    if( sessions.empty() )
+    {
+        printf( "No PNS sessions found in '%s'.\n", path.c_str().AsChar() );
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    KI_TEST::CONSOLE_LOG          log;
+    KI_TEST::CONSOLE_MSG_REPORTER reporter( &log );
+    BENCHMARK_STATS               total;
+    int                           failed = 0;
+
+    PNS::PERF_COUNTERS::Enable( true );
+
+    for( const wxString& session : sessions )
+    {
+        wxFileName fn( path, wxT( "pns" ) );
+        fn.AppendDir( session );
+
+        PNS_LOG_FILE logFile;
+
+        if( !logFile.Load( fn, &reporter ) )
+        {
+            reporter.Report( wxString::Format( "Failed to load session '%s' from '%s'", session,
+                                               fn.GetFullPath() ),
+                             RPT_SEVERITY_ERROR );
+            failed++;
+            continue;
+        }
+
+        BENCHMARK_STATS stats;
+
+        for( long i = 0; i < repeat; i++ )
+        {
+            PNS_LOG_PLAYER player;
+            player.SetDebugEnabled( debug );
+
+            PNS::PERF_COUNTERS& counters = PNS::PERF_COUNTERS::Get();
+            counters.Reset();
+
+            player.ReplayLog( &logFile, 0 );
+
+            BENCHMARK_STATS run;
+            run.timings = player.GetEventTimings();
+            run.collisionQueries = counters.collisionQueries.Count();
+            run.nodeBranches = counters.nodeBranches.Count();
+            run.shoveIterations = counters.shoveIterations.Count();
+
+            stats.Add( run );
+        }
+
+        printStats( wxString::Format( "Session '%s' (%ld runs):", session, repeat ), stats );
+        total.Add( stats );
+    }
+
+    printStats( wxString::Format( "Total (%d sessions):", (int) sessions.size() - failed ),
+                total );
+
+    return failed ? KI_TEST::RET_CODES::TOOL_SPECIFIC : KI_TEST::RET_CODES::OK;
+}
@@ -0,0 +1,378 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2022 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Headless render benchmark for the GAL painters.
+ *
+ * Loads a board, adds it to a view backed by an offscreen Cairo image surface and renders it at
+ * a series of zoom levels.  For every visible layer it reports the time spent in the painter,
+ * the time spent rasterizing the recorded groups, the number of items drawn and the number of
+ * path vertices the painter emitted.
+ */
+
+#include <wx/app.h>
+#include <wx/cmdline.h>
+
+#include <qa_utils/utility_registry.h>
+#include <qa_utils/utility_program.h>
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board.h>
+#include <footprint.h>
+#include <pcb_marker.h>
+#include <pcb_track.h>
+#include <zone.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+#include <pcbnew_settings.h>
+#include <pgm_base.h>
+#include <profile.h>
+#include <layer_ids.h>
+#include <settings/settings_manager.h>
+#include <gal/cairo/cairo_gal.h>
+#include <gal/gal_display_options.h>
+
+#include <functional>
+#include <map>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+
+/**
+ * A Cairo GAL drawing into a plain image surface, with no window or compositor behind it.
+ */
+class OFFSCREEN_CAIRO_GAL : public KIGFX::CAIRO_GAL_BASE
+{
+public:
+    OFFSCREEN_CAIRO_GAL( KIGFX::GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight ) :
+            CAIRO_GAL_BASE( aDisplayOptions )
+    {
+        m_screenSize = VECTOR2I( aWidth, aHeight );
+        m_surface = cairo_image_surface_create( GAL_FORMAT, aWidth, aHeight );
+        m_context = m_currentContext = cairo_create( m_surface );
+        resetContext();
+    }
+
+    /**
+     * Return the number of path vertices recorded in a group, including the groups it calls.
+     */
+    size_t GetGroupVertexCount( int aGroupNumber ) const
+    {
+        auto it = m_groups.find( aGroupNumber );
+
+        if( it == m_groups.end() )
+            return 0;
+
+        size_t count = 0;
+
+        for( const GROUP_ELEMENT& element : it->second )
+        {
+            if( element.m_Command == CMD_CALL_GROUP )
+            {
+                count += GetGroupVertexCount( element.m_Argument.IntArg );
+            }
+            else if( element.m_CairoPath )
+            {
+                const cairo_path_t* path = element.m_CairoPath;
+
+                // Each path element is a header followed by its points
+                for( int i = 0; i < path->num_data; i += path->data[i].header.length )
+                    count += path->data[i].header.length - 1;
+            }
+        }
+
+        return count;
+    }
+};
+
+
+/// Per-layer figures for a single zoom level
+struct LAYER_STATS
+{
+    int    m_layer = 0;
+    size_t m_items = 0;
+    size_t m_vertices = 0;
+    double m_paintMs = 0.0;
+    double m_rasterMs = 0.0;
+};
+
+
+static long peakMemoryKiB()
+{
+#ifndef _WIN32
+    struct rusage usage;
+
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 )
+    {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;   // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+
+    return -1;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            "displays help on the command line parameters",
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "zoom-steps",
+            "number of zoom levels to render, each twice the previous one (default 6)",
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "W",
+            "width",
+            "width of the offscreen surface in pixels (default 1920)",
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "H",
+            "height",
+            "height of the offscreen surface in pixels (default 1080)",
+            wxCMD_LINE_VAL_NUMBER,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            "filename",
+            "filename",
+            "board file to render",
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_OPTION_MANDATORY,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RENDER_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int render_benchmark_main_func( int argc, char** argv )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( "Renders a board offscreen with the Cairo GAL at several zoom levels "
+                            "and reports per-layer painter statistics." );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long zoomSteps = 6;
+    long width = 1920;
+    long height = 1080;
+
+    cl_parser.Found( "zoom-steps", &zoomSteps );
+    cl_parser.Found( "width", &width );
+    cl_parser.Found( "height", &height );
+
+    if( zoomSteps < 1 || width < 1 || height < 1 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    PROF_TIMER loadTimer;
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RENDER_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    board->CacheTriangulation();
+    loadTimer.Stop();
+
+    SETTINGS_MANAGER& mgr = Pgm().GetSettingsManager();
+    mgr.RegisterSettings( new PCBNEW_SETTINGS, false );
+
+    KIGFX::GAL_DISPLAY_OPTIONS displayOptions;
+    OFFSCREEN_CAIRO_GAL        gal( displayOptions, width, height );
+    KIGFX::PCB_PAINTER         painter( &gal, FRAME_PCB_EDITOR );
+    KIGFX::PCB_VIEW            view;
+
+    painter.GetSettings()->LoadColors( mgr.GetColorSettings() );
+
+    view.SetGAL( &gal );
+    view.SetPainter( &painter );
+
+    // Same item set as PCB_DRAW_PANEL_GAL::DisplayBoard(), minus the ratsnest
+    for( BOARD_ITEM* drawing : board->Drawings() )
+        view.Add( drawing );
+
+    for( PCB_TRACK* track : board->Tracks() )
+        view.Add( track );
+
+    for( FOOTPRINT* footprint : board->Footprints() )
+        view.Add( footprint );
+
+    for( PCB_MARKER* marker : board->Markers() )
+        view.Add( marker );
+
+    for( ZONE* zone : board->Zones() )
+        view.Add( zone );
+
+    BOX2I bbox = board->GetBoundingBox();
+
+    view.SetViewport( BOX2D( bbox.GetOrigin(), bbox.GetSize() ) );
+
+    double   baseScale = view.GetScale();
+    VECTOR2D center = bbox.Centre();
+
+    printf( "Board: %s (loaded in %.1f ms)\n", filename.c_str(), loadTimer.msecs() );
+    printf( "Surface: %ldx%ld, %ld zoom levels\n", width, height, zoomSteps );
+
+    for( long step = 0; step < zoomSteps; step++ )
+    {
+        view.SetScale( baseScale * ( 1 << step ) );
+        view.SetCenter( center );
+
+        KIGFX::GAL_DRAWING_CONTEXT ctx( &gal );
+
+        BOX2D viewport = view.GetViewport();
+        BOX2I rect( VECTOR2I( viewport.GetOrigin() ), VECTOR2I( viewport.GetSize() ) );
+
+        std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> pairs;
+        view.Query( rect, pairs );
+
+        // Same order as VIEW::redrawRect(): highest rendering order first
+        std::map<int, LAYER_STATS, std::greater<int>>       stats;
+        std::map<int, std::vector<KIGFX::VIEW_ITEM*>>       itemsByLayer;
+
+        for( const KIGFX::VIEW::LAYER_ITEM_PAIR& pair : pairs )
+        {
+            if( view.IsLayerVisible( pair.second ) && view.IsVisible( pair.first ) )
+                itemsByLayer[pair.second].push_back( pair.first );
+        }
+
+        for( const auto& [ layer, items ] : itemsByLayer )
+        {
+            LAYER_STATS& layerStats = stats[view.GetLayerOrder( layer )];
+            layerStats.m_layer = layer;
+
+            gal.SetLayerDepth( view.GetLayerOrder( layer ) );
+
+            for( KIGFX::VIEW_ITEM* item : items )
+            {
+                if( item->ViewGetLOD( layer, &view ) >= view.GetScale() )
+                    continue;
+
+                PROF_TIMER paintTimer;
+                int        group = gal.BeginGroup();
+
+                if( !painter.Draw( item, layer ) )
+                    item->ViewDraw( layer, &view );
+
+                gal.EndGroup();
+                paintTimer.Stop();
+
+                PROF_TIMER rasterTimer;
+                gal.DrawGroup( group );
+                rasterTimer.Stop();
+
+                layerStats.m_items++;
+                layerStats.m_vertices += gal.GetGroupVertexCount( group );
+                layerStats.m_paintMs += paintTimer.msecs();
+                layerStats.m_rasterMs += rasterTimer.msecs();
+
+                gal.DeleteGroup( group );
+            }
+        }
+
+        LAYER_STATS total;
+
+        printf( "\nZoom level %ld (view scale %g, world scale %g)\n", step, view.GetScale(),
+                gal.GetWorldScale() );
+        printf( "  %-24s %10s %10s %10s %12s\n", "layer", "items", "vertices", "paint ms",
+                "raster ms" );
+
+        for( const auto& [ order, layerStats ] : stats )
+        {
+            if( !layerStats.m_items )
+                continue;
+
+            printf( "  %-24s %10zu %10zu %10.2f %12.2f\n",
+                    LayerName( layerStats.m_layer ).ToStdString().c_str(), layerStats.m_items,
+                    layerStats.m_vertices, layerStats.m_paintMs, layerStats.m_rasterMs );
+
+            total.m_items += layerStats.m_items;
+            total.m_vertices += layerStats.m_vertices;
+            total.m_paintMs += layerStats.m_paintMs;
+            total.m_rasterMs += layerStats.m_rasterMs;
+        }
+
+        printf( "  %-24s %10zu %10zu %10.2f %12.2f\n", "total", total.m_items, total.m_vertices,
+                total.m_paintMs, total.m_rasterMs );
+        printf( "  peak memory: %ld KiB\n", peakMemoryKiB() );
+    }
+
+    // The view must not outlive the board it refers to
+    view.Clear();
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "render",
+        "Render a board offscreen and report per-layer painter statistics",
+        render_benchmark_main_func,
+} );
+
+
+int main( int argc, char** argv )
+{
+    wxInitialize( argc, argv );
+    Pgm().InitPgm( true, true );
+
+    KI_TEST::COMBINED_UTILITY c_util;
+    int ret = c_util.HandleCommandLine( argc, argv );
+
+    Pgm().Destroy();
+    wxUninitialize();
+
+    return ret;
+}
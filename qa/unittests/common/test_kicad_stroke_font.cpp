@@ -82,4 +82,53 @@ BOOST_AUTO_TEST_CASE( TabCheck )
 }
 
 
+/**
+ * Glyphs are decoded on first use; check that fonts sharing the decoded table produce the same
+ * strokes, and that characters missing from the font still fall back to '?'.
+ */
+BOOST_AUTO_TEST_CASE( LazyGlyphDecoding )
+{
+    KIFONT::STROKE_FONT* font1 = KIFONT::STROKE_FONT::LoadFont( wxEmptyString );
+    KIFONT::STROKE_FONT* font2 = KIFONT::STROKE_FONT::LoadFont( wxEmptyString );
+
+    auto strokesFor =
+            []( const KIFONT::STROKE_FONT* aFont, const wxString& aText )
+            {
+                std::vector<std::unique_ptr<KIFONT::GLYPH>> glyphs;
+
+                aFont->GetTextAsGlyphs( nullptr, &glyphs, aText, VECTOR2I( 1000, 1000 ),
+                                        VECTOR2I( 0, 0 ), EDA_ANGLE::m_Angle0, false,
+                                        VECTOR2I( 0, 0 ), 0 );
+
+                std::vector<std::vector<VECTOR2D>> strokes;
+
+                for( const std::unique_ptr<KIFONT::GLYPH>& glyph : glyphs )
+                {
+                    for( const std::vector<VECTOR2D>& stroke :
+                                static_cast<const KIFONT::STROKE_GLYPH&>( *glyph ) )
+                    {
+                        strokes.push_back( stroke );
+                    }
+                }
+
+                return strokes;
+            };
+
+    wxString text = wxT( "R12 " );
+    text += wxUniChar( 0x03A9 );   // Greek capital omega
+
+    std::vector<std::vector<VECTOR2D>> first = strokesFor( font1, text );
+
+    BOOST_CHECK( !first.empty() );
+    BOOST_CHECK( first == strokesFor( font2, text ) );
+
+    // U+10FFFF is well past the end of the font
+    BOOST_CHECK( strokesFor( font1, wxString( wxUniChar( 0x10FFFF ) ) )
+                 == strokesFor( font2, wxT( "?" ) ) );
+
+    delete font1;
+    delete font2;
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <eeschema_test_utils.h>
+#include <sim/sim_lib_mgr.h>
+#include <reporter.h>
+
+#include <wx/filefn.h>
+
+
+class TEST_SIM_LIB_MGR_FIXTURE
+{
+public:
+    TEST_SIM_LIB_MGR_FIXTURE()
+    {
+        wxFileName source = KI_TEST::GetEeschemaTestDataDir();
+        source.AppendDir( "spice_netlists" );
+        source.AppendDir( "libraries" );
+        source.SetFullName( "diodes.lib.spice" );
+
+        // Work on a copy so that its modification time can be changed
+        m_path = wxFileName::CreateTempFileName( "test_sim_lib_mgr" );
+        wxRemoveFile( m_path );
+        m_path += ".lib.spice";
+
+        BOOST_REQUIRE( wxCopyFile( source.GetFullPath(), m_path ) );
+    }
+
+    ~TEST_SIM_LIB_MGR_FIXTURE()
+    {
+        wxRemoveFile( m_path );
+    }
+
+    /**
+     * Return the library \a aMgr read from the test library.
+     */
+    const SIM_LIBRARY* loadLibrary( SIM_LIB_MGR& aMgr )
+    {
+        aMgr.SetLibrary( m_path );
+
+        std::map<wxString, std::reference_wrapper<const SIM_LIBRARY>> libraries =
+                aMgr.GetLibraries();
+
+        BOOST_REQUIRE_EQUAL( libraries.size(), 1 );
+        return &libraries.begin()->second.get();
+    }
+
+    wxString           m_path;
+    wxString           m_messages;
+    WX_STRING_REPORTER m_reporter{ &m_messages };
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SimLibMgr, TEST_SIM_LIB_MGR_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( CacheHit )
+{
+    SIM_LIB_MGR first( nullptr, &m_reporter );
+    SIM_LIB_MGR second( nullptr, &m_reporter );
+
+    const SIM_LIBRARY* firstLibrary = loadLibrary( first );
+    const SIM_LIBRARY* secondLibrary = loadLibrary( second );
+
+    BOOST_CHECK( m_messages.IsEmpty() );
+
+    // An unchanged library is parsed once and shared
+    BOOST_CHECK_EQUAL( firstLibrary, secondLibrary );
+}
+
+
+BOOST_AUTO_TEST_CASE( StaleModificationTime )
+{
+    SIM_LIB_MGR first( nullptr, &m_reporter );
+    SIM_LIB_MGR second( nullptr, &m_reporter );
+
+    const SIM_LIBRARY* firstLibrary = loadLibrary( first );
+
+    wxFileName fn( m_path );
+    wxDateTime modified = fn.GetModificationTime() + wxTimeSpan::Hour();
+
+    BOOST_REQUIRE( fn.SetTimes( nullptr, &modified, nullptr ) );
+
+    // The first manager still holds on to its library, so a new parse can't reuse its address
+    const SIM_LIBRARY* secondLibrary = loadLibrary( second );
+
+    BOOST_CHECK( m_messages.IsEmpty() );
+    BOOST_CHECK_NE( firstLibrary, secondLibrary );
+    BOOST_CHECK_EQUAL( firstLibrary->GetModels().size(), secondLibrary->GetModels().size() );
+
+    // The fresh parse is cached in turn
+    SIM_LIB_MGR third( nullptr, &m_reporter );
+
+    BOOST_CHECK_EQUAL( loadLibrary( third ), secondLibrary );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,254 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the cache of embedded library symbols of SCH_SEXPR_PARSER
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include "eeschema_test_utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <lib_pin.h>
+#include <lib_symbol.h>
+#include <richio.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <schematic.h>
+#include <sch_plugins/kicad/sch_sexpr_parser.h>
+
+
+class TEST_SCH_EMBEDDED_SYMBOLS_FIXTURE
+{
+public:
+    TEST_SCH_EMBEDDED_SYMBOLS_FIXTURE() :
+            m_schematic( nullptr )
+    {
+    }
+
+    /**
+     * Parse \a aText into a new sheet, using \a aCache if not null.
+     */
+    std::unique_ptr<SCH_SHEET> parse( const std::string& aText, EMBEDDED_LIB_SYMBOL_CACHE* aCache )
+    {
+        std::unique_ptr<SCH_SHEET> sheet = std::make_unique<SCH_SHEET>( &m_schematic );
+        STRING_LINE_READER         reader( aText, wxT( "test" ) );
+        SCH_SEXPR_PARSER           parser( &reader );
+
+        sheet->SetScreen( new SCH_SCREEN( &m_schematic ) );
+        parser.SetEmbeddedSymbolCache( aCache );
+        parser.ParseSchematic( sheet.get() );
+
+        return sheet;
+    }
+
+    /**
+     * Parse \a aText, which must fail, and return the line number and byte index of the error.
+     */
+    std::pair<int, int> errorLocation( const std::string& aText,
+                                       EMBEDDED_LIB_SYMBOL_CACHE* aCache )
+    {
+        try
+        {
+            parse( aText, aCache );
+        }
+        catch( const PARSE_ERROR& e )
+        {
+            return { e.lineNumber, e.byteIndex };
+        }
+
+        BOOST_FAIL( "Expected a parse error" );
+        return { 0, 0 };
+    }
+
+    SCHEMATIC m_schematic;
+};
+
+
+static const std::string badSymbolSchematic =
+        "(kicad_sch (version 20221206) (generator eeschema)\n"
+        "  (uuid be526097-dcfd-4f9b-a181-67db2fe0ba1c)\n"
+        "  (paper \"A4\")\n"
+        "  (lib_symbols\n"
+        "    (symbol \"Test-Library:BAD\" (in_bom yes) (on_board yes)\n"
+        "      (property \"Reference\" \"U\" (at 0 1.27 0)\n"
+        "        (effects (font (size 1.27 1.27)))\n"
+        "      )\n"
+        "      (bogus \"(\")\n"
+        "    )\n"
+        "  )\n"
+        ")\n";
+
+
+/**
+ * Return a schematic in file format \a aVersion embedding a symbol with an overbarred pin name.
+ */
+static std::string overbarSchematic( const std::string& aVersion )
+{
+    return "(kicad_sch (version " + aVersion + ") (generator eeschema)\n"
+           "  (paper \"A4\")\n"
+           "  (lib_symbols\n"
+           "    (symbol \"Test-Library:OVERBAR\" (in_bom yes) (on_board yes)\n"
+           "      (property \"Reference\" \"U\" (at 0 1.27 0)\n"
+           "        (effects (font (size 1.27 1.27)))\n"
+           "      )\n"
+           "      (pin input line (at 0 0 0) (length 2.54)\n"
+           "        (name \"~RST~\" (effects (font (size 1.27 1.27))))\n"
+           "        (number \"1\" (effects (font (size 1.27 1.27))))\n"
+           "      )\n"
+           "    )\n"
+           "  )\n"
+           ")\n";
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( SchEmbeddedSymbols, TEST_SCH_EMBEDDED_SYMBOLS_FIXTURE )
+
+
+/**
+ * Sheets embedding the same symbol get equal but separate copies, and the symbol is only
+ * parsed once.
+ */
+BOOST_AUTO_TEST_CASE( RepeatedSymbols )
+{
+    wxFileName fn = KI_TEST::GetEeschemaTestDataDir();
+    fn.SetName( wxT( "issue10926_1_subsheet_1" ) );
+    fn.SetExt( wxT( "kicad_sch" ) );
+
+    std::ifstream     file( fn.GetFullPath().ToStdString() );
+    std::stringstream buffer;
+
+    BOOST_REQUIRE( file.is_open() );
+    buffer << file.rdbuf();
+
+    EMBEDDED_LIB_SYMBOL_CACHE  cache;
+    std::unique_ptr<SCH_SHEET> reference = parse( buffer.str(), nullptr );
+    std::unique_ptr<SCH_SHEET> first = parse( buffer.str(), &cache );
+    std::unique_ptr<SCH_SHEET> second = parse( buffer.str(), &cache );
+
+    const std::map<wxString, LIB_SYMBOL*>& refSymbols = reference->GetScreen()->GetLibSymbols();
+    const std::map<wxString, LIB_SYMBOL*>& firstSymbols = first->GetScreen()->GetLibSymbols();
+    const std::map<wxString, LIB_SYMBOL*>& secondSymbols = second->GetScreen()->GetLibSymbols();
+
+    BOOST_REQUIRE( !refSymbols.empty() );
+    BOOST_REQUIRE_EQUAL( cache.size(), 1 );
+    BOOST_CHECK_EQUAL( cache.begin()->second.size(), refSymbols.size() );
+    BOOST_REQUIRE_EQUAL( firstSymbols.size(), refSymbols.size() );
+    BOOST_REQUIRE_EQUAL( secondSymbols.size(), refSymbols.size() );
+
+    for( const auto& [ name, symbol ] : refSymbols )
+    {
+        BOOST_TEST_CONTEXT( "Symbol " << name )
+        {
+            BOOST_REQUIRE( firstSymbols.count( name ) );
+            BOOST_REQUIRE( secondSymbols.count( name ) );
+
+            BOOST_CHECK( firstSymbols.at( name ) != secondSymbols.at( name ) );
+            BOOST_CHECK_EQUAL( firstSymbols.at( name )->Compare( *symbol ), 0 );
+            BOOST_CHECK_EQUAL( secondSymbols.at( name )->Compare( *symbol ), 0 );
+        }
+    }
+
+    // The parser must carry on after the symbol exactly as without the cache
+    BOOST_CHECK_EQUAL( first->GetScreen()->Items().size(),
+                       reference->GetScreen()->Items().size() );
+}
+
+
+/**
+ * The same symbol text embedded in sheets of different file format versions is parsed according
+ * to the version of each sheet.
+ */
+BOOST_AUTO_TEST_CASE( MixedVersions )
+{
+    EMBEDDED_LIB_SYMBOL_CACHE cache;
+
+    for( const std::string& version : { "20221206", "20210406", "20221206", "20210406" } )
+    {
+        BOOST_TEST_CONTEXT( "Version " << version )
+        {
+            std::unique_ptr<SCH_SHEET> reference = parse( overbarSchematic( version ), nullptr );
+            std::unique_ptr<SCH_SHEET> cached = parse( overbarSchematic( version ), &cache );
+
+            const std::map<wxString, LIB_SYMBOL*>& refSymbols =
+                    reference->GetScreen()->GetLibSymbols();
+            const std::map<wxString, LIB_SYMBOL*>& cachedSymbols =
+                    cached->GetScreen()->GetLibSymbols();
+
+            BOOST_REQUIRE_EQUAL( refSymbols.size(), 1 );
+            BOOST_REQUIRE_EQUAL( cachedSymbols.size(), 1 );
+
+            std::vector<LIB_PIN*> refPins = refSymbols.begin()->second->GetAllLibPins();
+            std::vector<LIB_PIN*> cachedPins = cachedSymbols.begin()->second->GetAllLibPins();
+
+            BOOST_REQUIRE_EQUAL( refPins.size(), 1 );
+            BOOST_REQUIRE_EQUAL( cachedPins.size(), 1 );
+            BOOST_CHECK_EQUAL( cachedPins[0]->GetName(), refPins[0]->GetName() );
+        }
+    }
+
+    // Sanity check: the versions really parse differently
+    std::unique_ptr<SCH_SHEET> oldSheet = parse( overbarSchematic( "20210406" ), nullptr );
+    std::unique_ptr<SCH_SHEET> newSheet = parse( overbarSchematic( "20221206" ), nullptr );
+
+    BOOST_CHECK_NE( oldSheet->GetScreen()->GetLibSymbols().begin()->second
+                            ->GetAllLibPins()[0]->GetName(),
+                    newSheet->GetScreen()->GetLibSymbols().begin()->second
+                            ->GetAllLibPins()[0]->GetName() );
+
+    BOOST_CHECK_EQUAL( cache.size(), 2 );
+}
+
+
+/**
+ * Errors in an embedded symbol are reported at their place in the file.
+ */
+BOOST_AUTO_TEST_CASE( ErrorLocation )
+{
+    EMBEDDED_LIB_SYMBOL_CACHE cache;
+
+    std::pair<int, int> expected = errorLocation( badSymbolSchematic, nullptr );
+    std::pair<int, int> error = errorLocation( badSymbolSchematic, &cache );
+
+    BOOST_CHECK_EQUAL( expected.first, 9 );
+    BOOST_CHECK_EQUAL( error.first, expected.first );
+    BOOST_CHECK_EQUAL( error.second, expected.second );
+
+    // Same on a single line, where the symbol doesn't start at the beginning of the line
+    std::string singleLine = badSymbolSchematic;
+    std::replace( singleLine.begin(), singleLine.end(), '\n', ' ' );
+
+    expected = errorLocation( singleLine, nullptr );
+    error = errorLocation( singleLine, &cache );
+
+    BOOST_CHECK_EQUAL( expected.first, 1 );
+    BOOST_CHECK_EQUAL( error.first, expected.first );
+    BOOST_CHECK_EQUAL( error.second, expected.second );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,8 +21,11 @@
 #include <qa_utils/wx_utils/unit_test_utils.h>
 #include "eeschema_test_utils.h"
 
+#include <lib_symbol.h>
+#include <profile.h>
 #include <sch_reference_list.h>
 #include <sch_sheet_path.h> // SCH_MULTI_UNIT_REFERENCE_MAP
+#include <sch_symbol.h>
 
 
 struct REANNOTATED_REFERENCE
@@ -296,4 +299,75 @@ BOOST_AUTO_TEST_CASE( ReannotateDuplicates )
 }
 
 
+/**
+ * Annotating many new references with the same prefix must not rescan the numbers taken so far
+ * for every reference: twice the references should take about twice the time, not four times.
+ */
+BOOST_AUTO_TEST_CASE( AnnotationScaling )
+{
+    LIB_SYMBOL     resistor( wxT( "R" ) );
+    LIB_SYMBOL     opamp( wxT( "OPAMP" ) );
+    SCH_SHEET_PATH path;
+
+    opamp.SetUnitCount( 2 );
+
+    auto annotate =
+            [&]( int aCount ) -> double
+            {
+                std::vector<std::unique_ptr<SCH_SYMBOL>> symbols;
+                SCH_REFERENCE_LIST                       refs;
+
+                for( int i = 0; i < aCount; i++ )
+                {
+                    for( LIB_SYMBOL* libSymbol : { &resistor, &opamp } )
+                    {
+                        symbols.push_back( std::make_unique<SCH_SYMBOL>( *libSymbol,
+                                                                         libSymbol->GetLibId(),
+                                                                         &path, 1, 0,
+                                                                         VECTOR2I( i, 0 ) ) );
+                        symbols.back()->SetRef( &path, libSymbol == &opamp ? wxT( "U?" )
+                                                                           : wxT( "R?" ) );
+                        refs.AddItem( SCH_REFERENCE( symbols.back().get(), libSymbol, path ) );
+                    }
+                }
+
+                refs.SplitReferences();
+
+                PROF_TIMER timer;
+
+                refs.AnnotateByOptions( SORT_BY_X_POSITION, INCREMENTAL_BY_REF, 0, {},
+                                        SCH_REFERENCE_LIST(), false );
+
+                double elapsed = timer.msecs();
+
+                // Every reference got its own number, from 1 to aCount for each prefix
+                std::set<wxString> fullRefs;
+                long               maxNumber = 0;
+
+                for( unsigned i = 0; i < refs.GetCount(); i++ )
+                {
+                    long number = 0;
+
+                    BOOST_REQUIRE( refs[i].GetRefNumber().ToLong( &number ) );
+                    maxNumber = std::max( maxNumber, number );
+                    fullRefs.insert( refs[i].GetRef() + refs[i].GetRefNumber() );
+                }
+
+                BOOST_CHECK_EQUAL( fullRefs.size(), 2 * (size_t) aCount );
+                BOOST_CHECK_EQUAL( maxNumber, aCount );
+
+                return elapsed;
+            };
+
+    double small = annotate( 20000 );
+    double large = annotate( 40000 );
+
+    BOOST_TEST_MESSAGE( "Annotation took " << small << " ms for 20000, " << large
+                        << " ms for 40000 references per prefix" );
+
+    // Generous margin over linearithmic growth (plus some for timer noise)
+    BOOST_CHECK_LT( large, 3.0 * small + 100.0 );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,216 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+
+/**
+ * An R-tree exposing a check of its node structure.  Removal reinserts the branches of internal
+ * nodes through the data type, so it must be able to hold a pointer like the trees in KiCad do.
+ */
+class TEST_RTREE : public RTree<intptr_t, int, 2, double>
+{
+public:
+    /**
+     * Check that all leaves are on level 0, that levels go down by one from parent to child,
+     * that every node is filled within bounds and that every branch rect is exactly the cover
+     * of its child.
+     *
+     * @return the number of data entries found in the tree.
+     */
+    int CheckNodes() const
+    {
+        BOOST_REQUIRE( m_root );
+        BOOST_CHECK_GE( m_root->m_level, 0 );
+
+        return checkNode( m_root, true );
+    }
+
+private:
+    int checkNode( const Node* aNode, bool aIsRoot ) const
+    {
+        BOOST_CHECK_LE( aNode->m_count, (int) MAXNODES );
+
+        if( !aIsRoot )
+            BOOST_CHECK_GE( aNode->m_count, (int) MINNODES );
+
+        if( aNode->IsLeaf() )
+            return aNode->m_count;
+
+        int entries = 0;
+
+        for( int ii = 0; ii < aNode->m_count; ++ii )
+        {
+            const Branch& branch = aNode->m_branch[ii];
+            const Node*   child = branch.m_child;
+
+            BOOST_REQUIRE( child );
+            BOOST_CHECK_EQUAL( child->m_level, aNode->m_level - 1 );
+
+            Rect cover = NodeCover( const_cast<Node*>( child ) );
+
+            for( int axis = 0; axis < 2; ++axis )
+            {
+                BOOST_CHECK_EQUAL( branch.m_rect.m_min[axis], cover.m_min[axis] );
+                BOOST_CHECK_EQUAL( branch.m_rect.m_max[axis], cover.m_max[axis] );
+            }
+
+            entries += checkNode( child, false );
+        }
+
+        return entries;
+    }
+};
+
+
+/**
+ * Random entries, with ids numbered from zero.
+ */
+static std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> randomEntries( int aCount )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> pos( -100000, 100000 );
+    std::uniform_int_distribution<int> size( 0, 5000 );
+
+    std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> entries;
+
+    for( intptr_t id = 0; id < aCount; ++id )
+    {
+        TEST_RTREE::Rect rect;
+
+        rect.m_min[0] = pos( rng );
+        rect.m_min[1] = pos( rng );
+        rect.m_max[0] = rect.m_min[0] + size( rng );
+        rect.m_max[1] = rect.m_min[1] + size( rng );
+
+        entries.emplace_back( rect, id );
+    }
+
+    return entries;
+}
+
+
+static std::vector<intptr_t> search( const TEST_RTREE& aTree, const TEST_RTREE::Rect& aRect )
+{
+    std::vector<intptr_t> found;
+    auto                  visitor = [&]( const intptr_t& aId )
+                                    {
+                                        found.push_back( aId );
+                                        return true;
+                                    };
+
+    aTree.Search( aRect.m_min, aRect.m_max, visitor );
+
+    std::sort( found.begin(), found.end() );
+    return found;
+}
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+
+/**
+ * A bulk loaded tree is well formed and finds the same entries as one built by insertion.
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadMatchesInsert )
+{
+    // Empty, single entry, around the node capacity of 8, and several levels deep
+    for( int count : { 0, 1, 7, 8, 9, 11, 64, 65, 1000, 5000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " entries" )
+        {
+            std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> entries = randomEntries( count );
+
+            TEST_RTREE inserted;
+            TEST_RTREE bulk;
+
+            for( const auto& [rect, id] : entries )
+                inserted.Insert( rect.m_min, rect.m_max, id );
+
+            std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> bulkEntries = entries;
+            bulk.BulkLoad( bulkEntries );
+
+            BOOST_CHECK_EQUAL( bulk.CheckNodes(), count );
+            BOOST_CHECK_EQUAL( inserted.CheckNodes(), count );
+            BOOST_CHECK_EQUAL( bulk.Count(), inserted.Count() );
+
+            // Queries around every entry, plus a few random ones
+            std::vector<TEST_RTREE::Rect> queries;
+
+            for( const auto& [rect, id] : entries )
+                queries.push_back( rect );
+
+            for( const auto& [rect, id] : randomEntries( 50 ) )
+            {
+                TEST_RTREE::Rect query = rect;
+                query.m_max[0] += 20000;
+                query.m_max[1] += 20000;
+                queries.push_back( query );
+            }
+
+            for( const TEST_RTREE::Rect& query : queries )
+                BOOST_CHECK( search( bulk, query ) == search( inserted, query ) );
+
+            // The packed tree must stay usable by the incremental operations
+            for( const auto& [rect, id] : entries )
+                BOOST_CHECK( !bulk.Remove( rect.m_min, rect.m_max, id ) );
+
+            BOOST_CHECK_EQUAL( bulk.Count(), 0 );
+            BOOST_CHECK_EQUAL( bulk.CheckNodes(), 0 );
+        }
+    }
+}
+
+
+/**
+ * Bulk loading replaces whatever the tree held before.
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadReplaces )
+{
+    std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> entries = randomEntries( 100 );
+    TEST_RTREE                                    tree;
+
+    for( const auto& [rect, id] : entries )
+        tree.Insert( rect.m_min, rect.m_max, id + 1000 );
+
+    std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> single( entries.begin(), entries.begin() + 1 );
+    tree.BulkLoad( single );
+
+    BOOST_CHECK_EQUAL( tree.CheckNodes(), 1 );
+    BOOST_CHECK( search( tree, entries[0].first ) == std::vector<intptr_t>{ 0 } );
+
+    std::vector<std::pair<TEST_RTREE::Rect, intptr_t>> none;
+    tree.BulkLoad( none );
+
+    BOOST_CHECK_EQUAL( tree.CheckNodes(), 0 );
+    BOOST_CHECK_EQUAL( tree.Count(), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
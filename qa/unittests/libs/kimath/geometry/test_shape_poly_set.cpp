@@ -64,4 +64,47 @@ BOOST_AUTO_TEST_CASE( RemoveNullSegments )
 
 }
 
+
+BOOST_AUTO_TEST_CASE( TransformPointsKeepsTriangulation )
+{
+    SHAPE_POLY_SET base_set;
+
+    base_set.NewOutline();
+    base_set.Append( 0, 0 );
+    base_set.Append( 0, 100 );
+    base_set.Append( 100, 100 );
+    base_set.Append( 100, 0 );
+
+    base_set.CacheTriangulation( false );
+    BOOST_REQUIRE( base_set.IsTriangulationUpToDate() );
+
+    base_set.TransformPoints(
+            []( const VECTOR2I& aPt )
+            {
+                // Mirror, scale and offset
+                return VECTOR2I( -3 * aPt.x + 1000, 2 * aPt.y - 50 );
+            } );
+
+    BOOST_CHECK( base_set.IsTriangulationUpToDate() );
+    BOX2I bbox = base_set.BBox();
+    BOOST_CHECK_EQUAL( bbox.GetOrigin(), VECTOR2I( 700, -50 ) );
+    BOOST_CHECK_EQUAL( bbox.GetSize(), VECTOR2I( 300, 200 ) );
+
+    double triangleArea = 0.0;
+
+    for( unsigned ii = 0; ii < base_set.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tri = base_set.TriangulatedPolygon( ii );
+
+        for( size_t jj = 0; jj < tri->GetTriangleCount(); ++jj )
+        {
+            VECTOR2I a, b, c;
+            tri->GetTriangle( jj, a, b, c );
+            triangleArea += std::abs( ( b - a ).Cross( c - a ) ) / 2.0;
+        }
+    }
+
+    BOOST_CHECK_CLOSE( triangleArea, 300.0 * 200.0, 1e-6 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
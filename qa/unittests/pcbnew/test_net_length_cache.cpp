@@ -0,0 +1,163 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2023 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <qa_utils/wx_utils/unit_test_utils.h>
+#include <pcbnew_utils/board_test_utils.h>
+#include <board.h>
+#include <board_design_settings.h>
+#include <connectivity/connectivity_data.h>
+#include <connectivity/net_length_cache.h>
+#include <footprint.h>
+#include <pad.h>
+#include <pcb_track.h>
+#include <settings/settings_manager.h>
+
+
+struct NET_LENGTH_CACHE_TEST_FIXTURE
+{
+    NET_LENGTH_CACHE_TEST_FIXTURE() :
+            m_settingsManager( true /* headless */ )
+    { }
+
+    /**
+     * Check the cached totals of every net against the ones obtained by walking the board.
+     */
+    void checkAllNets()
+    {
+        std::shared_ptr<NET_LENGTH_CACHE> cache = m_board->GetConnectivity()->GetNetLengthCache();
+        const BOARD_STACKUP& stackup = m_board->GetDesignSettings().GetStackupDescriptor();
+
+        for( NETINFO_ITEM* net : m_board->GetNetInfo() )
+        {
+            NET_LENGTH_CACHE::NET_LENGTH cached;
+            long long trackLength = 0;
+            int       trackCount = 0;
+            int       viaCount = 0;
+            int       viaLength = 0;
+            int       padCount = 0;
+            long long padToDie = 0;
+
+            BOOST_REQUIRE( cache->GetNetLength( net->GetNetCode(), cached ) );
+
+            for( PCB_TRACK* track : m_board->Tracks() )
+            {
+                if( track->GetNetCode() != net->GetNetCode() )
+                    continue;
+
+                if( PCB_VIA* via = dyn_cast<PCB_VIA*>( track ) )
+                {
+                    viaCount++;
+                    viaLength += stackup.GetLayerDistance( via->TopLayer(), via->BottomLayer() );
+                }
+                else
+                {
+                    trackCount++;
+                    trackLength += KiROUND( track->GetLength() );
+                }
+            }
+
+            for( FOOTPRINT* footprint : m_board->Footprints() )
+            {
+                for( PAD* pad : footprint->Pads() )
+                {
+                    if( pad->GetNetCode() == net->GetNetCode() )
+                    {
+                        padCount++;
+                        padToDie += pad->GetPadToDieLength();
+                    }
+                }
+            }
+
+            BOOST_TEST_CONTEXT( "Net " << net->GetNetname() )
+            {
+                BOOST_CHECK_EQUAL( cached.trackCount, trackCount );
+                BOOST_CHECK_EQUAL( cached.trackLength, trackLength );
+                BOOST_CHECK_EQUAL( cached.viaCount, viaCount );
+                BOOST_CHECK_EQUAL( cached.ViaLength( stackup ), viaLength );
+                BOOST_CHECK_EQUAL( cached.padCount, padCount );
+                BOOST_CHECK_EQUAL( cached.padToDieLength, padToDie );
+            }
+        }
+    }
+
+    SETTINGS_MANAGER       m_settingsManager;
+    std::unique_ptr<BOARD> m_board;
+};
+
+
+BOOST_FIXTURE_TEST_CASE( NetLengthCacheUpdates, NET_LENGTH_CACHE_TEST_FIXTURE )
+{
+    KI_TEST::LoadBoard( m_settingsManager, "complex_hierarchy", m_board );
+
+    BOOST_REQUIRE( m_board->GetConnectivity()->GetNetLengthCache()->IsValid() );
+    BOOST_REQUIRE( !m_board->Tracks().empty() );
+
+    checkAllNets();
+
+    // Removing and re-adding items
+    PCB_TRACK* track = m_board->Tracks().front();
+
+    m_board->Remove( track );
+    checkAllNets();
+
+    m_board->Add( track );
+    checkAllNets();
+
+    // Changing an item
+    track->SetEnd( track->GetEnd() + VECTOR2I( 100000, 0 ) );
+    track->SetNetCode( m_board->Tracks().back()->GetNetCode() );
+    m_board->GetConnectivity()->Update( track );
+    checkAllNets();
+
+    // Changing the pads of a footprint
+    for( FOOTPRINT* footprint : m_board->Footprints() )
+    {
+        for( PAD* pad : footprint->Pads() )
+            pad->SetPadToDieLength( 1000 );
+
+        m_board->GetConnectivity()->Update( footprint );
+    }
+
+    checkAllNets();
+
+    // Adding a footprint again replaces its pads rather than counting them twice
+    std::shared_ptr<NET_LENGTH_CACHE> cache = m_board->GetConnectivity()->GetNetLengthCache();
+    FOOTPRINT*                        footprint = m_board->Footprints().front();
+
+    cache->Add( footprint );
+    cache->Add( footprint );
+    checkAllNets();
+
+    cache->Remove( footprint );
+    cache->Add( footprint );
+    checkAllNets();
+
+    // Many small changes to the same track don't accumulate rounding errors
+    for( int i = 0; i < 1000; i++ )
+    {
+        track->SetEnd( track->GetEnd() + VECTOR2I( 3, 7 ) );
+        m_board->GetConnectivity()->Update( track );
+    }
+
+    checkAllNets();
+}
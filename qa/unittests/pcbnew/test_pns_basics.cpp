@@ -27,9 +27,13 @@
 #include <pcbnew/pad.h>
 #include <pcbnew/pcb_track.h>
 
+#include <router/pns_batch_router.h>
+#include <router/pns_line.h>
 #include <router/pns_node.h>
+#include <router/pns_optimizer.h>
 #include <router/pns_router.h>
 #include <router/pns_item.h>
+#include <router/pns_segment.h>
 #include <router/pns_via.h>
 #include <router/pns_kicad_iface.h>
 
@@ -393,3 +397,272 @@ BOOST_FIXTURE_TEST_CASE( PNSHoleCollisions, PNS_TEST_FIXTURE )
     }
 }
 
+
+BOOST_AUTO_TEST_CASE( PNSBranchJoints )
+{
+    const int      net = 1;
+    const VECTOR2I p0( 0, 0 ), p1( 1000000, 0 ), p2( 0, 1000000 );
+
+    std::unique_ptr<PNS::NODE> world( new PNS::NODE );
+
+    std::unique_ptr<PNS::SEGMENT> s1( new PNS::SEGMENT( SEG( p0, p1 ), net ) );
+    PNS::SEGMENT*                 seg1 = s1.get();
+
+    seg1->SetLayer( F_Cu );
+    world->Add( std::move( s1 ) );
+
+    PNS::NODE* branch = world->Branch();
+
+    std::unique_ptr<PNS::SEGMENT> s2( new PNS::SEGMENT( SEG( p0, p2 ), net ) );
+    s2->SetLayer( F_Cu );
+
+    branch->Remove( seg1 );
+    branch->Add( std::move( s2 ) );
+
+    BOOST_CHECK( branch->Overrides( seg1 ) );
+    BOOST_CHECK( !world->Overrides( seg1 ) );
+
+    // The branch changes its own copies of the shared joints, the root keeps the originals
+    BOOST_CHECK_EQUAL( world->FindJoint( p1, F_Cu, net )->LinkCount(), 1 );
+    BOOST_CHECK_EQUAL( branch->FindJoint( p1, F_Cu, net )->LinkCount(), 0 );
+    BOOST_CHECK_EQUAL( world->FindJoint( p0, F_Cu, net )->LinkCount(), 1 );
+    BOOST_CHECK_EQUAL( branch->FindJoint( p0, F_Cu, net )->LinkCount(), 1 );
+
+    BOOST_CHECK( world->FindJoint( p2, F_Cu, net ) == nullptr );
+    BOOST_CHECK( branch->FindJoint( p2, F_Cu, net ) != nullptr );
+
+    // A branch of a branch sees the state of its parent at the time of branching only
+    PNS::NODE* subBranch = branch->Branch();
+
+    branch->LockJoint( p2, seg1, true );
+
+    BOOST_CHECK( subBranch->Overrides( seg1 ) );
+    BOOST_CHECK( subBranch->FindJoint( p2, F_Cu, net ) != nullptr );
+    BOOST_CHECK( !subBranch->FindJoint( p2, F_Cu, net )->IsLocked() );
+    BOOST_CHECK( branch->FindJoint( p2, F_Cu, net )->IsLocked() );
+
+    world->KillChildren();
+}
+
+
+BOOST_FIXTURE_TEST_CASE( PNSBatchedCollisions, PNS_TEST_FIXTURE )
+{
+    std::unique_ptr<PNS::NODE> world( new PNS::NODE );
+
+    world->SetMaxClearance( 10000000 );
+    world->SetRuleResolver( &m_ruleResolver );
+    m_ruleResolver.m_defaultClearance = 200000;
+
+    // A grid of short vertical segments on two layers
+    for( int x = 0; x < 10; x++ )
+    {
+        for( int y = 0; y < 10; y++ )
+        {
+            VECTOR2I p( x * 1000000, y * 1000000 );
+
+            std::unique_ptr<PNS::SEGMENT> seg(
+                    new PNS::SEGMENT( SEG( p, p + VECTOR2I( 0, 300000 ) ), 1 ) );
+            seg->SetWidth( 100000 );
+            seg->SetLayer( ( x + y ) % 2 ? F_Cu : B_Cu );
+            world->Add( std::move( seg ) );
+        }
+    }
+
+    // A head crossing part of the grid, with a long diagonal and a via spanning both layers
+    PNS::SEGMENT s1( SEG( VECTOR2I( -500000, 150000 ), VECTOR2I( 2500000, 150000 ) ), 2 );
+    PNS::SEGMENT s2( SEG( VECTOR2I( 2500000, 150000 ), VECTOR2I( 8500000, 6150000 ) ), 2 );
+    PNS::SEGMENT s3( SEG( VECTOR2I( 8500000, 6150000 ), VECTOR2I( 8500000, 8000000 ) ), 2 );
+    PNS::VIA     via( VECTOR2I( 8500000, 8000000 ), LAYER_RANGE( F_Cu, B_Cu ), 600000, 300000, 2 );
+
+    for( PNS::SEGMENT* s : { &s1, &s2, &s3 } )
+    {
+        s->SetWidth( 100000 );
+        s->SetLayer( F_Cu );
+    }
+
+    std::vector<const PNS::ITEM*> items = { &s1, &s2, &s3, &via };
+    PNS::NODE::OBSTACLES          single, batched;
+
+    for( const PNS::ITEM* item : items )
+        world->QueryColliding( item, single );
+
+    world->QueryColliding( items, batched );
+
+    BOOST_CHECK( !single.empty() );
+    BOOST_CHECK_EQUAL( batched.size(), single.size() );
+    BOOST_CHECK( batched == single );
+
+    PNS::COLLISION_SEARCH_OPTIONS opts;
+    PNS::NODE::OBSTACLES          limited;
+
+    // Each segment collision yields a single obstacle (the via would add its hole's as well)
+    opts.m_limitCount = 1;
+    world->QueryColliding( { &s1, &s2, &s3 }, limited, opts );
+
+    BOOST_CHECK_EQUAL( limited.size(), 1 );
+}
+
+
+/**
+ * Build a world of detouring lines, optimize them either one after the other or as a batch and
+ * return the resulting shapes.
+ */
+static std::vector<SHAPE_LINE_CHAIN> optimizeDetours( PNS::RULE_RESOLVER* aResolver,
+                                                      const std::vector<SHAPE_LINE_CHAIN>& aShapes,
+                                                      bool aBatch )
+{
+    std::unique_ptr<PNS::NODE> world( new PNS::NODE );
+    std::vector<PNS::LINE>     lines( aShapes.size() );
+
+    world->SetMaxClearance( 400000 );
+    world->SetRuleResolver( aResolver );
+
+    for( size_t i = 0; i < aShapes.size(); i++ )
+    {
+        lines[i].SetShape( aShapes[i] );
+        lines[i].SetWidth( 100000 );
+        lines[i].SetLayer( F_Cu );
+        lines[i].SetNet( (int) i + 1 );
+        world->Add( lines[i] );
+    }
+
+    PNS::OPTIMIZER optimizer( world.get() );
+
+    if( aBatch )
+    {
+        std::vector<PNS::LINE*> toOptimize;
+
+        for( PNS::LINE& line : lines )
+            toOptimize.push_back( &line );
+
+        optimizer.OptimizeBatch( toOptimize, {},
+                [&]( size_t aIndex, PNS::LINE& aOptimized )
+                {
+                    world->Replace( lines[aIndex], aOptimized );
+                    lines[aIndex] = aOptimized;
+                } );
+    }
+    else
+    {
+        for( PNS::LINE& line : lines )
+        {
+            PNS::LINE optimized;
+
+            if( optimizer.Optimize( &line, &optimized ) )
+            {
+                world->Replace( line, optimized );
+                line = optimized;
+            }
+        }
+    }
+
+    std::vector<SHAPE_LINE_CHAIN> result;
+
+    for( const PNS::LINE& line : lines )
+        result.push_back( line.CLine() );
+
+    world->KillChildren();
+
+    return result;
+}
+
+
+static SHAPE_LINE_CHAIN detour( std::initializer_list<VECTOR2I> aPoints )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( const VECTOR2I& p : aPoints )
+        chain.Append( p );
+
+    return chain;
+}
+
+
+BOOST_FIXTURE_TEST_CASE( PNSOptimizeBatch, PNS_TEST_FIXTURE )
+{
+    const int mm = 1000000;
+
+    m_ruleResolver.m_defaultClearance = 200000;
+
+    std::vector<std::vector<SHAPE_LINE_CHAIN>> cases;
+
+    // Disjoint: detours far apart from each other, optimized concurrently
+    std::vector<SHAPE_LINE_CHAIN> disjoint;
+
+    for( int i = 0; i < 8; i++ )
+    {
+        VECTOR2I o( i * 30 * mm, 0 );
+
+        disjoint.push_back( detour( { o, o + VECTOR2I( 0, 5 * mm ), o + VECTOR2I( 10 * mm, 5 * mm ),
+                                      o + VECTOR2I( 10 * mm, 0 ) } ) );
+    }
+
+    cases.push_back( disjoint );
+
+    // Overlapping: the second line can only be straightened once the first one has been, and
+    // the third one sits right above the first one
+    cases.push_back( {
+            detour( { VECTOR2I( 0, 0 ), VECTOR2I( 0, 5 * mm ), VECTOR2I( 10 * mm, 5 * mm ),
+                      VECTOR2I( 10 * mm, 0 ) } ),
+            detour( { VECTOR2I( -3 * mm, 2500000 ), VECTOR2I( -3 * mm, -3 * mm ),
+                      VECTOR2I( 13 * mm, -3 * mm ), VECTOR2I( 13 * mm, 2500000 ) } ),
+            detour( { VECTOR2I( 2 * mm, 6 * mm ), VECTOR2I( 2 * mm, 9 * mm ),
+                      VECTOR2I( 8 * mm, 9 * mm ), VECTOR2I( 8 * mm, 6 * mm ) } ) } );
+
+    for( size_t c = 0; c < cases.size(); c++ )
+    {
+        BOOST_TEST_CONTEXT( "Case " << c )
+        {
+            std::vector<SHAPE_LINE_CHAIN> serial = optimizeDetours( &m_ruleResolver, cases[c],
+                                                                    false );
+            std::vector<SHAPE_LINE_CHAIN> batch = optimizeDetours( &m_ruleResolver, cases[c],
+                                                                   true );
+
+            BOOST_REQUIRE_EQUAL( batch.size(), serial.size() );
+
+            for( size_t i = 0; i < serial.size(); i++ )
+            {
+                BOOST_TEST_CONTEXT( "Line " << i )
+                {
+                    BOOST_CHECK( serial[i].CompareGeometry( batch[i] ) );
+
+                    // Every line gets straightened, given the others were optimized first
+                    BOOST_CHECK_EQUAL( serial[i].PointCount(), 2 );
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( PNSBatchRouterRegions )
+{
+    using CONNECTION = PNS::BATCH_ROUTER::CONNECTION;
+
+    auto conn =
+            []( const VECTOR2I& aStart, const VECTOR2I& aEnd )
+            {
+                return CONNECTION{ nullptr, nullptr, aStart, aEnd, 1, F_Cu };
+            };
+
+    BOOST_CHECK( PNS::BATCH_ROUTER::FindRegions( {}, 0 ).empty() );
+
+    // The third connection links the first and the fourth ones, which don't overlap each other
+    std::vector<CONNECTION> chained = { conn( { 0, 0 }, { 10, 10 } ),
+                                        conn( { 100, 100 }, { 110, 110 } ),
+                                        conn( { 5, 5 }, { 20, 0 } ),
+                                        conn( { 18, 2 }, { 40, 40 } ) };
+
+    std::vector<std::vector<int>> expected = { { 0, 2, 3 }, { 1 } };
+
+    BOOST_CHECK( PNS::BATCH_ROUTER::FindRegions( chained, 0 ) == expected );
+
+    // Connections merge once the margin makes them overlap
+    std::vector<CONNECTION> apart = { conn( { 0, 0 }, { 10, 0 } ), conn( { 30, 0 }, { 40, 0 } ) };
+
+    expected = { { 0 }, { 1 } };
+    BOOST_CHECK( PNS::BATCH_ROUTER::FindRegions( apart, 5 ) == expected );
+
+    expected = { { 0, 1 } };
+    BOOST_CHECK( PNS::BATCH_ROUTER::FindRegions( apart, 15 ) == expected );
+}